@@ -0,0 +1,47 @@
+#include "Objects/Cone.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Objects {
+
+    Cone::Cone(const glm::vec3& apex_, const glm::vec3& axis_, const float half_angle_, const float height_,
+               const RGB& color_, const int specular_, const float reflectivity_)
+        : Quadric(color_, specular_, reflectivity_), apex(apex_), axis(glm::normalize(axis_)), half_angle(half_angle_), height(height_) {
+        if (!(half_angle > 0.0f && half_angle < 1.5707963f) || !(height > 0.0f)) {
+            throw std::invalid_argument("Cone: half angle must be in (0, pi/2) and height positive");
+        }
+        update_form();
+    }
+
+    // A = I - (1 + k^2) a a^T for k = tan(half_angle); the apex plane has no cap
+    void Cone::update_form() {
+        const float k {std::tan(half_angle)};
+        const glm::vec3 s {axis * (1.0f + k * k)};
+        const glm::mat3 A {glm::mat3(1.0f) - glm::mat3(s * axis.x, s * axis.y, s * axis.z)};
+        set_form(apex, A, glm::vec3(0.0f), 0.0f, {-axis, 0.0f, false}, {axis, -height, true});
+    }
+
+    float Cone::get_base_radius() const {
+        return height * std::tan(half_angle);
+    }
+
+    void Cone::set_axis(const glm::vec3& axis_) {
+        axis = glm::normalize(axis_);
+        update_form();
+    }
+
+    // Same disc extent as Cylinder::bounds
+    AABB Cone::bounds() const {
+        const float r {get_base_radius()};
+        const glm::vec3 disc {r * glm::vec3(std::sqrt(std::max(0.0f, 1.0f - axis.x * axis.x)),
+                                            std::sqrt(std::max(0.0f, 1.0f - axis.y * axis.y)),
+                                            std::sqrt(std::max(0.0f, 1.0f - axis.z * axis.z)))};
+        const glm::vec3 base {apex + axis * height};
+        AABB box;
+        box.expand(apex);
+        box.expand(base - disc);
+        box.expand(base + disc);
+        return box;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef RAYTRACINGCPP_SRC_OBJECTS_CONE_HPP
+#define RAYTRACINGCPP_SRC_OBJECTS_CONE_HPP
+#include <glm/glm.hpp>
+#include "Quadric.hpp"
+
+namespace Objects {
+
+    /**
+     * @brief Cone with its tip at apex, opening along axis, cut off and capped at height.
+     *
+     * The quadric |p|^2 - (1 + tan^2(half_angle)) (a.p)^2 about the apex,
+     * clipped to 0 <= a.p <= height.
+     */
+    class Cone : public Quadric {
+        glm::vec3 apex;
+        glm::vec3 axis;     // Unit, from the apex towards the base
+        float half_angle;   // Radians, in (0, pi/2)
+        float height;
+
+        void update_form();
+
+    public:
+        /// @throws std::invalid_argument unless 0 < half_angle < pi/2 and height > 0
+        Cone(const glm::vec3& apex_, const glm::vec3& axis_, float half_angle_, float height_,
+             const RGB& color_ = RGB(255, 0, 0), int specular_ = 500, float reflectivity_ = 0.0f);
+
+        // Getters
+        glm::vec3 get_apex() const { return apex; }
+        glm::vec3 get_axis() const { return axis; }
+        float get_half_angle() const { return half_angle; }
+        float get_height() const { return height; }
+        float get_base_radius() const;
+
+        // Setters
+        void set_axis(const glm::vec3& axis_);
+
+        // Apex plus the base disc
+        AABB bounds() const override;
+        std::size_t memory_bytes() const override { return sizeof(Cone); }
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_OBJECTS_CONE_HPP
@@ -4,13 +4,17 @@
 
 #ifndef RAYTRACINGCPP_CYLINDER_H
 #define RAYTRACINGCPP_CYLINDER_H
-#include "IRenderable.hpp"
+#include "Quadric.hpp"
 
 namespace Objects {
-    class Cylinder : public IRenderable {
+    /// Capped cylinder: the quadric |p|^2 - (a.p)^2 = r^2 about its midpoint, clipped and capped at both ends.
+    class Cylinder : public Quadric {
         glm::vec3 base_center;
         float radius;
         float height;
+        glm::vec3 axis; // Unit axis from the base cap towards the top cap
+
+        void update_form();
 
     public:
         explicit Cylinder(const glm::vec3 &base_center_, float radius_, float height_);
@@ -20,11 +24,14 @@ namespace Objects {
         glm::vec3 get_base_center() const;
         float get_radius() const;
         float get_height() const;
+        glm::vec3 get_axis() const;
 
-        std::vector<float> intersect(const Ray& ray) const override;
+        // Setters
+        void set_axis(const glm::vec3& axis_);
 
-        // Compute surface normal at point P
-        glm::vec3 normal_at(const glm::vec3& P) const override;
+        // Tight world-space bounds
+        AABB bounds() const override;
+        std::size_t memory_bytes() const override { return sizeof(Cylinder); }
     };
 } // Objects
 
@@ -0,0 +1,16 @@
+#include "Objects/Ellipsoid.hpp"
+#include <stdexcept>
+
+namespace Objects {
+
+    Ellipsoid::Ellipsoid(const glm::vec3& center_, const glm::vec3& radii_, const RGB& color_, const int specular_, const float reflectivity_)
+        : Quadric(color_, specular_, reflectivity_), center(center_), radii(radii_) {
+        if (!(radii.x > 0.0f && radii.y > 0.0f && radii.z > 0.0f)) {
+            throw std::invalid_argument("Ellipsoid: radii must be positive");
+        }
+        // A = diag(1 / r^2), j = -1
+        const glm::vec3 inverse_squared {1.0f / (radii.x * radii.x), 1.0f / (radii.y * radii.y), 1.0f / (radii.z * radii.z)};
+        set_form(center, glm::mat3(glm::vec3(inverse_squared.x, 0, 0), glm::vec3(0, inverse_squared.y, 0), glm::vec3(0, 0, inverse_squared.z)),
+                 glm::vec3(0.0f), -1.0f, {}, {});
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef RAYTRACINGCPP_SRC_OBJECTS_ELLIPSOID_HPP
+#define RAYTRACINGCPP_SRC_OBJECTS_ELLIPSOID_HPP
+#include <glm/glm.hpp>
+#include "Quadric.hpp"
+
+namespace Objects {
+
+    /// Axis-aligned ellipsoid (x/rx)^2 + (y/ry)^2 + (z/rz)^2 = 1 about center; instances rotate it.
+    class Ellipsoid : public Quadric {
+        glm::vec3 center;
+        glm::vec3 radii;
+
+    public:
+        /// @throws std::invalid_argument unless every radius is positive
+        Ellipsoid(const glm::vec3& center_, const glm::vec3& radii_,
+                  const RGB& color_ = RGB(255, 0, 0), int specular_ = 500, float reflectivity_ = 0.0f);
+
+        // Getters
+        glm::vec3 get_center() const { return center; }
+        glm::vec3 get_radii() const { return radii; }
+
+        AABB bounds() const override { return {center - radii, center + radii}; }
+        std::size_t memory_bytes() const override { return sizeof(Ellipsoid); }
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_OBJECTS_ELLIPSOID_HPP
@@ -1,19 +1,71 @@
 #include "IRenderable.hpp"
 
 namespace Objects {
-    // Constructor
-    IRenderable::IRenderable(const RGB& color_, const int specular_, const float reflectivity_, const glm::vec3& axis_)
-        : color(color_), specular(specular_), reflectivity(reflectivity_), axis(glm::normalize(axis_)) {}
+    // Constructors
+    IRenderable::IRenderable(const RGB& color_, const int specular_, const float reflectivity_)
+        : material_id(MaterialTable::instance().intern({color_, specular_, reflectivity_})) {}
+
+    IRenderable::IRenderable(const MaterialId material_id_)
+        : material_id(material_id_) {
+        MaterialTable::instance().acquire(material_id);
+    }
+
+    IRenderable::IRenderable(const IRenderable& other)
+        : IRenderable(other.material_id) {}
+
+    IRenderable& IRenderable::operator=(const IRenderable& other) {
+        set_material_id(other.material_id);
+        return *this;
+    }
+
+    IRenderable::~IRenderable() {
+        MaterialTable::instance().release(material_id);
+    }
 
     // Getters
-    RGB IRenderable::get_color() const { return color; }
-    int IRenderable::get_specular() const { return specular; }
-    float IRenderable::get_reflectivity() const { return reflectivity; }
-    glm::vec3 IRenderable::get_axis() const { return axis; }
+    MaterialId IRenderable::get_material_id() const { return material_id; }
+    RGB IRenderable::get_color() const { return get_material().color; }
+    int IRenderable::get_specular() const { return get_material().specular; }
+    float IRenderable::get_reflectivity() const { return get_material().reflectivity; }
+    float IRenderable::get_glossiness() const { return get_material().glossiness; }
 
     // Setters
-    void IRenderable::set_color(const RGB& color_) { color = color_; }
-    void IRenderable::set_specular(const int specular_) { specular = specular_; }
-    void IRenderable::set_reflectivity(const float reflectivity_) { reflectivity = reflectivity_; }
-    void IRenderable::set_axis(const glm::vec3& axis_) { axis = glm::normalize(axis_); }
-}
\ No newline at end of file
+    void IRenderable::set_material_id(const MaterialId material_id_) {
+        MaterialTable::instance().acquire(material_id_);
+        MaterialTable::instance().release(material_id);
+        material_id = material_id_;
+    }
+
+    void IRenderable::set_material(const Material& material) {
+        const MaterialId interned {MaterialTable::instance().intern(material)};
+        MaterialTable::instance().release(material_id);
+        material_id = interned;
+    }
+
+    void IRenderable::set_color(const RGB& color_) {
+        Material material {get_material()};
+        material.color = color_;
+        set_material(material);
+    }
+
+    void IRenderable::set_specular(const int specular_) {
+        Material material {get_material()};
+        material.specular = specular_;
+        set_material(material);
+    }
+
+    void IRenderable::set_reflectivity(const float reflectivity_) {
+        Material material {get_material()};
+        material.reflectivity = reflectivity_;
+        set_material(material);
+    }
+
+    void IRenderable::set_glossiness(const float glossiness_) {
+        Material material {get_material()};
+        material.glossiness = glossiness_;
+        set_material(material);
+    }
+
+    // Bounds
+    AABB IRenderable::bounds() const { return AABB::infinite(); }
+}
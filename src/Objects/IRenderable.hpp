@@ -1,35 +1,42 @@
 #ifndef RAYTRACINGCPP_SRC_OBJECTS_RENDERABLE_HPP
 #define RAYTRACINGCPP_SRC_OBJECTS_RENDERABLE_HPP
 #include <glm/glm.hpp>
+#include <cstddef>
 #include <vector>
 #include "Utilities/RGB.hpp"
 #include "Utilities/Ray.hpp"
+#include "Utilities/AABB.hpp"
+#include "Objects/Material.hpp"
 
 namespace Objects {
     class IRenderable {
     protected:
-        RGB color;
-        int specular;
-        float reflectivity; // 0 = non-reflective, 1 = perfect mirror
-        glm::vec3 axis; // Axis for rotation
-    
+        MaterialId material_id; // Index into MaterialTable::instance(), holding one reference
+
     public:
-        // Constructor
-        explicit IRenderable(const RGB& color_ = RGB(255,0,0), int specular_=500, float reflectivity_=0.0f, const glm::vec3& axis_={1,1,1});
+        // Constructors
+        explicit IRenderable(const RGB& color_ = RGB(255,0,0), int specular_=500, float reflectivity_=0.0f);
+        explicit IRenderable(MaterialId material_id_);
+        IRenderable(const IRenderable& other);
+        IRenderable& operator=(const IRenderable& other);
 
-        virtual ~IRenderable() = default;
+        virtual ~IRenderable();
 
         // Getters
+        MaterialId get_material_id() const;
+        const Material& get_material() const { return MaterialTable::instance().get(material_id); }
         RGB get_color() const;
         int get_specular() const;
         float get_reflectivity() const;
-        glm::vec3 get_axis() const;
+        float get_glossiness() const;
 
-        // Setters
+        // Setters (the changed material is interned, other primitives sharing the old one are unaffected)
+        void set_material_id(MaterialId material_id_);
+        void set_material(const Material& material);
         void set_color(const RGB& color_);
         void set_specular(int specular_);
         void set_reflectivity(float reflectivity_);
-        void set_axis(const glm::vec3& axis_);
+        void set_glossiness(float glossiness_);
 
         // Compute intersection with a ray: O + t*D
         // Returns a list of t values (min t first), or empty vector if no intersection
@@ -37,6 +44,12 @@ namespace Objects {
 
         // Compute surface normal at point P
         virtual glm::vec3 normal_at(const glm::vec3& P) const = 0;
+
+        // World-space bounds (infinite for unbounded primitives such as planes)
+        virtual AABB bounds() const;
+
+        // Bytes held by this primitive itself (for memory accounting; shared data is not included)
+        virtual std::size_t memory_bytes() const = 0;
     };
 }
-#endif // RAYTRACINGCPP_SRC_OBJECTS_RENDERABLE_HPP
\ No newline at end of file
+#endif // RAYTRACINGCPP_SRC_OBJECTS_RENDERABLE_HPP
@@ -0,0 +1,59 @@
+#include "Instance.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace Objects {
+
+    Instance::Instance(std::shared_ptr<const IRenderable> prototype_, const glm::mat3& linear, const glm::vec3& translation)
+        : Instance(prototype_, linear, translation, prototype_ ? prototype_->get_material_id() : throw std::invalid_argument("Instance: prototype must not be null")) {}
+
+    Instance::Instance(std::shared_ptr<const IRenderable> prototype_, const glm::mat3& linear, const glm::vec3& translation, const MaterialId material_id_)
+        : IRenderable(material_id_), prototype(std::move(prototype_)) {
+        if (!prototype) {
+            throw std::invalid_argument("Instance: prototype must not be null");
+        }
+        const float det {glm::determinant(linear)};
+        if (!std::isfinite(det) || std::abs(det) < 1e-12f) {
+            throw std::invalid_argument("Instance: transform is singular");
+        }
+        world_to_object = glm::inverse(linear);
+        world_to_object_offset = -(world_to_object * translation);
+    }
+
+    glm::mat3 Instance::get_linear() const { return glm::inverse(world_to_object); }
+    glm::vec3 Instance::get_translation() const { return -(get_linear() * world_to_object_offset); }
+
+    std::vector<float> Instance::intersect(const Ray& ray) const {
+        // Ray normalizes the object-space direction, so object-space distances
+        // are |D_object| times the world-space ones.
+        const glm::vec3 O {world_to_object * ray.get_origin() + world_to_object_offset};
+        const glm::vec3 D {world_to_object * ray.get_direction()};
+        const float scale {glm::length(D)};
+
+        std::vector<float> ts {prototype->intersect(Ray(O, D))};
+        for (float& t : ts) t /= scale;
+        return ts;
+    }
+
+    glm::vec3 Instance::normal_at(const glm::vec3& P) const {
+        // Normals transform with the inverse transpose of object-to-world,
+        // which is the transpose of the world-to-object part already stored.
+        const glm::vec3 N_object {prototype->normal_at(world_to_object * P + world_to_object_offset)};
+        return glm::normalize(glm::transpose(world_to_object) * N_object);
+    }
+
+    AABB Instance::bounds() const {
+        const AABB local {prototype->bounds()};
+        if (local.is_empty()) return local;
+        if (!local.is_finite()) return AABB::infinite();
+
+        // Centre maps through the full transform; the half extent through |linear|
+        const glm::mat3 linear {get_linear()};
+        const glm::vec3 center {linear * local.center() + get_translation()};
+        const glm::vec3 half {local.extent() * 0.5f};
+        const glm::vec3 world_half {glm::abs(linear[0]) * half.x + glm::abs(linear[1]) * half.y + glm::abs(linear[2]) * half.z};
+        return {center - world_half, center + world_half};
+    }
+}
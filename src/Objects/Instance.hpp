@@ -0,0 +1,48 @@
+#ifndef RAYTRACINGCPP_SRC_OBJECTS_INSTANCE_HPP
+#define RAYTRACINGCPP_SRC_OBJECTS_INSTANCE_HPP
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "IRenderable.hpp"
+#include "Utilities/Ray.hpp"
+
+namespace Objects {
+
+    /**
+     * @brief A placed copy of shared prototype geometry.
+     *
+     * Holds the prototype by reference plus the world-to-object affine map
+     * (3x3 linear part and offset), so each copy costs about 80 bytes however
+     * large the prototype is. Rays are carried into object space for the
+     * prototype's intersect() and hit distances scaled back; normals return
+     * through the transpose of the same linear part.
+     *
+     * The material is the prototype's at construction time unless overridden.
+     */
+    class Instance : public IRenderable {
+        glm::mat3 world_to_object;          // Inverse of the object-to-world linear part
+        glm::vec3 world_to_object_offset;   // -world_to_object * translation
+        std::shared_ptr<const IRenderable> prototype;
+
+    public:
+        /// Place prototype at P_world = linear * P_object + translation. @throws std::invalid_argument if linear is singular
+        Instance(std::shared_ptr<const IRenderable> prototype_, const glm::mat3& linear, const glm::vec3& translation);
+        Instance(std::shared_ptr<const IRenderable> prototype_, const glm::mat3& linear, const glm::vec3& translation, MaterialId material_id_);
+
+        // Getters
+        const std::shared_ptr<const IRenderable>& get_prototype() const { return prototype; }
+        glm::mat3 get_linear() const;
+        glm::vec3 get_translation() const;
+
+        std::vector<float> intersect(const Ray& ray) const override;
+        glm::vec3 normal_at(const glm::vec3& P) const override;
+
+        // Prototype bounds carried to world space (infinite if the prototype is unbounded)
+        AABB bounds() const override;
+
+        // The prototype is shared, so it is not included (Scene counts each prototype once)
+        std::size_t memory_bytes() const override { return sizeof(Instance); }
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_OBJECTS_INSTANCE_HPP
@@ -7,7 +7,7 @@
 namespace Objects {
     class Light {
     public:
-        enum class Type { Ambient, Point, Directional };
+        enum class Type { Ambient, Point, Directional, Area };
 
         Light(Type type_, float intensity_)
             : type(type_)
@@ -58,5 +58,34 @@ namespace Objects {
     private:
         glm::vec3 direction;
     };
+
+    /**
+     * @brief Parallelogram light: corner + u * edge_u + v * edge_v for u, v in [0, 1].
+     *
+     * Emits from both faces. Renderers sample points on it with shadow rays,
+     * which gives soft shadows; without a sampler it acts like a shadowed
+     * point light at its center.
+     */
+    class AreaLight : public Light {
+    public:
+        AreaLight(float intensity_, const glm::vec3& corner_, const glm::vec3& edge_u_, const glm::vec3& edge_v_)
+            : Light(Type::Area, intensity_), corner(corner_), edge_u(edge_u_), edge_v(edge_v_)
+        {
+            if (glm::length(glm::cross(edge_u, edge_v)) <= 0.f)
+                throw std::invalid_argument("Area light edges must span a parallelogram.");
+        }
+
+        glm::vec3 get_corner() const { return corner; }
+        glm::vec3 get_edge_u() const { return edge_u; }
+        glm::vec3 get_edge_v() const { return edge_v; }
+        glm::vec3 get_center() const { return point_at(0.5f, 0.5f); }
+
+        glm::vec3 point_at(float u, float v) const { return corner + edge_u * u + edge_v * v; }
+
+    private:
+        glm::vec3 corner;
+        glm::vec3 edge_u;
+        glm::vec3 edge_v;
+    };
 }
 #endif // RAYTRACINGCPP_SRC_OBJECTS_LIGHT_HPP
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "Material.hpp"
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include "Utilities/MemoryAccounting.hpp"
+
+namespace Objects {
+
+    bool Material::operator==(const Material& other) const {
+        return color.r == other.color.r && color.g == other.color.g && color.b == other.color.b
+            && specular == other.specular
+            && std::bit_cast<std::uint32_t>(reflectivity) == std::bit_cast<std::uint32_t>(other.reflectivity)
+            && std::bit_cast<std::uint32_t>(glossiness) == std::bit_cast<std::uint32_t>(other.glossiness);
+    }
+
+    std::size_t MaterialTable::KeyHash::operator()(const Material& m) const {
+        std::size_t h {std::hash<int>{}(m.color.r)};
+        for (const std::size_t v : {std::hash<int>{}(m.color.g), std::hash<int>{}(m.color.b), std::hash<int>{}(m.specular),
+                                    std::hash<std::uint32_t>{}(std::bit_cast<std::uint32_t>(m.reflectivity)),
+                                    std::hash<std::uint32_t>{}(std::bit_cast<std::uint32_t>(m.glossiness))}) {
+            h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+
+    MaterialTable& MaterialTable::instance() {
+        static MaterialTable table;
+        return table;
+    }
+
+    namespace {
+        // Hash node: key, value and next pointer, plus one bucket pointer and the reference count
+        constexpr std::size_t ENTRY_BYTES {sizeof(Material) + sizeof(MaterialId) + 2 * sizeof(void*) + sizeof(std::uint32_t)};
+    }
+
+    MaterialId MaterialTable::intern(const Material& material) {
+        std::lock_guard lock(mutex);
+        if (const auto it {index.find(material)}; it != index.end()) {
+            ++references[it->second];
+            return it->second;
+        }
+
+        MaterialId id;
+        if (!free_ids.empty()) {
+            id = free_ids.back();
+            free_ids.pop_back();
+        } else {
+            if (slots >= CAPACITY) throw std::length_error("Material table is full (" + std::to_string(CAPACITY) + " distinct materials)");
+            id = static_cast<MaterialId>(slots);
+            const std::size_t chunk {id / CHUNK_SIZE};
+            if (!storage[chunk]) {
+                storage[chunk] = std::make_unique<Material[]>(CHUNK_SIZE);
+                chunks[chunk].store(storage[chunk].get(), std::memory_order_release);
+                Memory::Accounting::instance().add(Memory::Subsystem::Materials, CHUNK_SIZE * sizeof(Material));
+            }
+            references.push_back(0);
+            ++slots;
+        }
+        // Nobody holds a freed id, so its slot can be rewritten under lock-free readers of other ids
+        storage[id / CHUNK_SIZE][id % CHUNK_SIZE] = material;
+        references[id] = 1;
+        index.emplace(material, id);
+        Memory::Accounting::instance().add(Memory::Subsystem::Materials, ENTRY_BYTES);
+        live.fetch_add(1, std::memory_order_release);
+        return id;
+    }
+
+    void MaterialTable::acquire(const MaterialId id) {
+        std::lock_guard lock(mutex);
+        ++references[id];
+    }
+
+    void MaterialTable::release(const MaterialId id) {
+        std::lock_guard lock(mutex);
+        if (--references[id] > 0) return;
+
+        index.erase(storage[id / CHUNK_SIZE][id % CHUNK_SIZE]);
+        free_ids.push_back(id);
+        Memory::Accounting::instance().release(Memory::Subsystem::Materials, ENTRY_BYTES);
+        live.fetch_sub(1, std::memory_order_release);
+    }
+}
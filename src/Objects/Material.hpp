@@ -0,0 +1,78 @@
+#ifndef RAYTRACINGCPP_SRC_OBJECTS_MATERIAL_HPP
+#define RAYTRACINGCPP_SRC_OBJECTS_MATERIAL_HPP
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Utilities/RGB.hpp"
+
+namespace Objects {
+
+    /// Surface appearance shared by any number of primitives.
+    struct Material {
+        RGB color {255, 0, 0};
+        int specular {500};
+        float reflectivity {0.0f};  // 0 = non-reflective, 1 = perfect mirror
+        float glossiness {0.0f};    // Spread of reflections: 0 = sharp mirror, 1 = widest glossy lobe
+
+        bool operator==(const Material& other) const;
+    };
+
+    using MaterialId = std::uint32_t;
+
+    /**
+     * @brief Process-wide, deduplicated, reference-counted table of materials.
+     *
+     * Primitives keep only a 32-bit id into it, so a million copies of the
+     * same surface share one entry. Each primitive holds a reference to its
+     * entry; when the last one goes (e.g. with a scene evicted from a cache)
+     * the entry is reclaimed and its id reused. Lookups are lock-free (entries
+     * never move once added); interning and reference changes take a lock.
+     */
+    class MaterialTable {
+    public:
+        static constexpr std::size_t CAPACITY {std::size_t{1} << 24};
+
+        static MaterialTable& instance();
+
+        /// Id of an equal material, adding it first if needed, with one reference for the caller. Throws std::length_error when full.
+        MaterialId intern(const Material& material);
+
+        /// Another reference to a live entry.
+        void acquire(MaterialId id);
+
+        /// Drop a reference; the entry is reclaimed with its last one.
+        void release(MaterialId id);
+
+        const Material& get(const MaterialId id) const {
+            return chunks[id / CHUNK_SIZE].load(std::memory_order_acquire)[id % CHUNK_SIZE];
+        }
+
+        /// Live (referenced) entries.
+        std::size_t size() const { return live.load(std::memory_order_acquire); }
+
+    private:
+        static constexpr std::size_t CHUNK_SIZE {4096};
+
+        struct KeyHash {
+            std::size_t operator()(const Material& m) const;
+        };
+
+        MaterialTable() = default;
+
+        std::array<std::atomic<Material*>, CAPACITY / CHUNK_SIZE> chunks {};
+        std::array<std::unique_ptr<Material[]>, CAPACITY / CHUNK_SIZE> storage;
+        std::size_t slots {0};                      // ids handed out so far, live or free
+        std::atomic<std::size_t> live {0};
+        std::vector<std::uint32_t> references;      // per id
+        std::vector<MaterialId> free_ids;
+        std::unordered_map<Material, MaterialId, KeyHash> index;
+        std::mutex mutex;
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_OBJECTS_MATERIAL_HPP
@@ -7,10 +7,10 @@
 namespace Objects {
 
     Plane::Plane()
-        : IRenderable(RGB(0, 0, 255), 0, 0, glm::normalize(glm::vec3(0, 1, 0))), point(glm::vec3(0, 0, 1)), normal(axis) {}
+        : IRenderable(RGB(0, 0, 255), 0, 0), point(glm::vec3(0, 0, 1)), normal(glm::vec3(0, 1, 0)) {}
 
     Plane::Plane(const RGB& color_, const int specular_, const float reflectivity_, const glm::vec3& axis_, const glm::vec3& point_)
-        : IRenderable(color_, specular_, reflectivity_, axis_), point(point_), normal(glm::normalize(axis_)) {}
+        : IRenderable(color_, specular_, reflectivity_), point(point_), normal(glm::normalize(axis_)) {}
 
     glm::vec3 Plane::get_point() const {
         return point;
@@ -25,7 +25,7 @@ namespace Objects {
 
         if (std::abs(denom) < 1e-6) return {};
 
-        const float t {glm::dot(point - ray.get_direction(), normal) / denom};
+        const float t {glm::dot(point - ray.get_origin(), normal) / denom};
 
         if (t < 0) return {};
 
@@ -23,6 +23,8 @@ namespace Objects {
 
         // Compute surface normal at point P
         glm::vec3 normal_at(const glm::vec3& P) const override;
+
+        std::size_t memory_bytes() const override { return sizeof(Plane); }
     };
 } // Objects
 
@@ -0,0 +1,102 @@
+#include "Objects/Quadric.hpp"
+#include <cmath>
+#include <limits>
+
+namespace Objects {
+
+    using Field = Kernels::QuadricSoA::Field;
+
+    Quadric::Quadric(const glm::vec3& origin, const glm::mat3& A, const glm::vec3& g, const float j,
+                     const ClipPlane& clip0, const ClipPlane& clip1,
+                     const RGB& color_, const int specular_, const float reflectivity_)
+        : IRenderable(color_, specular_, reflectivity_) {
+        set_form(origin, A, g, j, clip0, clip1);
+    }
+
+    Quadric::Quadric(const RGB& color_, const int specular_, const float reflectivity_)
+        : IRenderable(color_, specular_, reflectivity_) {}
+
+    void Quadric::set_form(const glm::vec3& origin, const glm::mat3& A, const glm::vec3& g, const float j,
+                           const ClipPlane& clip0, const ClipPlane& clip1) {
+        // glm is column-major: A[column][row]
+        fields = {
+            origin.x, origin.y, origin.z,
+            A[0][0], A[1][1], A[2][2],
+            0.5f * (A[1][0] + A[0][1]), 0.5f * (A[2][0] + A[0][2]), 0.5f * (A[2][1] + A[1][2]),
+            g.x, g.y, g.z, j,
+            clip0.normal.x, clip0.normal.y, clip0.normal.z, clip0.offset, clip0.cap ? 1.0f : 0.0f,
+            clip1.normal.x, clip1.normal.y, clip1.normal.z, clip1.offset, clip1.cap ? 1.0f : 0.0f,
+        };
+    }
+
+    // Getters
+    glm::vec3 Quadric::get_origin() const {
+        return {fields[Field::ORIGIN_X], fields[Field::ORIGIN_Y], fields[Field::ORIGIN_Z]};
+    }
+
+    glm::mat3 Quadric::get_matrix() const {
+        return {
+            glm::vec3(fields[Field::A], fields[Field::D], fields[Field::E]),
+            glm::vec3(fields[Field::D], fields[Field::B], fields[Field::F]),
+            glm::vec3(fields[Field::E], fields[Field::F], fields[Field::C])
+        };
+    }
+
+    glm::vec3 Quadric::get_linear() const {
+        return {fields[Field::G], fields[Field::H], fields[Field::I]};
+    }
+
+    float Quadric::get_constant() const {
+        return fields[Field::J];
+    }
+
+    ClipPlane Quadric::get_clip(const int index) const {
+        const std::size_t first {index == 0 ? Field::CLIP0_X : Field::CLIP1_X};
+        return {glm::vec3(fields[first], fields[first + 1], fields[first + 2]), fields[first + 3], fields[first + 4] != 0.0f};
+    }
+
+    float Quadric::evaluate(const glm::vec3& P) const {
+        const glm::vec3 p {P - get_origin()};
+        return glm::dot(p, get_matrix() * p + 2.0f * get_linear()) + get_constant();
+    }
+
+    std::vector<float> Quadric::intersect(const Ray& ray) const {
+        // One-element view of this quadric; each call returns the next hit beyond the last
+        Kernels::QuadricSoA view {};
+        for (std::size_t k {0}; k < fields.size(); ++k) view.field[k] = &fields[k];
+        view.count = 1;
+
+        const glm::vec3 O {ray.get_origin()};
+        const glm::vec3 D {ray.get_direction()};
+        const float origin[3] {O.x, O.y, O.z};
+        const float direction[3] {D.x, D.y, D.z};
+        const Kernels::KernelTable& kernels {Kernels::active()};
+
+        std::vector<float> ts;
+        float t {0.0f};
+        while (ts.size() < 4 && kernels.nearest_quadric(origin, direction, t, std::numeric_limits<float>::infinity(), view, t) >= 0) {
+            ts.push_back(t);
+        }
+        return ts;
+    }
+
+    glm::vec3 Quadric::normal_at(const glm::vec3& P) const {
+        const glm::vec3 p {P - get_origin()};
+        const glm::vec3 half_gradient {get_matrix() * p + get_linear()};
+        const float length {glm::length(half_gradient)};
+
+        // Hit points carry rounding error, so pick whichever surface P is
+        // nearest to; |Q| / |grad Q| estimates the distance to the side.
+        float nearest {length > 0.0f ? std::abs(evaluate(P)) / (2.0f * length) : std::numeric_limits<float>::infinity()};
+        glm::vec3 normal {length > 0.0f ? half_gradient / length : get_clip(0).normal};
+        for (int k {0}; k < 2; ++k) {
+            const ClipPlane clip {get_clip(k)};
+            if (!clip.cap) continue;
+            if (const float distance {std::abs(glm::dot(clip.normal, p) + clip.offset)}; distance < nearest) {
+                nearest = distance;
+                normal = clip.normal;
+            }
+        }
+        return normal;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef RAYTRACINGCPP_SRC_OBJECTS_QUADRIC_HPP
+#define RAYTRACINGCPP_SRC_OBJECTS_QUADRIC_HPP
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+#include "IRenderable.hpp"
+#include "Utilities/Kernels.hpp"
+#include "Utilities/Ray.hpp"
+
+namespace Objects {
+
+    /// Half-space n.p + offset <= 0 (p relative to a Quadric's origin) that a clip plane keeps.
+    struct ClipPlane {
+        glm::vec3 normal {0.0f};    // Unit, pointing out of the kept side
+        float offset {-1.0f};       // The default plane keeps everything
+        bool cap {false};           // Close the cut with a flat cap
+    };
+
+    /**
+     * @brief Surface Q(p) = 0 of a quadratic form, optionally clipped by two planes.
+     *
+     * With p = x - origin, Q(p) = p.A.p + 2 g.p + j, i.e. [p 1] M [p 1]^T for
+     * the symmetric 4x4 M = [A g; g^T j]. The ten distinct entries of M are
+     * precomputed in the packed layout of Kernels::QuadricSoA, so ellipsoids,
+     * cylinders and cones all intersect through the same batched kernel: one
+     * quadratic in t plus two plane tests. Q < 0 is the inside. Working
+     * relative to origin keeps precision for objects far from the world origin.
+     *
+     * Spheres keep their own four-float kernel, the cheapest case of the same
+     * arithmetic.
+     */
+    class Quadric : public IRenderable {
+    public:
+        using Fields = std::array<float, Kernels::QuadricSoA::FIELD_COUNT>;
+
+        /// Q(p) = p.A.p + 2 g.p + j; A is symmetrised. Unbounded unless a subclass says otherwise.
+        Quadric(const glm::vec3& origin, const glm::mat3& A, const glm::vec3& g, float j,
+                const ClipPlane& clip0 = {}, const ClipPlane& clip1 = {},
+                const RGB& color_ = RGB(255, 0, 0), int specular_ = 500, float reflectivity_ = 0.0f);
+
+        // Getters
+        glm::vec3 get_origin() const;
+        glm::mat3 get_matrix() const;
+        glm::vec3 get_linear() const;
+        float get_constant() const;
+        ClipPlane get_clip(int index) const;
+        const Fields& get_fields() const { return fields; }
+
+        /// Q at world point P: negative inside, zero on the surface.
+        float evaluate(const glm::vec3& P) const;
+
+        // Hits through Kernels::nearest_quadric, so they match the batched path bit for bit
+        std::vector<float> intersect(const Ray& ray) const override;
+
+        // Gradient of Q, or the normal of a cap when P is nearer to it
+        glm::vec3 normal_at(const glm::vec3& P) const override;
+
+        std::size_t memory_bytes() const override { return sizeof(Quadric); }
+
+    protected:
+        Quadric(const RGB& color_, int specular_, float reflectivity_);
+
+        void set_form(const glm::vec3& origin, const glm::mat3& A, const glm::vec3& g, float j, const ClipPlane& clip0, const ClipPlane& clip1);
+
+    private:
+        Fields fields {};
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_OBJECTS_QUADRIC_HPP
@@ -4,7 +4,7 @@ namespace Objects {
     // Constructors
     // ------------------------
     Sphere::Sphere(const RGB& color_, const int specular_, const float reflectivity_, const glm::vec3& center_, const float radius_)
-        : IRenderable(color_, specular_, reflectivity_, glm::vec3(0, 1,0)), center(center_), radius(radius_), color_(color_) {}
+        : IRenderable(color_, specular_, reflectivity_), center(center_), radius(radius_) {}
 
     // ------------------------
     // Getters
@@ -27,16 +27,19 @@ namespace Objects {
         // Vector from ray origin to sphere center
         const glm::vec3 OC = ray.get_origin() - center;
 
-        // Quadratic coefficients (a=1 since ray direction is normalized)
-        const float b = 2.0f * glm::dot(OC, ray.get_direction());
-        const float c = glm::dot(OC, OC) - radius * radius;
+        // Half-b form of the quadratic (a=1 since ray direction is normalized)
+        const float half_b = glm::dot(OC, ray.get_direction());
 
-        const float discriminant = b * b - 4.0f * c;
+        // r^2 minus the squared distance from the centre to the line. Equal to
+        // half_b^2 - (|OC|^2 - r^2) but without cancelling two large terms
+        // when the origin is far away.
+        const glm::vec3 to_line = OC - half_b * ray.get_direction();
+        const float discriminant = radius * radius - glm::dot(to_line, to_line);
         if (discriminant < 0) return {};  // No intersection
 
         const float sqrt_disc = std::sqrt(discriminant);
-        float t1 = (-b - sqrt_disc) / 2.0f;
-        float t2 = (-b + sqrt_disc) / 2.0f;
+        float t1 = -half_b - sqrt_disc;
+        float t2 = -half_b + sqrt_disc;
 
         // Only return positive intersections (in front of the ray)
         std::vector<float> result;
@@ -50,4 +53,9 @@ namespace Objects {
     glm::vec3 Sphere::normal_at(const glm::vec3& P) const {
         return glm::normalize(P - this->center);
     }
+
+    // Bounding box of the sphere
+    AABB Sphere::bounds() const {
+        return {center - glm::vec3(radius), center + glm::vec3(radius)};
+    }
 }
\ No newline at end of file
@@ -10,7 +10,6 @@ namespace Objects {
     class Sphere : public IRenderable {
         glm::vec3 center;
         float radius;
-        const RGB &color_;
 
     public:
         // Constructor
@@ -32,6 +31,8 @@ namespace Objects {
         // Override methods from Renderable
         std::vector<float> intersect(const Ray& ray) const override;
         glm::vec3 normal_at(const glm::vec3& P) const override;
+        AABB bounds() const override;
+        std::size_t memory_bytes() const override { return sizeof(Sphere); }
     };
 }
 
@@ -4,6 +4,7 @@
 
 #include "Torus.hpp"
 #include "Utilities/Math.hpp"
+#include "Utilities/Kernels.hpp"
 #include <algorithm>
 #include <Eigen/Dense>
 #include <complex>
@@ -15,67 +16,66 @@ namespace Objects {
     using vec3 = glm::vec3;
 
     Torus::Torus()
-        : IRenderable(), center({0, 0, 10}), major_radius(2.0f), minor_radius(0.5f) {}
+        : IRenderable(), center({0, 0, 10}), major_radius(2.0f), minor_radius(0.5f), axis(glm::normalize(glm::vec3(1, 1, 1))) { update_basis(); }
 
     Torus::Torus(const glm::vec3 &center_, const float &major_radius_, const float &minor_radius_)
-        : IRenderable(), center(center_), major_radius(major_radius_), minor_radius(minor_radius_) {}
+        : IRenderable(), center(center_), major_radius(major_radius_), minor_radius(minor_radius_), axis(glm::normalize(glm::vec3(1, 1, 1))) { update_basis(); }
 
     Torus::Torus(const glm::vec3 &center_, const float &major_radius_, const float &minor_radius_, const RGB &color_, const int &specular_, const float &reflectivity_, const glm::vec3 &axis_)
-            : IRenderable(color_, specular_, reflectivity_, axis_), center(center_), major_radius(major_radius_), minor_radius(minor_radius_) {
+            : IRenderable(color_, specular_, reflectivity_), center(center_), major_radius(major_radius_), minor_radius(minor_radius_), axis(glm::normalize(axis_)) {
+        update_basis();
     }
 
-    std::vector<float> Torus::solve_quartic(const float /*A*/, const float B, const float C, const float D, const float E) {
-
-        const auto b {static_cast<double>(B)};
-        const auto c {static_cast<double>(C)};
-        const auto d {static_cast<double>(D)};
-        const auto e {static_cast<double>(E)};
+    glm::vec3 Torus::get_axis() const { return axis; }
+    void Torus::set_axis(const glm::vec3& axis_) {
+        axis = glm::normalize(axis_);
+        update_basis();
+    }
 
-        std::vector<double> rD;
-        Math::solve_quartic_monic(b,c,d,e,rD);
+    std::vector<float> Torus::solve_quartic(const double A, const double B, const double C, const double D, const double E) {
+        // Dispatched copy of Math::solve_quartic_monic (fixed storage, ISA-specific build)
+        double rD[4];
+        const int count {Kernels::active().solve_quartic_monic(B / A, C / A, D / A, E / A, rD)};
 
         std::vector<float> out;
-        out.reserve(rD.size());
-        for (const double& t : rD) out.push_back(static_cast<float>(t));
+        out.reserve(count);
+        for (int i {0}; i < count; ++i) out.push_back(static_cast<float>(rD[i]));
         return out;
     }
 
-    // Build a right-handed orthonormal basis (u, v, w), where w = normalized axis.
-    inline void make_orthonormal_basis(const glm::vec3& axis_in, glm::vec3& u, glm::vec3& v, glm::vec3& w) {
-        w = axis_in;
-        const glm::vec3 pick {(std::abs(axis_in.x) < 0.9f) ? glm::vec3(1,0,0) : glm::vec3(0,1,0)};
-        u = glm::normalize(glm::cross(pick, w));
-        v = glm::cross(w, u);                    // already unit if u,w are unit & ⟂
+    // Build a right-handed orthonormal basis (u, v, axis) once per axis change
+    // rather than on every intersect/normal_at call.
+    void Torus::update_basis() {
+        const glm::vec3 pick {(std::abs(axis.x) < 0.9f) ? glm::vec3(1,0,0) : glm::vec3(0,1,0)};
+        basis_u = glm::normalize(glm::cross(pick, axis));
+        basis_v = glm::cross(axis, basis_u);     // already unit if u,w are unit & ⟂
     }
 
 std::vector<float> Torus::intersect(const Ray& ray) const {
-        // Build Orthonormal basis
-        glm::vec3 u, v, w;
-        make_orthonormal_basis(axis, u, v, w);
+        const glm::vec3& u {basis_u};
+        const glm::vec3& v {basis_v};
+        const glm::vec3& w {axis};
 
-        // Transform Ray into local torus coordinates
-        auto O_rel {ray.get_origin() - center};
-        auto O_local {vec3(glm::dot(O_rel, u), glm::dot(O_rel, v), glm::dot(O_rel, w))};
-        auto D_local {vec3(glm::dot(ray.get_direction(), u), glm::dot(ray.get_direction(), v), glm::dot(ray.get_direction(), w))};
+        // Transform Ray into local torus coordinates. The coefficients are built
+        // in double: they mix terms of order |O|^4 whose float rounding is
+        // enough to lose the two close roots of a ray grazing the tube.
+        const glm::vec3 O_rel {ray.get_origin() - center};
+        const double ox {glm::dot(O_rel, u)}, oy {glm::dot(O_rel, v)}, oz {glm::dot(O_rel, w)};
+        const double dx {glm::dot(ray.get_direction(), u)}, dy {glm::dot(ray.get_direction(), v)}, dz {glm::dot(ray.get_direction(), w)};
 
         // Quartic Coefficients
-        auto dx {D_local.x};
-        auto dy {D_local.y};
-        auto dz {D_local.z};
-
-        auto ox {O_local.x};
-        auto oy {O_local.y};
-        auto oz {O_local.z};
+        const double R2 {static_cast<double>(major_radius) * major_radius};
+        const double r2 {static_cast<double>(minor_radius) * minor_radius};
 
-        auto sum_d_sq {dx*dx + dy*dy + dz*dz};
-        auto e {ox*ox + oy*oy + oz*oz - major_radius*major_radius - minor_radius*minor_radius};
-        auto f {ox*dx + oy*dy + oz*dz};
+        const double sum_d_sq {dx*dx + dy*dy + dz*dz};
+        const double e {ox*ox + oy*oy + oz*oz - R2 - r2};
+        const double f {ox*dx + oy*dy + oz*dz};
 
-        auto A {sum_d_sq * sum_d_sq};
-        auto B {4.0f * f * sum_d_sq};
-        auto C {2.0f * sum_d_sq * e + 4.0f * f * f + 4.0f * major_radius*major_radius * dz*dz};
-        auto D {4.0f  * f * e + 8 * major_radius * major_radius * oz * dz};
-        auto E {e*e - 4.0f * major_radius * major_radius * (minor_radius*minor_radius - oz*oz)};
+        const double A {sum_d_sq * sum_d_sq};
+        const double B {4.0 * f * sum_d_sq};
+        const double C {2.0 * sum_d_sq * e + 4.0 * f * f + 4.0 * R2 * dz*dz};
+        const double D {4.0 * f * e + 8.0 * R2 * oz * dz};
+        const double E {e*e - 4.0 * R2 * (r2 - oz*oz)};
 
         auto roots {solve_quartic(A, B, C, D, E)};
         std::ranges::sort(roots);
@@ -85,8 +85,9 @@ std::vector<float> Torus::intersect(const Ray& ray) const {
     glm::vec3 Torus::normal_at(const glm::vec3& P) const {
         const glm::vec3 P_rel {P - center};
 
-        glm::vec3 u, v, w;
-        make_orthonormal_basis(axis, u, v, w);
+        const glm::vec3& u {basis_u};
+        const glm::vec3& v {basis_v};
+        const glm::vec3& w {axis};
 
         const float x {glm::dot(P_rel, u)};
         const float y {glm::dot(P_rel, v)};
@@ -101,4 +102,14 @@ std::vector<float> Torus::intersect(const Ray& ray) const {
         const glm::vec3 N_world {glm::normalize(u * N_local.x + v * N_local.y + w * N_local.z)};
         return N_world;
     }
+
+    // The tube centre circle (radius R, normal = axis) spans R * sqrt(1 - a_i^2)
+    // along world axis i; the tube adds r in every direction.
+    AABB Torus::bounds() const {
+        const glm::vec3 ring {major_radius * glm::vec3(std::sqrt(std::max(0.0f, 1.0f - axis.x * axis.x)),
+                                                       std::sqrt(std::max(0.0f, 1.0f - axis.y * axis.y)),
+                                                       std::sqrt(std::max(0.0f, 1.0f - axis.z * axis.z)))};
+        const glm::vec3 half {ring + glm::vec3(minor_radius)};
+        return {center - half, center + half};
+    }
 } // Objects
\ No newline at end of file
@@ -14,19 +14,29 @@ namespace Objects {
     class Torus : public IRenderable {
         glm::vec3 center;
         float major_radius, minor_radius;
-        glm::vec3 axis_unit_;
-        glm::vec3 u_, v_, w_;     // basis
-        glm::mat3 world_to_local_; // rows or columns consistent with your use
-        float R2_, r2_, fourR2_, eightR2_;
+        glm::vec3 axis; // Unit normal of the ring plane
+        glm::vec3 basis_u, basis_v; // Completes (u, v, axis) to a right-handed frame; rebuilt with the axis
+
+        void update_basis();
 
     public:
         Torus();
         Torus(const glm::vec3 &center_, const float &major_radius_, const float &minor_radius_);
         Torus(const glm::vec3 &center_, const float &major_radius_, const float &minor_radius_, const RGB &color_, const int &specular_, const float &reflectivity_, const glm::vec3 &axis_);
 
-        static std::vector<float> solve_quartic(float A, float B, float C, float D, float E);
+        // Getters
+        glm::vec3 get_axis() const;
+
+        // Setters
+        void set_axis(const glm::vec3& axis_);
+
+        static std::vector<float> solve_quartic(double A, double B, double C, double D, double E);
         std::vector<float> intersect(const Ray& ray) const override;
         glm::vec3 normal_at(const glm::vec3& P) const override;
+
+        // Tight world-space bounds
+        AABB bounds() const override;
+        std::size_t memory_bytes() const override { return sizeof(Torus); }
     };
 } // Objects
 
@@ -0,0 +1,463 @@
+#include "RayTracing/Bvh.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace RayTracing {
+
+    using namespace glm;
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr std::uint32_t LEAF_BIT {0x80000000u};      // child reference to a sorted primitive, not an interior node
+        constexpr std::uint32_t UNBOUNDED_CODE {0xFFFFFFFFu}; // sorts after every 30-bit Morton code
+        constexpr std::size_t MIN_CHUNK {1 << 14};
+
+        double lap_ms(Clock::time_point& start) {
+            const Clock::time_point now {Clock::now()};
+            const double ms {std::chrono::duration<double, std::milli>(now - start).count()};
+            start = now;
+            return ms;
+        }
+
+        // body(chunk, begin, end) over the ranges for_each_chunk would use
+        template <typename Body>
+        void run_chunks(ThreadPool* pool, const std::size_t chunks, const std::size_t count, const Body& body) {
+            if (chunks == 1) {
+                body(std::size_t {0}, std::size_t {0}, count);
+                return;
+            }
+            pool->parallel_for(chunks, [&](const std::size_t c) { body(c, c * count / chunks, (c + 1) * count / chunks); });
+        }
+
+        // Spread the low 10 bits of v to every third bit
+        std::uint32_t expand_bits(std::uint32_t v) {
+            v = (v * 0x00010001u) & 0xFF0000FFu;
+            v = (v * 0x00000101u) & 0x0F00F00Fu;
+            v = (v * 0x00000011u) & 0xC30C30C3u;
+            v = (v * 0x00000005u) & 0x49249249u;
+            return v;
+        }
+
+        std::uint32_t morton_code(const vec3& unit) {
+            const auto quantise = [](const float x) { return static_cast<std::uint32_t>(std::clamp(x * 1024.0f, 0.0f, 1023.0f)); };
+            return expand_bits(quantise(unit.x)) << 2 | expand_bits(quantise(unit.y)) << 1 | expand_bits(quantise(unit.z));
+        }
+
+        AABB merged(const AABB& a, const AABB& b) {
+            AABB box {a};
+            box.expand(b);
+            return box;
+        }
+
+        float half_area(const AABB& box) {
+            const vec3 e {box.extent()};
+            return e.x * e.y + e.y * e.z + e.z * e.x;
+        }
+
+        // Stable LSD radix sort of (code << 32 | index) keys on their code, 8 bits per pass
+        void radix_sort(std::vector<std::uint64_t>& keys, ThreadPool* pool) {
+            const std::size_t n {keys.size()};
+            const std::size_t chunks {chunk_count(pool, n, MIN_CHUNK)};
+            std::vector<std::uint64_t> scratch(n);
+            std::vector<std::array<std::size_t, 256>> offsets(chunks);
+
+            for (int shift {32}; shift < 64; shift += 8) {
+                run_chunks(pool, chunks, n, [&](const std::size_t c, const std::size_t begin, const std::size_t end) {
+                    offsets[c].fill(0);
+                    for (std::size_t i {begin}; i < end; ++i) ++offsets[c][(keys[i] >> shift) & 0xFF];
+                });
+
+                // Bucket-major, chunk-minor exclusive scan keeps the sort stable
+                std::size_t total {0};
+                bool one_bucket {false};
+                for (std::size_t b {0}; b < 256; ++b) {
+                    std::size_t bucket {0};
+                    for (std::size_t c {0}; c < chunks; ++c) {
+                        const std::size_t in_chunk {offsets[c][b]};
+                        offsets[c][b] = total + bucket;
+                        bucket += in_chunk;
+                    }
+                    one_bucket = one_bucket || bucket == n;
+                    total += bucket;
+                }
+                if (one_bucket) continue;  // every key has the same digit: the pass would not move anything
+
+                run_chunks(pool, chunks, n, [&](const std::size_t c, const std::size_t begin, const std::size_t end) {
+                    std::array<std::size_t, 256>& next {offsets[c]};
+                    for (std::size_t i {begin}; i < end; ++i) scratch[next[(keys[i] >> shift) & 0xFF]++] = keys[i];
+                });
+                keys.swap(scratch);
+            }
+        }
+
+        // Interior node of the binary radix tree; children are node indices or LEAF_BIT | sorted position
+        struct RadixNode {
+            AABB box;
+            std::uint32_t left {0}, right {0};
+            std::uint32_t lo {0}, hi {0};       // smallest and largest sorted position below
+            std::uint32_t count {0};            // primitives below (hi - lo + 1 until rotations move subtrees)
+        };
+
+        struct RadixTree {
+            std::vector<RadixNode> nodes;
+            std::vector<AABB> leaf_boxes;       // by sorted position
+
+            const AABB& box(const std::uint32_t ref) const { return ref & LEAF_BIT ? leaf_boxes[ref & ~LEAF_BIT] : nodes[ref].box; }
+            std::uint32_t count(const std::uint32_t ref) const { return ref & LEAF_BIT ? 1 : nodes[ref].count; }
+            std::uint32_t lo(const std::uint32_t ref) const { return ref & LEAF_BIT ? ref & ~LEAF_BIT : nodes[ref].lo; }
+            std::uint32_t hi(const std::uint32_t ref) const { return ref & LEAF_BIT ? ref & ~LEAF_BIT : nodes[ref].hi; }
+        };
+
+        // Karras 2012: node i's range and split from the common prefixes of its neighbours' keys
+        void build_radix_tree(const std::vector<std::uint64_t>& keys, const std::size_t n, ThreadPool* pool, RadixTree& tree) {
+            const auto delta = [&](const std::int64_t i, const std::int64_t j) {
+                if (j < 0 || j >= static_cast<std::int64_t>(n)) return -1;
+                return std::countl_zero(keys[i] ^ keys[j]);
+            };
+
+            std::vector<std::uint32_t> node_parent(n - 1), leaf_parent(n);
+            tree.nodes.resize(n - 1);
+            for_each_chunk(pool, n - 1, MIN_CHUNK / 4, [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t u {begin}; u < end; ++u) {
+                    const auto i {static_cast<std::int64_t>(u)};
+                    const std::int64_t d {delta(i, i + 1) > delta(i, i - 1) ? 1 : -1};
+
+                    // Far end of the range: exponential then binary search
+                    const int delta_min {delta(i, i - d)};
+                    std::int64_t l_max {2};
+                    while (delta(i, i + l_max * d) > delta_min) l_max *= 2;
+                    std::int64_t l {0};
+                    for (std::int64_t t {l_max / 2}; t >= 1; t /= 2) {
+                        if (delta(i, i + (l + t) * d) > delta_min) l += t;
+                    }
+                    const std::int64_t j {i + l * d};
+
+                    // Split: the last position sharing more than the range's common prefix with i
+                    const int delta_node {delta(i, j)};
+                    std::int64_t s {0};
+                    for (std::int64_t divisor {2};; divisor *= 2) {
+                        const std::int64_t t {(l + divisor - 1) / divisor};
+                        if (delta(i, i + (s + t) * d) > delta_node) s += t;
+                        if (t == 1) break;
+                    }
+                    const std::int64_t gamma {i + s * d + std::min<std::int64_t>(d, 0)};
+
+                    RadixNode& node {tree.nodes[u]};
+                    node.lo = static_cast<std::uint32_t>(std::min(i, j));
+                    node.hi = static_cast<std::uint32_t>(std::max(i, j));
+                    node.count = node.hi - node.lo + 1;
+                    const auto g {static_cast<std::uint32_t>(gamma)};
+                    if (node.lo == g) {
+                        node.left = LEAF_BIT | g;
+                        leaf_parent[g] = static_cast<std::uint32_t>(u);
+                    } else {
+                        node.left = g;
+                        node_parent[g] = static_cast<std::uint32_t>(u);
+                    }
+                    if (node.hi == g + 1) {
+                        node.right = LEAF_BIT | (g + 1);
+                        leaf_parent[g + 1] = static_cast<std::uint32_t>(u);
+                    } else {
+                        node.right = g + 1;
+                        node_parent[g + 1] = static_cast<std::uint32_t>(u);
+                    }
+                }
+            });
+
+            // Boxes bottom-up: the second child to arrive at a node merges both and carries on
+            std::vector<std::atomic<std::uint32_t>> arrivals(n - 1);
+            for_each_chunk(pool, n, MIN_CHUNK / 4, [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t p {begin}; p < end; ++p) {
+                    std::uint32_t node {leaf_parent[p]};
+                    while (arrivals[node].fetch_add(1, std::memory_order_acq_rel) == 1) {
+                        RadixNode& parent {tree.nodes[node]};
+                        parent.box = merged(tree.box(parent.left), tree.box(parent.right));
+                        if (node == 0) break;
+                        node = node_parent[node];
+                    }
+                }
+            });
+        }
+
+        // Kensler 2008: swap a child with a grandchild under its sibling when that shrinks the sibling
+        void rotate(RadixTree& tree, const std::uint32_t ref, const int depth, const int levels) {
+            if ((ref & LEAF_BIT) != 0 || depth >= levels) return;
+            rotate(tree, tree.nodes[ref].left, depth + 1, levels);
+            rotate(tree, tree.nodes[ref].right, depth + 1, levels);
+
+            RadixNode& node {tree.nodes[ref]};
+            float best_gain {0.0f};
+            std::uint32_t* best_outer {nullptr};    // node's child that moves down
+            std::uint32_t* best_inner {nullptr};    // grandchild that moves up
+            std::uint32_t best_sibling {0};
+            for (const bool right_side : {false, true}) {
+                const std::uint32_t sibling {right_side ? node.right : node.left};
+                std::uint32_t& outer {right_side ? node.left : node.right};
+                if ((sibling & LEAF_BIT) != 0) continue;
+                RadixNode& s {tree.nodes[sibling]};
+                for (const bool right_grandchild : {false, true}) {
+                    std::uint32_t& inner {right_grandchild ? s.right : s.left};
+                    const std::uint32_t kept {right_grandchild ? s.left : s.right};
+                    const float gain {half_area(s.box) - half_area(merged(tree.box(outer), tree.box(kept)))};
+                    if (gain > best_gain) {
+                        best_gain = gain;
+                        best_outer = &outer;
+                        best_inner = &inner;
+                        best_sibling = sibling;
+                    }
+                }
+            }
+            if (best_outer == nullptr) return;
+
+            std::swap(*best_outer, *best_inner);
+            RadixNode& s {tree.nodes[best_sibling]};
+            s.box = merged(tree.box(s.left), tree.box(s.right));
+            s.count = tree.count(s.left) + tree.count(s.right);
+            s.lo = std::min(tree.lo(s.left), tree.lo(s.right));
+            s.hi = std::max(tree.hi(s.left), tree.hi(s.right));
+        }
+    }
+
+    namespace {
+        std::atomic<BvhFormat> default_format {BvhFormat::Binary};
+
+        // Power-of-two steps so that 255 of them from box.min reach box.max on every axis
+        void set_grid(const AABB& box, Kernels::QuantisedBoxes8& boxes) {
+            for (int a {0}; a < 3; ++a) {
+                int exponent {0};
+                std::frexp((box.max[a] - box.min[a]) / 255.0f, &exponent);     // 2^exponent > extent / 255
+                exponent = std::clamp(exponent, -126, 127);
+                while (exponent < 127 && box.min[a] + 255.0f * std::ldexp(1.0f, exponent) < box.max[a]) ++exponent;
+                boxes.origin[a] = box.min[a];
+                boxes.exponent[a] = static_cast<std::int8_t>(exponent);
+            }
+        }
+
+        // Grid cells of slot i covering child, rounded outwards. cell * 2^exponent is exact but adding the origin
+        // rounds, so each bound is stepped until that rounded point, computed as enter_boxes8 computes it, lies
+        // on or outside child: the box the kernel tests always encloses it.
+        void quantise(const AABB& child, const std::size_t i, Kernels::QuantisedBoxes8& boxes) {
+            for (int a {0}; a < 3; ++a) {
+                const float origin {boxes.origin[a]};
+                const float scale {std::ldexp(1.0f, boxes.exponent[a])};
+                int lo {std::clamp(static_cast<int>(std::floor((child.min[a] - origin) / scale)), 0, 255)};
+                while (lo > 0 && origin + static_cast<float>(lo) * scale > child.min[a]) --lo;
+                int hi {std::clamp(static_cast<int>(std::ceil((child.max[a] - origin) / scale)), lo, 255)};
+                while (hi < 255 && origin + static_cast<float>(hi) * scale < child.max[a]) ++hi;
+                boxes.lo[a][i] = static_cast<std::uint8_t>(lo);
+                boxes.hi[a][i] = static_cast<std::uint8_t>(hi);
+            }
+        }
+    }
+
+    std::optional<BvhFormat> parse_bvh_format(const std::string_view name) {
+        if (name == "binary") return BvhFormat::Binary;
+        if (name == "wide") return BvhFormat::Wide;
+        return std::nullopt;
+    }
+
+    const char* to_string(const BvhFormat format) {
+        switch (format) {
+            case BvhFormat::Binary: return "binary";
+            case BvhFormat::Wide: return "wide";
+        }
+        return "unknown";
+    }
+
+    void set_bvh_format(const BvhFormat format) {
+        default_format.store(format, std::memory_order_relaxed);
+    }
+
+    BvhFormat get_bvh_format() {
+        return default_format.load(std::memory_order_relaxed);
+    }
+
+    std::string SceneBuildStats::describe() const {
+        char text[400];
+        std::snprintf(text, sizeof(text),
+                      "%zu primitives, %zu %s nodes (%.1f MiB), %u threads: read %.1f ms, primitives %.1f ms, accounting %.1f ms, bounds %.1f ms, "
+                      "morton %.1f ms, sort %.1f ms, hierarchy %.1f ms, refine %.1f ms, layout %.1f ms, collapse %.1f ms, total %.1f ms",
+                      primitives, nodes, to_string(format), static_cast<double>(hierarchy_bytes) / (1 << 20), threads,
+                      read_ms, primitives_ms, accounting_ms, bounds_ms, morton_ms, sort_ms, hierarchy_ms, refine_ms, layout_ms, collapse_ms, total_ms);
+        return text;
+    }
+
+    BvhLayout build_bvh(const std::vector<AABB>& bounds, const std::vector<PrimitiveKind>& kinds, ThreadPool* pool,
+                        const BvhBuildOptions& options, SceneBuildStats& stats) {
+        const std::size_t n {bounds.size()};
+        if (n >= LEAF_BIT) throw std::length_error("too many primitives for a hierarchy");
+        Clock::time_point lap {Clock::now()};
+
+        // Morton codes of the centroids within the bounded primitives' centroid box
+        const std::size_t chunks {chunk_count(pool, n, MIN_CHUNK)};
+        std::vector<AABB> chunk_boxes(chunks);
+        run_chunks(pool, chunks, n, [&](const std::size_t c, const std::size_t begin, const std::size_t end) {
+            for (std::size_t i {begin}; i < end; ++i) {
+                if (bounds[i].is_finite()) chunk_boxes[c].expand(bounds[i].center());
+            }
+        });
+        AABB centroids;
+        for (const AABB& box : chunk_boxes) centroids.expand(box);
+        const vec3 scale {1.0f / max(centroids.extent(), vec3(1e-20f))};
+
+        std::vector<std::uint64_t> keys(n);
+        for_each_chunk(pool, n, MIN_CHUNK, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i {begin}; i < end; ++i) {
+                const std::uint32_t code {bounds[i].is_finite() ? morton_code((bounds[i].center() - centroids.min) * scale) : UNBOUNDED_CODE};
+                keys[i] = static_cast<std::uint64_t>(code) << 32 | i;
+            }
+        });
+        stats.morton_ms = lap_ms(lap);
+
+        radix_sort(keys, pool);
+        stats.sort_ms = lap_ms(lap);
+
+        BvhLayout layout;
+        layout.order.resize(n);
+        layout.slot.resize(n);
+        const std::size_t bounded_count {static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), static_cast<std::uint64_t>(UNBOUNDED_CODE) << 32) - keys.begin())};
+
+        // Per-kind ranks of every sorted position (and past the end), from per-chunk counts
+        std::array<std::vector<std::uint32_t>, PRIMITIVE_KIND_COUNT> rank;
+        for (auto& r : rank) r.resize(n + 1);
+        std::vector<std::array<std::uint32_t, PRIMITIVE_KIND_COUNT>> chunk_counts(chunks);
+        run_chunks(pool, chunks, n, [&](const std::size_t c, const std::size_t begin, const std::size_t end) {
+            chunk_counts[c].fill(0);
+            for (std::size_t p {begin}; p < end; ++p) {
+                layout.order[p] = static_cast<std::uint32_t>(keys[p]);
+                ++chunk_counts[c][static_cast<std::size_t>(kinds[layout.order[p]])];
+            }
+        });
+        std::array<std::uint32_t, PRIMITIVE_KIND_COUNT> running {};
+        for (auto& counts : chunk_counts) {
+            for (std::size_t k {0}; k < PRIMITIVE_KIND_COUNT; ++k) {
+                const std::uint32_t in_chunk {counts[k]};
+                counts[k] = running[k];
+                running[k] += in_chunk;
+            }
+        }
+        for (std::size_t k {0}; k < PRIMITIVE_KIND_COUNT; ++k) rank[k][n] = running[k];
+        run_chunks(pool, chunks, n, [&](const std::size_t c, const std::size_t begin, const std::size_t end) {
+            std::array<std::uint32_t, PRIMITIVE_KIND_COUNT> next {chunk_counts[c]};
+            for (std::size_t p {begin}; p < end; ++p) {
+                for (std::size_t k {0}; k < PRIMITIVE_KIND_COUNT; ++k) rank[k][p] = next[k];
+                const auto k {static_cast<std::size_t>(kinds[layout.order[p]])};
+                layout.slot[p] = next[k]++;
+            }
+        });
+        for (std::size_t k {0}; k < PRIMITIVE_KIND_COUNT; ++k) layout.bounded[k] = rank[k][bounded_count];
+
+        // Radix tree over the bounded primitives, with slightly padded boxes so float hits on the surface stay inside
+        RadixTree tree;
+        tree.leaf_boxes.resize(bounded_count);
+        for_each_chunk(pool, bounded_count, MIN_CHUNK, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t p {begin}; p < end; ++p) {
+                const AABB& box {bounds[layout.order[p]]};
+                const vec3 magnitude {max(abs(box.min), abs(box.max))};
+                const float pad {1e-5f * (std::max(magnitude.x, std::max(magnitude.y, magnitude.z)) + 1.0f)};
+                tree.leaf_boxes[p] = {box.min - vec3(pad), box.max + vec3(pad)};
+            }
+        });
+        if (bounded_count >= 2) build_radix_tree(keys, bounded_count, pool, tree);
+        stats.hierarchy_ms = lap_ms(lap);
+
+        if (bounded_count >= 2) rotate(tree, 0, 0, options.sah_levels);
+        stats.refine_ms = lap_ms(lap);
+
+        // Depth-first flattening; subtrees of few contiguous primitives become leaves
+        if (bounded_count > 0) {
+            layout.nodes.reserve(2 * (bounded_count / BVH_LEAF_SIZE + 1));
+            constexpr std::uint32_t NO_PARENT {~0u};
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> stack {{bounded_count >= 2 ? 0u : LEAF_BIT, NO_PARENT}};
+            while (!stack.empty()) {
+                const auto [ref, parent] {stack.back()};
+                stack.pop_back();
+                const auto index {static_cast<std::uint32_t>(layout.nodes.size())};
+                if (parent != NO_PARENT) layout.nodes[parent].first[0] = index;
+
+                BvhNode node;
+                node.box = tree.box(ref);
+                const std::uint32_t count {tree.count(ref)};
+                const std::uint32_t lo {tree.lo(ref)};
+                if (count <= BVH_LEAF_SIZE && tree.hi(ref) - lo + 1 == count) {
+                    for (std::size_t k {0}; k < PRIMITIVE_KIND_COUNT; ++k) {
+                        node.first[k] = rank[k][lo];
+                        node.count[k] = static_cast<std::uint8_t>(rank[k][lo + count] - rank[k][lo]);
+                    }
+                    layout.nodes.push_back(node);
+                } else {
+                    layout.nodes.push_back(node);
+                    stack.emplace_back(tree.nodes[ref].right, index);
+                    stack.emplace_back(tree.nodes[ref].left, NO_PARENT);
+                }
+            }
+        }
+        stats.hierarchy_ms += lap_ms(lap);
+        stats.nodes = layout.nodes.size();
+        return layout;
+    }
+
+    WideBvh collapse_bvh(const std::vector<BvhNode>& nodes) {
+        WideBvh wide;
+        if (nodes.empty()) return wide;
+        wide.nodes.reserve(nodes.size() / 4 + 1);
+        wide.leaves.reserve(nodes.size() / 2 + 1);
+
+        // Breadth-first, so each node's interior children can be given consecutive slots
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pending {{0, 0}};     // binary node, wide node
+        wide.nodes.emplace_back();
+        for (std::size_t next {0}; next < pending.size(); ++next) {
+            const auto [source, target] {pending[next]};
+            const BvhNode& parent {nodes[source]};
+
+            std::array<std::uint32_t, BVH_WIDTH> children {source};
+            std::size_t count {1};
+            if (!parent.is_leaf()) {
+                children = {source + 1, parent.first[0]};
+                count = 2;
+                while (count < BVH_WIDTH) {
+                    std::size_t largest {BVH_WIDTH};
+                    float largest_area {-1.0f};
+                    for (std::size_t c {0}; c < count; ++c) {
+                        if (nodes[children[c]].is_leaf()) continue;
+                        if (const float area {half_area(nodes[children[c]].box)}; area > largest_area) {
+                            largest = c;
+                            largest_area = area;
+                        }
+                    }
+                    if (largest == BVH_WIDTH) break;
+                    const std::uint32_t opened {children[largest]};
+                    children[largest] = opened + 1;
+                    children[count++] = nodes[opened].first[0];
+                }
+            }
+
+            WideBvhNode node;
+            set_grid(parent.box, node.boxes);
+            node.boxes.count = static_cast<std::uint8_t>(count);
+            node.first_node = static_cast<std::uint32_t>(wide.nodes.size());
+            node.first_leaf = static_cast<std::uint32_t>(wide.leaves.size());
+            std::uint8_t interior {0}, leaves {0};
+            for (std::size_t c {0}; c < count; ++c) {
+                const BvhNode& child {nodes[children[c]]};
+                quantise(child.box, c, node.boxes);
+                if (child.is_leaf()) {
+                    node.child[c] = WIDE_LEAF_BIT | leaves++;
+                    wide.leaves.push_back({child.first, child.count});
+                } else {
+                    node.child[c] = interior++;
+                    pending.emplace_back(children[c], static_cast<std::uint32_t>(wide.nodes.size()));
+                    wide.nodes.emplace_back();
+                }
+            }
+            wide.nodes[target] = node;
+        }
+        return wide;
+    }
+}
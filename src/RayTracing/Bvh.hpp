@@ -0,0 +1,163 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_BVH_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_BVH_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Utilities/AABB.hpp"
+#include "Utilities/Kernels.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /// How an ObjectSet stores a primitive: in the sphere or quadric kernel arrays, or by pointer.
+    enum class PrimitiveKind : std::uint8_t { Sphere, Quadric, Other };
+    inline constexpr std::size_t PRIMITIVE_KIND_COUNT {3};
+
+    /// Largest number of primitives a hierarchy leaf holds.
+    inline constexpr std::size_t BVH_LEAF_SIZE {4};
+
+    /**
+     * @brief Node of a flattened bounding volume hierarchy, in depth-first order.
+     *
+     * An interior node's first child follows it; first[0] is the index of the
+     * second. A leaf holds, per kind, count[k] primitives starting at index
+     * first[k] of that kind's array.
+     */
+    struct BvhNode {
+        AABB box;
+        std::array<std::uint32_t, PRIMITIVE_KIND_COUNT> first {};
+        std::array<std::uint8_t, PRIMITIVE_KIND_COUNT> count {};
+
+        bool is_leaf() const { return count[0] != 0 || count[1] != 0 || count[2] != 0; }
+    };
+
+    /// Largest number of children of a wide hierarchy node.
+    inline constexpr std::size_t BVH_WIDTH {8};
+
+    /// Per-kind primitive ranges of a wide hierarchy's leaf, as in a binary leaf node.
+    struct BvhLeaf {
+        std::array<std::uint32_t, PRIMITIVE_KIND_COUNT> first {};
+        std::array<std::uint8_t, PRIMITIVE_KIND_COUNT> count {};
+    };
+
+    /// Marks a WideBvhNode child as a leaf.
+    inline constexpr std::uint8_t WIDE_LEAF_BIT {0x80};
+
+    /**
+     * @brief Node of a compressed 8-wide hierarchy: 80 bytes for up to eight children.
+     *
+     * Child boxes are quantised to 8-bit grids within the node's box and
+     * tested together by Kernels::enter_boxes8. Child c is leaf
+     * first_leaf + (child[c] & ~WIDE_LEAF_BIT) if that bit is set, else node
+     * first_node + child[c]; a node's interior children are consecutive, and
+     * so are its leaves.
+     */
+    struct WideBvhNode {
+        Kernels::QuantisedBoxes8 boxes {};
+        std::uint32_t first_node {0};
+        std::uint32_t first_leaf {0};
+        std::array<std::uint8_t, BVH_WIDTH> child {};
+    };
+
+    /// Wide nodes (the root first) and the leaves they reference.
+    struct WideBvh {
+        std::vector<WideBvhNode> nodes;
+        std::vector<BvhLeaf> leaves;
+    };
+
+    /// Node layout of the hierarchies ObjectSet::build creates.
+    enum class BvhFormat : std::uint8_t {
+        Binary,     // BvhNode: two children with float boxes
+        Wide,       // WideBvhNode: up to eight children with quantised boxes
+    };
+
+    /// Parse "binary" or "wide"; nullopt otherwise.
+    std::optional<BvhFormat> parse_bvh_format(std::string_view name);
+    const char* to_string(BvhFormat format);
+
+    /// Format of hierarchies built without one (Binary until set, e.g. by --bvh).
+    void set_bvh_format(BvhFormat format);
+    BvhFormat get_bvh_format();
+
+    struct BvhBuildOptions {
+        std::size_t min_primitives {64};    // fewer bounded primitives than this are tested without a hierarchy
+        int sah_levels {10};                // top levels improved by surface-area tree rotations (0: plain LBVH)
+        BvhFormat format {get_bvh_format()};
+    };
+
+    /// Wall time of each phase of a scene build: loading (scene files only), accounting, then ObjectSet::build.
+    struct SceneBuildStats {
+        std::size_t primitives {0};
+        std::size_t nodes {0};              // 0 when no hierarchy was built
+        std::size_t hierarchy_bytes {0};    // nodes (and wide leaves)
+        BvhFormat format {BvhFormat::Binary};
+        unsigned threads {1};
+        double read_ms {0.0};               // scene text split into lines; lights, definitions and instances (serial)
+        double primitives_ms {0.0};         // primitive lines parsed, axes normalised and bases set up
+        double accounting_ms {0.0};         // geometry charge and material flags
+        double bounds_ms {0.0};             // per-primitive kinds and bounds
+        double morton_ms {0.0};             // centroid bounds and Morton codes
+        double sort_ms {0.0};               // radix sort of the codes
+        double hierarchy_ms {0.0};          // radix tree, bottom-up boxes and leaf collapse
+        double refine_ms {0.0};             // SAH rotations of the top levels
+        double layout_ms {0.0};             // kernel arrays written in leaf order
+        double collapse_ms {0.0};           // wide nodes from the binary tree (Wide format only)
+        double total_ms {0.0};              // all of the above
+
+        /// One line, e.g. "1000000 primitives, 470000 binary nodes (17.9 MiB), 8 threads: read 210.4 ms, ... total 402.0 ms".
+        std::string describe() const;
+    };
+
+    /// Primitives in hierarchy order plus the flattened nodes.
+    struct BvhLayout {
+        std::vector<BvhNode> nodes;
+        std::vector<std::uint32_t> order;   // source index of the primitive at each position: bounded ones in leaf order, then unbounded
+        std::vector<std::uint32_t> slot;    // index within its kind's array of the primitive at each position
+        std::array<std::size_t, PRIMITIVE_KIND_COUNT> bounded {};   // per kind, the leading entries the hierarchy covers
+    };
+
+    /**
+     * @brief Parallel LBVH build (Karras 2012) over primitive bounds.
+     *
+     * Centroids are quantised to 30-bit Morton codes, made unique by appending
+     * the primitive index and sorted with a parallel LSD radix sort. Every
+     * interior node of the binary radix tree over the sorted codes is then
+     * found independently, boxes are merged bottom-up with one atomic per
+     * node, and subtrees of at most BVH_LEAF_SIZE primitives collapse into
+     * leaves. Finally the top sah_levels levels are improved by tree rotations
+     * (Kensler 2008), which keep every leaf's primitives contiguous.
+     *
+     * Unbounded primitives stay out of the hierarchy. Phases run on pool
+     * (serially if null); the result does not depend on the thread count.
+     */
+    BvhLayout build_bvh(const std::vector<AABB>& bounds, const std::vector<PrimitiveKind>& kinds, ThreadPool* pool,
+                        const BvhBuildOptions& options, SceneBuildStats& stats);
+
+    /**
+     * @brief Collapse a binary hierarchy from build_bvh into an 8-wide one over the same leaves.
+     *
+     * Each wide node starts from a binary node's two children and opens its
+     * largest-area interior child until it has BVH_WIDTH of them, so the
+     * top of the tree, which every ray visits, gets the widest nodes. Child
+     * boxes are rounded outwards onto the grid: traversal may enter a little
+     * more space but never misses a primitive.
+     */
+    WideBvh collapse_bvh(const std::vector<BvhNode>& nodes);
+
+    /// Distance along the ray to box entry (t_min if inside), or a negative value if the box is missed within [t_min, t_max].
+    inline float enter_box(const AABB& box, const glm::vec3& origin, const glm::vec3& inverse_direction, const float t_min, const float t_max) {
+        const glm::vec3 t0 {(box.min - origin) * inverse_direction};
+        const glm::vec3 t1 {(box.max - origin) * inverse_direction};
+        const glm::vec3 near {glm::min(t0, t1)};
+        const glm::vec3 far {glm::max(t0, t1)};
+        const float enter {std::max(std::max(near.x, near.y), std::max(near.z, t_min))};
+        const float leave {std::min(std::min(far.x, far.y), std::min(far.z, t_max))};
+        return enter <= leave ? enter : -1.0f;
+    }
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_BVH_HPP
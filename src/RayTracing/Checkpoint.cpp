@@ -0,0 +1,191 @@
+#include "RayTracing/Checkpoint.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RayTracing {
+
+    namespace {
+        constexpr char MAGIC[8] {'R', 'T', 'C', 'K', 'P', 'T', '1', '\0'};
+
+        struct Header {
+            char magic[8];
+            std::uint32_t width, height, tile_size, pixel_size;
+            std::uint64_t tile_count;
+            std::uint64_t fingerprint;
+        };
+
+        constexpr std::size_t align64(const std::size_t n) { return (n + 63) & ~std::size_t{63}; }
+
+        std::runtime_error system_failure(const std::string& what, const std::string& path) {
+            return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    // --- Constructors ---
+    Checkpoint::Checkpoint(const std::string& path_, const int width_, const int height_, const int tile_size_, const std::uint64_t fingerprint, const bool resume)
+        : path(path_), width(width_), height(height_), tile_size(std::max(1, tile_size_)),
+          tiles(static_cast<std::size_t>((width_ + tile_size - 1) / tile_size) * ((height_ + tile_size - 1) / tile_size)) {
+        const std::size_t bitmap_offset {align64(sizeof(Header))};
+        pixels_offset = bitmap_offset + align64((tiles + 7) / 8);
+        mapping_size = pixels_offset + static_cast<std::size_t>(width) * height * sizeof(RGB);
+        charge = Memory::Charge(Memory::Subsystem::Pixels, mapping_size, "checkpoint mapping");
+
+        fd = ::open(path.c_str(), resume ? O_RDWR : O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw system_failure(resume ? "cannot open checkpoint" : "cannot create checkpoint", path);
+
+        if (resume) {
+            struct stat st {};
+            if (::fstat(fd, &st) < 0) {
+                ::close(fd);
+                throw system_failure("cannot stat checkpoint", path);
+            }
+            if (static_cast<std::size_t>(st.st_size) != mapping_size) {
+                ::close(fd);
+                throw std::runtime_error("checkpoint " + path + " does not match this render (size differs)");
+            }
+        } else if (::ftruncate(fd, static_cast<off_t>(mapping_size)) < 0) {
+            ::close(fd);
+            throw system_failure("cannot size checkpoint", path);
+        }
+
+        mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            ::close(fd);
+            throw system_failure("cannot map checkpoint", path);
+        }
+
+        auto* base {static_cast<unsigned char*>(mapping)};
+        auto* header {reinterpret_cast<Header*>(base)};
+        bitmap = base + bitmap_offset;
+        framebuffer = reinterpret_cast<RGB*>(base + pixels_offset);
+        pending.assign((tiles + 7) / 8, 0);
+
+        const Header expected {{}, static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), static_cast<std::uint32_t>(tile_size),
+                               static_cast<std::uint32_t>(sizeof(RGB)), tiles, fingerprint};
+        if (resume) {
+            if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->width != expected.width || header->height != expected.height
+                || header->tile_size != expected.tile_size || header->pixel_size != expected.pixel_size
+                || header->tile_count != expected.tile_count || header->fingerprint != expected.fingerprint) {
+                ::munmap(mapping, mapping_size);
+                ::close(fd);
+                throw std::runtime_error("checkpoint " + path + " belongs to a different render");
+            }
+        } else {
+            // A fresh file is zero-filled: no tile done
+            *header = expected;
+            std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        }
+    }
+
+    Checkpoint::~Checkpoint() {
+        if (mapping) {
+            // A failed sync leaves the tiles unrecorded; resuming traces them again
+            try {
+                sync();
+            } catch (const std::runtime_error&) {}
+            ::munmap(mapping, mapping_size);
+        }
+        if (fd >= 0) ::close(fd);
+    }
+
+    // --- Completion bitmap ---
+    std::size_t Checkpoint::done_count() const {
+        std::size_t count {0};
+        for (std::size_t i {0}; i < (tiles + 7) / 8; ++i) {
+            const auto synced {std::atomic_ref<std::uint8_t>(bitmap[i]).load(std::memory_order_relaxed)};
+            const auto unsynced {std::atomic_ref<const std::uint8_t>(pending[i]).load(std::memory_order_relaxed)};
+            count += static_cast<std::size_t>(std::popcount(static_cast<std::uint8_t>(synced | unsynced)));
+        }
+        return count;
+    }
+
+    bool Checkpoint::is_done(const std::size_t tile) const {
+        const std::uint8_t bit {static_cast<std::uint8_t>(1u << (tile % 8))};
+        return (std::atomic_ref<std::uint8_t>(bitmap[tile / 8]).load(std::memory_order_acquire) & bit)
+            || (std::atomic_ref<const std::uint8_t>(pending[tile / 8]).load(std::memory_order_acquire) & bit);
+    }
+
+    void Checkpoint::mark_done(const std::size_t tile) {
+        // Release: the tile's pixels are in the mapping before sync() sees its bit
+        std::atomic_ref<std::uint8_t>(pending[tile / 8]).fetch_or(static_cast<std::uint8_t>(1u << (tile % 8)), std::memory_order_release);
+    }
+
+    void Checkpoint::sync() {
+        std::vector<std::uint8_t> ready(pending.size());
+        for (std::size_t i {0}; i < pending.size(); ++i) {
+            ready[i] = std::atomic_ref<std::uint8_t>(pending[i]).exchange(0, std::memory_order_acquire);
+        }
+        // Barrier: the ready tiles' pixels reach the disk before any bit that vouches for them
+        if (::msync(mapping, mapping_size, MS_SYNC) != 0) {
+            const int error {errno};
+            for (std::size_t i {0}; i < ready.size(); ++i) {
+                if (ready[i] != 0) std::atomic_ref<std::uint8_t>(pending[i]).fetch_or(ready[i], std::memory_order_relaxed);
+            }
+            errno = error;
+            throw system_failure("cannot sync checkpoint", path);
+        }
+        for (std::size_t i {0}; i < ready.size(); ++i) {
+            if (ready[i] != 0) std::atomic_ref<std::uint8_t>(bitmap[i]).fetch_or(ready[i], std::memory_order_relaxed);
+        }
+        // The pixels are durable, so the bits stand even if they do not reach the disk
+        if (::msync(mapping, pixels_offset, MS_ASYNC) != 0) throw system_failure("cannot flush checkpoint bitmap", path);
+    }
+
+    // --- Rendering ---
+    std::vector<RGB> render_with_checkpoint(const Scene& scene, const Camera& camera, ThreadPool& pool, Checkpoint& checkpoint,
+                                            const std::chrono::milliseconds sync_interval) {
+        using Clock = std::chrono::steady_clock;
+        const int width {checkpoint.get_width()};
+        const int height {checkpoint.get_height()};
+        const std::vector<Tile> tiles {make_tiles(width, height, checkpoint.get_tile_size())};
+
+        std::mutex sync_mutex;
+        Clock::time_point last_sync {Clock::now()};
+
+        pool.parallel_for(tiles.size(), [&](const std::size_t i) {
+            if (checkpoint.is_done(i)) return;
+            render_tile(scene, camera, width, height, tiles[i], checkpoint.pixels());
+            checkpoint.mark_done(i);
+
+            if (std::unique_lock lock(sync_mutex, std::try_to_lock); lock && Clock::now() - last_sync >= sync_interval) {
+                checkpoint.sync();
+                last_sync = Clock::now();
+            }
+        });
+        checkpoint.sync();
+
+        return {checkpoint.pixels(), checkpoint.pixels() + static_cast<std::size_t>(width) * height};
+    }
+
+    // --- Fingerprint ---
+    Fingerprint& Fingerprint::add(const std::string_view bytes) {
+        // Length first, so consecutive fields cannot run into each other
+        const std::uint64_t length {bytes.size()};
+        for (const std::string_view part : {std::string_view(reinterpret_cast<const char*>(&length), sizeof(length)), bytes}) {
+            for (const char c : part) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+        }
+        return *this;
+    }
+
+    Fingerprint& Fingerprint::add_file(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open " + path + " to fingerprint it");
+        const std::string contents {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        return add(contents);
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_CHECKPOINT_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_CHECKPOINT_HPP
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "Utilities/MemoryAccounting.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief Memory-mapped render state that survives a crash.
+     *
+     * The file holds a small header, a completion bitmap with one bit per tile
+     * and the framebuffer itself. Tiles are traced straight into the mapping,
+     * so checkpointing costs no copies. mark_done() records a tile in memory
+     * only; sync() first writes the pixels back synchronously and only then
+     * sets the tiles' bits in the file, so a bit on disk never vouches for
+     * pixels that are not, even after power loss. Tiles finished since the
+     * last sync() are traced again on resume.
+     *
+     * The fingerprint identifies the render (see Fingerprint); resuming a
+     * file with a different fingerprint, size or tile size throws.
+     */
+    class Checkpoint {
+    public:
+        /// Create (resume = false, truncating any old file) or reopen (resume = true) a checkpoint.
+        Checkpoint(const std::string& path, int width, int height, int tile_size, std::uint64_t fingerprint, bool resume);
+        ~Checkpoint();
+
+        Checkpoint(const Checkpoint&) = delete;
+        Checkpoint& operator=(const Checkpoint&) = delete;
+
+        // Getters
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+        int get_tile_size() const { return tile_size; }
+        std::size_t tile_count() const { return tiles; }
+        std::size_t done_count() const;
+        RGB* pixels() const { return framebuffer; }
+
+        /// Done in the file or since it was opened.
+        bool is_done(std::size_t tile) const;
+        void mark_done(std::size_t tile);
+
+        /**
+         * Make the pixels of the tiles marked done so far durable, then record them in the file (blocks on the disk).
+         * @throws std::runtime_error if the pixels cannot be written back (the tiles stay pending and no bit is set) or the bitmap cannot be flushed
+         */
+        void sync();
+
+    private:
+        std::string path;
+        int width, height, tile_size;
+        std::size_t tiles;
+        int fd {-1};
+        void* mapping {nullptr};
+        std::size_t mapping_size {0};
+        std::size_t pixels_offset {0};
+        std::uint8_t* bitmap {nullptr};             // in the file: tiles whose pixels are on disk
+        std::vector<std::uint8_t> pending;          // tiles done but not yet synced
+        RGB* framebuffer {nullptr};
+        Memory::Charge charge;
+    };
+
+    /**
+     * @brief Hash of everything that decides a checkpointed image (FNV-1a).
+     *
+     * Feed it the scene's source, camera, size and every option that changes
+     * pixels, so a checkpoint is never resumed into a different image.
+     */
+    class Fingerprint {
+    public:
+        Fingerprint& add(std::string_view bytes);
+        /// Contents of the file at path. @throws std::runtime_error if it cannot be read.
+        Fingerprint& add_file(const std::string& path);
+
+        template <class T>
+        Fingerprint& add_value(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return add(std::string_view(reinterpret_cast<const char*>(&value), sizeof(T)));
+        }
+
+        std::uint64_t value() const { return hash; }
+
+    private:
+        std::uint64_t hash {14695981039346656037ull};
+    };
+
+    /**
+     * @brief render() that skips tiles already done in checkpoint and records new ones.
+     *
+     * The framebuffer lives in the checkpoint; the returned copy is the full
+     * image. Finished tiles are made durable at most every sync_interval.
+     * @throws std::runtime_error if the checkpoint cannot be synced
+     */
+    std::vector<RGB> render_with_checkpoint(const Scene& scene, const Camera& camera, ThreadPool& pool, Checkpoint& checkpoint,
+                                            std::chrono::milliseconds sync_interval = std::chrono::seconds(5));
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_CHECKPOINT_HPP
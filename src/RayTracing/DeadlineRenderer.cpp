@@ -0,0 +1,150 @@
+#include "RayTracing/DeadlineRenderer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace RayTracing {
+
+    using namespace glm;
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr int TILE_SIZE {32};                  // multiple of every block size
+        constexpr QualityLevel PROBE_SHALLOW {8, 0, 1};
+        constexpr QualityLevel PROBE_DEEP {8, MAX_RECURSION_DEPTH, 1};
+        constexpr double SAFETY {0.8};                 // share of the remaining budget a pass may be predicted to use
+
+        double ms_since(const Clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        double ray_count(const QualityLevel& level, const int width, const int height) {
+            const int b {level.block_size};
+            return static_cast<double>((width + b - 1) / b) * ((height + b - 1) / b) * level.samples();
+        }
+
+        // Trace one tile at the given quality into the full-resolution framebuffer
+        void render_tile_at(const Scene& scene, const Camera& camera, const int width, const int height, const Tile& tile,
+                            const QualityLevel& level, RGB* framebuffer) {
+            ObjectSet culled;
+            const ObjectSet& candidates {cull_for_tile(scene, camera, width, height, tile, culled)};
+
+            const int b {level.block_size};
+            const int n {level.samples_per_axis};
+            const int start_depth {MAX_RECURSION_DEPTH - level.reflection_depth};
+
+            for (int by {tile.y0}; by < tile.y1; by += b) {
+                for (int bx {tile.x0}; bx < tile.x1; bx += b) {
+                    // One sample point per block: its central pixel
+                    const int x_canvas {std::min(bx + b / 2, tile.x1 - 1) - width / 2};
+                    const int y_canvas {height / 2 - std::min(by + b / 2, tile.y1 - 1)};
+
+                    RGB color;
+                    if (n == 1) {
+                        const vec3 direction {normalize(camera.direction(x_canvas, y_canvas, width, height))};
+                        color = trace_ray(Ray(camera.position, direction), 1.0f, INFINITY, scene, candidates, start_depth);
+                    } else {
+                        // Stratified sub-pixel grid, offsets within the half-pixel culling margin
+                        int sum_r {0}, sum_g {0}, sum_b {0};
+                        for (int sy {0}; sy < n; ++sy) {
+                            for (int sx {0}; sx < n; ++sx) {
+                                const float dx {(static_cast<float>(sx) + 0.5f) / static_cast<float>(n) - 0.5f};
+                                const float dy {(static_cast<float>(sy) + 0.5f) / static_cast<float>(n) - 0.5f};
+                                const vec3 direction {normalize(camera.direction(static_cast<float>(x_canvas) + dx, static_cast<float>(y_canvas) - dy, width, height))};
+                                const RGB sample {trace_ray(Ray(camera.position, direction), 1.0f, INFINITY, scene, candidates, start_depth)};
+                                sum_r += sample.r;
+                                sum_g += sample.g;
+                                sum_b += sample.b;
+                            }
+                        }
+                        color = RGB(sum_r / level.samples(), sum_g / level.samples(), sum_b / level.samples());
+                    }
+
+                    for (int y {by}; y < std::min(by + b, tile.y1); ++y) {
+                        std::fill(framebuffer + static_cast<std::size_t>(y) * width + bx,
+                                  framebuffer + static_cast<std::size_t>(y) * width + std::min(bx + b, tile.x1), color);
+                    }
+                }
+            }
+        }
+
+        // One pass over the image; tiles not started by the deadline are left as they were
+        std::size_t run_pass(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool,
+                             const std::vector<Tile>& tiles, const QualityLevel& level, const Clock::time_point deadline, RGB* framebuffer) {
+            std::atomic<std::size_t> completed {0};
+            pool.parallel_for(tiles.size(), [&](const std::size_t i) {
+                if (Clock::now() >= deadline) return;
+                render_tile_at(scene, camera, width, height, tiles[i], level, framebuffer);
+                completed.fetch_add(1, std::memory_order_relaxed);
+            });
+            return completed.load();
+        }
+    }
+
+    std::string QualityLevel::describe() const {
+        return "scale 1/" + std::to_string(block_size) + ", reflection depth " + std::to_string(reflection_depth)
+             + ", " + std::to_string(samples()) + " spp";
+    }
+
+    const std::vector<QualityLevel>& quality_ladder() {
+        static const std::vector<QualityLevel> ladder {
+            {4, 0, 1}, {4, MAX_RECURSION_DEPTH, 1},
+            {2, 1, 1}, {2, MAX_RECURSION_DEPTH, 1},
+            {1, 1, 1}, {1, MAX_RECURSION_DEPTH, 1},
+            {1, MAX_RECURSION_DEPTH, 2}, {1, MAX_RECURSION_DEPTH, 3},
+        };
+        return ladder;
+    }
+
+    DeadlineResult render_with_deadline(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool, const double budget_ms) {
+        const Clock::time_point start {Clock::now()};
+        const Clock::time_point deadline {start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(budget_ms))};
+        const std::vector<Tile> tiles {make_tiles(width, height, TILE_SIZE)};
+
+        DeadlineResult result;
+        result.framebuffer.resize(static_cast<std::size_t>(width) * height);
+
+        // Probe: always runs to completion and leaves a complete fallback image
+        const Clock::time_point never {Clock::time_point::max()};
+        const Clock::time_point probe_start {Clock::now()};
+        run_pass(scene, camera, width, height, pool, tiles, PROBE_SHALLOW, never, result.framebuffer.data());
+        const double shallow_ms {ms_since(probe_start)};
+        run_pass(scene, camera, width, height, pool, tiles, PROBE_DEEP, never, result.framebuffer.data());
+        result.probe_ms = ms_since(probe_start);
+        result.quality = PROBE_DEEP;
+
+        // Wall time per ray, linear in reflection depth
+        const double probe_rays {ray_count(PROBE_DEEP, width, height)};
+        const double shallow_cost {shallow_ms / probe_rays};
+        const double deep_cost {std::max(shallow_cost, (result.probe_ms - shallow_ms) / probe_rays)};
+        const auto predicted_ms = [&](const QualityLevel& level) {
+            const double depth_share {static_cast<double>(level.reflection_depth) / MAX_RECURSION_DEPTH};
+            return ray_count(level, width, height) * (shallow_cost + (deep_cost - shallow_cost) * depth_share);
+        };
+
+        // Start at the best rung predicted to fit, then refine until time runs out
+        const std::vector<QualityLevel>& ladder {quality_ladder()};
+        const double remaining_ms {budget_ms - ms_since(start)};
+        std::size_t first {ladder.size()};
+        for (std::size_t i {ladder.size()}; i-- > 0;) {
+            if (predicted_ms(ladder[i]) <= remaining_ms * SAFETY) {
+                first = i;
+                break;
+            }
+        }
+
+        for (std::size_t i {first}; i < ladder.size() && Clock::now() < deadline; ++i) {
+            const std::size_t completed {run_pass(scene, camera, width, height, pool, tiles, ladder[i], deadline, result.framebuffer.data())};
+            if (completed < tiles.size()) {
+                result.refined_fraction = static_cast<float>(completed) / static_cast<float>(tiles.size());
+                break;
+            }
+            result.quality = ladder[i];
+        }
+
+        result.elapsed_ms = ms_since(start);
+        return result;
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_DEADLINERENDERER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_DEADLINERENDERER_HPP
+#include <string>
+#include <vector>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief One rung of the quality ladder used by render_with_deadline.
+     *
+     * block_size > 1 traces one ray per block_size x block_size pixel block and
+     * fills the block with it. reflection_depth is the number of mirror bounces
+     * (MAX_RECURSION_DEPTH is what render() uses); a ray that runs out of bounces
+     * reflects black, like the full tracer does at its limit. Each pixel averages
+     * samples_per_axis^2 stratified sub-pixel rays.
+     */
+    struct QualityLevel {
+        int block_size {1};
+        int reflection_depth {MAX_RECURSION_DEPTH};
+        int samples_per_axis {1};
+
+        float resolution_scale() const { return 1.0f / static_cast<float>(block_size); }
+        int samples() const { return samples_per_axis * samples_per_axis; }
+        std::string describe() const;
+    };
+
+    /**
+     * @brief Ladder from cheapest to best.
+     *
+     * The full-resolution, full-depth, 1 spp rung equals render() for scenes
+     * that need no sampling; with area lights or glossy materials the rungs
+     * use light centers and mirror reflections (hard shadows), and the
+     * supersampled rungs soften edges only.
+     */
+    const std::vector<QualityLevel>& quality_ladder();
+
+    struct DeadlineResult {
+        std::vector<RGB> framebuffer;
+        QualityLevel quality;           // best level that covers the whole image
+        float refined_fraction {0.0f};  // share of tiles already re-rendered at a higher level when time ran out
+        double probe_ms {0.0};
+        double elapsed_ms {0.0};
+    };
+
+    /**
+     * @brief Render within a wall-clock budget, trading quality for time.
+     *
+     * A 1/8-resolution probe (traced at the shallowest and the deepest
+     * reflection depth) both measures the per-ray cost and provides a complete
+     * fallback image. The highest rung predicted to fit the remaining budget is
+     * rendered next, then higher rungs as refinement. Every pass overwrites the
+     * previous image tile by tile and no tile is started after the deadline, so
+     * the returned image is always complete; the only overrun is tiles already
+     * in flight when time runs out.
+     */
+    DeadlineResult render_with_deadline(const Scene& scene, const Camera& camera, int width, int height, ThreadPool& pool, double budget_ms);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_DEADLINERENDERER_HPP
@@ -0,0 +1,11 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_DEFAULTSCENE_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_DEFAULTSCENE_HPP
+#include "RayTracing/RayTracing.hpp"
+
+namespace RayTracing {
+
+    /// The built-in scene RayTracer renders without --scene: four spheres, a floor, a mirror, a cylinder and a torus.
+    Scene make_default_scene();
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_DEFAULTSCENE_HPP
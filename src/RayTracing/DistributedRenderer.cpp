@@ -0,0 +1,500 @@
+#include "RayTracing/DistributedRenderer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Utilities/Kernels.hpp"
+
+namespace RayTracing {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr std::size_t TILES_PER_THREAD {2};   // in flight per worker thread
+        constexpr int POLL_INTERVAL_MS {100};          // timeout checks run at least this often
+
+        std::runtime_error socket_error(const std::string& what) {
+            return std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        /// Owns a socket descriptor.
+        struct Socket {
+            int fd {-1};
+
+            explicit Socket(const int fd_) : fd(fd_) {}
+            ~Socket() { if (fd >= 0) ::close(fd); }
+            Socket(const Socket&) = delete;
+            Socket& operator=(const Socket&) = delete;
+        };
+
+        // Returns false once the peer has gone away
+        bool send_all(const int fd, const char* data, const std::size_t size) {
+            std::size_t sent {0};
+            while (sent < size) {
+                const ssize_t n {::send(fd, data + sent, size - sent, MSG_NOSIGNAL)};
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                sent += static_cast<std::size_t>(n);
+            }
+            return true;
+        }
+
+        bool send_line(const int fd, const std::string& line) {
+            const std::string message {line + "\n"};
+            return send_all(fd, message.data(), message.size());
+        }
+
+        // Tile commands and replies are tiny; don't let Nagle hold them back
+        void set_no_delay(const int fd) {
+            const int one {1};
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> resolve(const std::string& host, const int port, const bool passive) {
+            addrinfo hints {};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            if (passive) hints.ai_flags = AI_PASSIVE;
+
+            addrinfo* result {nullptr};
+            const std::string service {std::to_string(port)};
+            if (const int rc {::getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result)}; rc != 0) {
+                throw std::runtime_error("cannot resolve " + host + ": " + ::gai_strerror(rc));
+            }
+            return {result, &::freeaddrinfo};
+        }
+
+        // Cameras travel as hex floats so every worker traces exactly the coordinator's rays
+        std::string format_camera(const Camera& c) {
+            const float values[] {c.position.x, c.position.y, c.position.z, c.right.x, c.right.y, c.right.z,
+                                  c.up.x, c.up.y, c.up.z, c.forward.x, c.forward.y, c.forward.z,
+                                  c.viewport_width, c.viewport_height, c.projection_distance};
+            std::string text;
+            char buffer[32];
+            for (const float v : values) {
+                std::snprintf(buffer, sizeof(buffer), "%a", static_cast<double>(v));
+                if (!text.empty()) text += ',';
+                text += buffer;
+            }
+            return text;
+        }
+
+        Camera parse_camera(const std::string& text) {
+            float values[15];
+            const char* p {text.c_str()};
+            for (int i {0}; i < 15; ++i) {
+                char* end {nullptr};
+                values[i] = std::strtof(p, &end);
+                if (end == p || (i < 14 && *end != ',')) throw std::invalid_argument("malformed camera '" + text + "'");
+                p = end + (i < 14 ? 1 : 0);
+            }
+            if (*p != '\0') throw std::invalid_argument("malformed camera '" + text + "'");
+
+            Camera c;
+            c.position = {values[0], values[1], values[2]};
+            c.right = {values[3], values[4], values[5]};
+            c.up = {values[6], values[7], values[8]};
+            c.forward = {values[9], values[10], values[11]};
+            c.viewport_width = values[12];
+            c.viewport_height = values[13];
+            c.projection_distance = values[14];
+            return c;
+        }
+
+        /// Blocking line reader over a socket (worker side).
+        class LineReader {
+            int fd;
+            std::string buffer;
+
+        public:
+            explicit LineReader(const int fd_) : fd(fd_) {}
+
+            /// Next line without its newline; nullopt once the peer closes.
+            std::optional<std::string> next() {
+                for (;;) {
+                    if (const std::size_t pos {buffer.find('\n')}; pos != std::string::npos) {
+                        std::string line {buffer.substr(0, pos)};
+                        buffer.erase(0, pos + 1);
+                        return line;
+                    }
+                    char chunk[4096];
+                    const ssize_t n {::recv(fd, chunk, sizeof(chunk), 0)};
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) return std::nullopt;
+                    buffer.append(chunk, static_cast<std::size_t>(n));
+                }
+            }
+        };
+
+        /// Coordinator-side state of one connected worker.
+        struct Connection {
+            Connection(const int fd_, const Clock::time_point connected) : fd(fd_), last_progress(connected) {}
+
+            int fd;
+            bool ready {false};
+            std::size_t threads {1};
+            std::string inbox;
+            std::vector<std::size_t> in_flight;          // tiles sent, oldest first
+            Clock::time_point last_progress;             // handshake, first assignment or last finished tile
+            std::optional<std::size_t> payload_tile;     // tile whose pixels are still arriving
+            std::size_t payload_bytes {0};
+        };
+    }
+
+    std::pair<std::string, int> parse_endpoint(const std::string& endpoint) {
+        const std::size_t colon {endpoint.rfind(':')};
+        if (colon == std::string::npos) throw std::invalid_argument("expected host:port but got '" + endpoint + "'");
+        std::string host {endpoint.substr(0, colon)};
+        const std::string port_text {endpoint.substr(colon + 1)};
+
+        std::size_t used {0};
+        const int port {std::stoi(port_text, &used)};
+        if (used != port_text.size() || port < 0 || port > 65535) throw std::invalid_argument("bad port in '" + endpoint + "'");
+        return {host.empty() ? "127.0.0.1" : std::move(host), port};
+    }
+
+    // -----------------------------------------------------------------------------
+    // Coordinator
+    // -----------------------------------------------------------------------------
+
+    TileCoordinator::TileCoordinator(const std::string& host, const int port_) {
+        const auto addresses {resolve(host, port_, true)};
+        for (const addrinfo* a {addresses.get()}; a != nullptr; a = a->ai_next) {
+            const int fd {::socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol)};
+            if (fd < 0) continue;
+            const int one {1};
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (::bind(fd, a->ai_addr, a->ai_addrlen) == 0 && ::listen(fd, 64) == 0) {
+                listen_fd = fd;
+                break;
+            }
+            ::close(fd);
+        }
+        if (listen_fd < 0) throw socket_error("cannot listen on " + host + ":" + std::to_string(port_));
+
+        sockaddr_storage bound {};
+        socklen_t length {sizeof(bound)};
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&bound), &length);
+        port = bound.ss_family == AF_INET6 ? ntohs(reinterpret_cast<const sockaddr_in6*>(&bound)->sin6_port)
+                                            : ntohs(reinterpret_cast<const sockaddr_in*>(&bound)->sin_port);
+    }
+
+    TileCoordinator::~TileCoordinator() {
+        if (listen_fd >= 0) ::close(listen_fd);
+    }
+
+    std::vector<RGB> TileCoordinator::render(const DistributedJob& job, DistributedStats* stats) {
+        const auto start {Clock::now()};
+        const std::vector<Tile> tiles {make_tiles(job.width, job.height, job.tile_size)};
+        std::vector<RGB> framebuffer(static_cast<std::size_t>(job.width) * job.height);
+
+        std::deque<std::size_t> queue;
+        for (std::size_t i {0}; i < tiles.size(); ++i) queue.push_back(i);
+        std::size_t remaining {tiles.size()};
+
+        DistributedStats local;
+        local.tiles = tiles.size();
+        DistributedStats& s {stats ? *stats : local};
+        s = local;
+
+        const std::string job_line {"job scene=" + job.scene_id + " size=" + std::to_string(job.width) + "x" +
+                                    std::to_string(job.height) + " camera=" + format_camera(job.camera)};
+
+        std::list<Connection> workers;
+        auto idle_since {Clock::now()};
+        std::string last_error;
+
+        // Close a worker; anything it still held goes back to the front of the queue
+        const auto drop = [&](const std::list<Connection>::iterator it) {
+            if (!it->in_flight.empty()) {
+                ++s.workers_lost;
+                s.tiles_reassigned += it->in_flight.size();
+                for (auto t {it->in_flight.rbegin()}; t != it->in_flight.rend(); ++t) queue.push_front(*t);
+            }
+            ::close(it->fd);
+            return workers.erase(it);
+        };
+
+        // Keep a ready worker at TILES_PER_THREAD tiles per thread
+        const auto top_up = [&](Connection& w) {
+            while (w.ready && w.in_flight.size() < TILES_PER_THREAD * w.threads && !queue.empty()) {
+                const std::size_t index {queue.front()};
+                const Tile& t {tiles[index]};
+                std::ostringstream command;
+                command << "tile " << index << " " << t.x0 << " " << t.y0 << " " << t.x1 << " " << t.y1;
+                if (!send_line(w.fd, command.str())) return false;
+                queue.pop_front();
+                if (w.in_flight.empty()) w.last_progress = Clock::now();
+                w.in_flight.push_back(index);
+            }
+            return true;
+        };
+
+        // Consume whatever has arrived; false on a protocol error or a worker-side error
+        const auto process_inbox = [&](Connection& w) {
+            for (;;) {
+                if (w.payload_tile) {
+                    if (w.inbox.size() < w.payload_bytes) return true;
+                    const std::size_t index {*w.payload_tile};
+                    const Tile& t {tiles[index]};
+                    const int tile_width {t.x1 - t.x0};
+                    const auto* bytes {reinterpret_cast<const unsigned char*>(w.inbox.data())};
+                    for (int y {t.y0}; y < t.y1; ++y) {
+                        RGB* row {framebuffer.data() + static_cast<std::size_t>(y) * job.width + t.x0};
+                        for (int x {0}; x < tile_width; ++x, bytes += 3) row[x] = RGB(int{bytes[0]}, int{bytes[1]}, int{bytes[2]});
+                    }
+                    w.inbox.erase(0, w.payload_bytes);
+                    w.in_flight.erase(std::ranges::find(w.in_flight, index));
+                    w.payload_tile.reset();
+                    w.last_progress = Clock::now();
+                    --remaining;
+                    continue;
+                }
+
+                const std::size_t newline {w.inbox.find('\n')};
+                if (newline == std::string::npos) return true;
+                std::istringstream line(w.inbox.substr(0, newline));
+                w.inbox.erase(0, newline + 1);
+
+                std::string command;
+                line >> command;
+                if (command == "ready" && !w.ready) {
+                    std::size_t threads {0};
+                    if (!(line >> threads) || threads == 0) return false;
+                    w.ready = true;
+                    w.threads = threads;
+                    ++s.workers_seen;
+                } else if (command == "error") {
+                    std::getline(line >> std::ws, last_error);
+                    return false;
+                } else if (command == "tile" && w.ready) {
+                    std::size_t index {0}, bytes {0};
+                    if (!(line >> index >> bytes) || std::ranges::find(w.in_flight, index) == w.in_flight.end()) return false;
+                    const Tile& t {tiles[index]};
+                    if (bytes != static_cast<std::size_t>(t.x1 - t.x0) * static_cast<std::size_t>(t.y1 - t.y0) * 3) return false;
+                    w.payload_tile = index;
+                    w.payload_bytes = bytes;
+                } else {
+                    return false;
+                }
+            }
+        };
+
+        try {
+            std::vector<pollfd> fds;
+            std::vector<std::list<Connection>::iterator> owners;
+            while (remaining > 0) {
+                fds.assign(1, pollfd{listen_fd, POLLIN, 0});
+                owners.clear();
+                for (auto it {workers.begin()}; it != workers.end(); ++it) {
+                    fds.push_back(pollfd{it->fd, POLLIN, 0});
+                    owners.push_back(it);
+                }
+
+                if (::poll(fds.data(), fds.size(), POLL_INTERVAL_MS) < 0 && errno != EINTR) throw socket_error("poll");
+                const auto now {Clock::now()};
+
+                if (fds[0].revents & POLLIN) {
+                    if (const int fd {::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC)}; fd >= 0) {
+                        set_no_delay(fd);
+                        if (send_line(fd, job_line)) {
+                            workers.emplace_back(fd, now);
+                        } else {
+                            ::close(fd);
+                        }
+                    }
+                }
+
+                for (std::size_t i {1}; i < fds.size(); ++i) {
+                    if (fds[i].revents == 0) continue;
+                    Connection& w {*owners[i - 1]};
+
+                    char chunk[65536];
+                    const ssize_t n {::recv(w.fd, chunk, sizeof(chunk), 0)};
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) {
+                        drop(owners[i - 1]);
+                        continue;
+                    }
+                    w.inbox.append(chunk, static_cast<std::size_t>(n));
+                    if (!process_inbox(w) || !top_up(w)) drop(owners[i - 1]);
+                }
+
+                // Stalled workers (including ones stuck loading the scene) lose their tiles
+                for (auto it {workers.begin()}; it != workers.end();) {
+                    const bool waiting {!it->ready || !it->in_flight.empty()};
+                    it = waiting && now - it->last_progress > tile_timeout ? drop(it) : std::next(it);
+                }
+
+                // Tiles freed by a lost worker go to whoever has room
+                for (auto it {workers.begin()}; it != workers.end();) it = top_up(*it) ? std::next(it) : drop(it);
+
+                if (!workers.empty()) {
+                    idle_since = now;
+                } else if (!last_error.empty()) {
+                    throw std::runtime_error("worker failed: " + last_error);
+                } else if (now - idle_since > idle_timeout) {
+                    throw std::runtime_error("no workers connected for " + std::to_string(idle_timeout.count()) + " ms with " +
+                                             std::to_string(remaining) + " tiles left");
+                }
+            }
+        } catch (...) {
+            for (const Connection& w : workers) ::close(w.fd);
+            throw;
+        }
+
+        for (const Connection& w : workers) {
+            send_line(w.fd, "done");
+            ::close(w.fd);
+        }
+        s.elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return framebuffer;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Worker
+    // -----------------------------------------------------------------------------
+
+    std::size_t run_tile_worker(const std::string& host, const int port, const SceneCache::Loader& loader, ThreadPool& pool) {
+        Socket connection {-1};
+        const auto addresses {resolve(host, port, false)};
+        for (const addrinfo* a {addresses.get()}; a != nullptr && connection.fd < 0; a = a->ai_next) {
+            const int fd {::socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol)};
+            if (fd < 0) continue;
+            if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+                connection.fd = fd;
+            } else {
+                ::close(fd);
+            }
+        }
+        if (connection.fd < 0) throw socket_error("cannot connect to " + host + ":" + std::to_string(port));
+        const int fd {connection.fd};
+        set_no_delay(fd);
+
+        // Job: scene, size and camera, once per connection
+        LineReader reader(fd);
+        const std::optional<std::string> job_line {reader.next()};
+        if (!job_line) throw std::runtime_error("coordinator closed the connection before sending a job");
+
+        std::string scene_id;
+        int width {0}, height {0};
+        Camera camera;
+        std::shared_ptr<const Scene> scene;
+        try {
+            std::istringstream ls(*job_line);
+            std::string command;
+            ls >> command;
+            if (command != "job") throw std::invalid_argument("expected a job but got '" + *job_line + "'");
+            for (std::string token; ls >> token;) {
+                const std::size_t eq {token.find('=')};
+                const std::string key {token.substr(0, eq)};
+                const std::string value {eq == std::string::npos ? "" : token.substr(eq + 1)};
+                if (key == "scene") {
+                    scene_id = value;
+                } else if (key == "size") {
+                    char x;
+                    std::istringstream ss(value);
+                    if (!(ss >> width >> x >> height) || x != 'x' || width <= 0 || height <= 0) throw std::invalid_argument("bad size '" + value + "'");
+                } else if (key == "camera") {
+                    camera = parse_camera(value);
+                }
+            }
+            scene = loader(scene_id);
+        } catch (const std::exception& e) {
+            send_line(fd, std::string("error ") + e.what());
+            throw;
+        }
+
+        // The pool's threads trace; this thread only reads commands
+        const std::size_t threads {std::max(1u, pool.size())};
+        if (!send_line(fd, "ready " + std::to_string(threads))) throw std::runtime_error("lost connection to coordinator");
+
+        std::mutex send_mutex;
+        std::mutex state_mutex;
+        std::condition_variable finished;
+        std::size_t outstanding {0};
+        std::size_t rendered {0};
+        bool broken {false};
+
+        const auto render_one = [&](const std::size_t index, const Tile tile) {
+            thread_local std::vector<RGB> rows;
+            const int tile_width {tile.x1 - tile.x0};
+            rows.resize(static_cast<std::size_t>(tile.y1 - tile.y0) * width);
+            render_tile(*scene, camera, width, height, tile, rows.data(), tile.y0);
+
+            // Header and packed pixels go out in one write
+            std::string message {"tile " + std::to_string(index) + " " +
+                                 std::to_string(static_cast<std::size_t>(tile_width) * (tile.y1 - tile.y0) * 3) + "\n"};
+            const std::size_t header {message.size()};
+            message.resize(header + static_cast<std::size_t>(tile_width) * (tile.y1 - tile.y0) * 3);
+            auto* bytes {reinterpret_cast<unsigned char*>(message.data() + header)};
+            for (int y {tile.y0}; y < tile.y1; ++y, bytes += 3 * tile_width) {
+                const RGB* row {rows.data() + static_cast<std::size_t>(y - tile.y0) * width + tile.x0};
+                Kernels::active().tonemap_rgb8(reinterpret_cast<const int*>(row), static_cast<std::size_t>(tile_width), bytes);
+            }
+
+            bool sent {false};
+            {
+                std::lock_guard lock(send_mutex);
+                sent = send_all(fd, message.data(), message.size());
+            }
+            {
+                std::lock_guard lock(state_mutex);
+                --outstanding;
+                if (sent) ++rendered; else broken = true;
+            }
+            finished.notify_all();
+        };
+
+        bool done {false};
+        while (const std::optional<std::string> line {reader.next()}) {
+            if (*line == "done") {
+                done = true;
+                break;
+            }
+
+            std::istringstream ls(*line);
+            std::string command;
+            std::size_t index {0};
+            Tile tile {};
+            if (!(ls >> command >> index >> tile.x0 >> tile.y0 >> tile.x1 >> tile.y1) || command != "tile" ||
+                tile.x0 < 0 || tile.y0 < 0 || tile.x1 > width || tile.y1 > height || tile.x0 >= tile.x1 || tile.y0 >= tile.y1) {
+                break;
+            }
+
+            {
+                std::lock_guard lock(state_mutex);
+                if (broken) break;
+                ++outstanding;
+            }
+            if (pool.size() == 0) {
+                render_one(index, tile);
+            } else {
+                pool.submit([&render_one, index, tile] { render_one(index, tile); });
+            }
+        }
+
+        // Tasks reference this frame; never return before they finish
+        std::unique_lock lock(state_mutex);
+        finished.wait(lock, [&] { return outstanding == 0; });
+        if (!done || broken) throw std::runtime_error("lost connection to coordinator");
+        return rendered;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_DISTRIBUTEDRENDERER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_DISTRIBUTEDRENDERER_HPP
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "RayTracing/Renderer.hpp"
+#include "RayTracing/SceneCache.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /// One frame to be split over worker processes. Workers resolve scene_id with their own loader.
+    struct DistributedJob {
+        std::string scene_id {"default"};
+        int width {600};
+        int height {600};
+        Camera camera;
+        int tile_size {32};
+    };
+
+    struct DistributedStats {
+        std::size_t tiles {0};
+        std::size_t workers_seen {0};       // workers that completed the handshake
+        std::size_t workers_lost {0};       // disconnected or timed out with tiles outstanding
+        std::size_t tiles_reassigned {0};
+        double elapsed_ms {0.0};
+    };
+
+    /**
+     * @brief Coordinator side of a multi-process render over TCP.
+     *
+     * Workers connect to the listening socket at any time, including mid-frame.
+     * Each one is sent the job once, loads the scene and reports how many
+     * threads it renders with; it is then kept at two tiles in flight per
+     * thread so it never waits for the next assignment. Finished tiles come
+     * back as packed 8-bit RGB and are copied into the frame.
+     *
+     * A worker that disconnects, or holds tiles without finishing any for
+     * tile_timeout, is dropped and its outstanding tiles go back to the front
+     * of the queue. Protocol, one text line per message:
+     *
+     *   coordinator -> worker   job scene=<id> size=WxH camera=<15 floats>
+     *                           tile <index> <x0> <y0> <x1> <y1>
+     *                           done
+     *   worker -> coordinator   ready <threads>  |  error <message>
+     *                           tile <index> <bytes>, then <bytes> of RGB8 (tile rows, left to right)
+     */
+    class TileCoordinator {
+    public:
+        /// Bind and listen on host:port; port 0 picks a free port (see get_port()).
+        explicit TileCoordinator(const std::string& host = "127.0.0.1", int port = 0);
+        ~TileCoordinator();
+
+        TileCoordinator(const TileCoordinator&) = delete;
+        TileCoordinator& operator=(const TileCoordinator&) = delete;
+
+        int get_port() const { return port; }
+
+        /// Drop a worker that holds tiles but finishes none for this long (default 30 s).
+        void set_tile_timeout(const std::chrono::milliseconds timeout) { tile_timeout = timeout; }
+
+        /// Give up when no worker has been connected for this long (default 30 s).
+        void set_idle_timeout(const std::chrono::milliseconds timeout) { idle_timeout = timeout; }
+
+        /**
+         * @brief Hand out every tile of job until the frame is complete.
+         *
+         * @throws std::runtime_error when no worker is left (idle timeout, or the
+         *         last worker reported an error such as an unknown scene).
+         */
+        std::vector<RGB> render(const DistributedJob& job, DistributedStats* stats = nullptr);
+
+    private:
+        int listen_fd {-1};
+        int port {0};
+        std::chrono::milliseconds tile_timeout {30000};
+        std::chrono::milliseconds idle_timeout {30000};
+    };
+
+    /**
+     * @brief Worker side: connect to a coordinator and render tiles until it says done.
+     *
+     * The scene is loaded once per connection; tiles are traced concurrently on
+     * the pool and their pixels sent back as soon as each one finishes.
+     *
+     * @return Number of tiles rendered.
+     * @throws std::runtime_error when the connection cannot be made or breaks.
+     */
+    std::size_t run_tile_worker(const std::string& host, int port, const SceneCache::Loader& loader, ThreadPool& pool);
+
+    /// Split "host:port" (the host may be empty, meaning 127.0.0.1). @throws std::invalid_argument
+    std::pair<std::string, int> parse_endpoint(const std::string& endpoint);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_DISTRIBUTEDRENDERER_HPP
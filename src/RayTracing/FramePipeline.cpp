@@ -0,0 +1,97 @@
+#include "RayTracing/FramePipeline.hpp"
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "RayTracing/ImageWriter.hpp"
+#include "Utilities/BoundedQueue.hpp"
+
+namespace RayTracing {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        double ms_since(const Clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        struct TracedFrame {
+            Frame frame;
+            std::vector<RGB> pixels;
+        };
+    }
+
+    PipelineStats render_sequence(const FrameSource& source, const int width, const int height, ThreadPool& pool, const std::size_t queue_depth,
+                                  const std::optional<ReprojectionSettings>& reprojection) {
+        const Clock::time_point start {Clock::now()};
+        PipelineStats stats;
+
+        BoundedQueue<Frame> to_trace(queue_depth);
+        BoundedQueue<TracedFrame> to_write(queue_depth);
+        std::exception_ptr update_error, trace_error, write_error;
+
+        // Stage 1: scene update
+        std::thread updater([&] {
+            try {
+                for (std::size_t i {0};; ++i) {
+                    const Clock::time_point t0 {Clock::now()};
+                    std::optional<Frame> frame {source(i)};
+                    stats.update_ms += ms_since(t0);
+                    if (!frame || !to_trace.push(std::move(*frame))) break;
+                }
+            } catch (...) {
+                update_error = std::current_exception();
+            }
+            to_trace.close();
+        });
+
+        // Stage 3: quantise, encode and write
+        std::thread writer([&] {
+            try {
+                while (std::optional<TracedFrame> traced {to_write.pop()}) {
+                    const Clock::time_point t0 {Clock::now()};
+                    save_image(traced->frame.output, traced->pixels, width, height);
+                    stats.write_ms += ms_since(t0);
+                    ++stats.frames;
+                }
+            } catch (...) {
+                write_error = std::current_exception();
+                to_write.close();
+            }
+        });
+
+        // Stage 2: trace, on the calling thread so it can drive the pool
+        try {
+            std::optional<TemporalReprojector> reprojector;
+            if (reprojection) reprojector.emplace(width, height, *reprojection);
+            while (std::optional<Frame> frame {to_trace.pop()}) {
+                const Clock::time_point t0 {Clock::now()};
+                std::vector<RGB> pixels;
+                if (reprojector) {
+                    pixels = reprojector->render(frame->scene, frame->camera, pool);
+                    stats.traced_pixels += reprojector->get_last_stats().traced();
+                    stats.reused_pixels += reprojector->get_last_stats().reused;
+                } else {
+                    pixels = render(*frame->scene, frame->camera, width, height, pool);
+                    stats.traced_pixels += pixels.size();
+                }
+                stats.trace_ms += ms_since(t0);
+                if (!to_write.push({std::move(*frame), std::move(pixels)})) break;
+            }
+        } catch (...) {
+            trace_error = std::current_exception();
+        }
+
+        // Unblock whichever neighbour is still waiting on us
+        to_trace.close();
+        to_write.close();
+        updater.join();
+        writer.join();
+
+        for (const std::exception_ptr& error : {update_error, trace_error, write_error}) {
+            if (error) std::rethrow_exception(error);
+        }
+        stats.wall_ms = ms_since(start);
+        return stats;
+    }
+}
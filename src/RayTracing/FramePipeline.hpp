@@ -0,0 +1,54 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_FRAMEPIPELINE_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_FRAMEPIPELINE_HPP
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "RayTracing/TemporalReprojector.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /// Everything needed to trace and store one frame of a sequence.
+    struct Frame {
+        std::size_t index {0};
+        std::shared_ptr<const Scene> scene;
+        Camera camera;
+        std::string output;
+    };
+
+    /// Scene update stage: builds frame index, or returns nullopt after the last frame.
+    using FrameSource = std::function<std::optional<Frame>(std::size_t index)>;
+
+    /// Busy time per stage; with overlap, wall_ms approaches the slowest stage rather than the sum.
+    struct PipelineStats {
+        std::size_t frames {0};
+        double update_ms {0.0};
+        double trace_ms {0.0};
+        double write_ms {0.0};
+        double wall_ms {0.0};
+        std::size_t traced_pixels {0};
+        std::size_t reused_pixels {0};      // taken from the previous frame (with reprojection only)
+    };
+
+    /**
+     * @brief Render an image sequence with update, trace and write overlapped.
+     *
+     * Three stages run concurrently: a thread calling source for frame N+1,
+     * the calling thread tracing frame N on the pool, and a thread quantising
+     * and writing frame N-1 with save_image. Stages are joined by bounded
+     * queues of queue_depth frames, so a slow disk stalls tracing instead of
+     * piling up framebuffers. An exception in any stage stops the pipeline and
+     * is rethrown here.
+     *
+     * With reprojection, frames are traced by a TemporalReprojector, so
+     * pixels whose previous shading still holds are reused instead of traced.
+     */
+    PipelineStats render_sequence(const FrameSource& source, int width, int height, ThreadPool& pool, std::size_t queue_depth = 2,
+                                  const std::optional<ReprojectionSettings>& reprojection = std::nullopt);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_FRAMEPIPELINE_HPP
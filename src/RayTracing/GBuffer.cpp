@@ -0,0 +1,170 @@
+#include "RayTracing/GBuffer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace RayTracing {
+
+    using namespace glm;
+
+    namespace {
+        using ObjectIds = std::unordered_map<const Objects::IRenderable*, std::uint32_t>;
+
+        // Follow one camera ray exactly like trace_ray does, recording instead of shading
+        GBuffer::Pixel record_chain(Ray ray, const Scene& scene, const ObjectSet& candidates, const ObjectIds& ids, std::vector<GBuffer::Hit>& out) {
+            GBuffer::Pixel pixel {static_cast<std::uint32_t>(out.size()), 0, GBuffer::Terminal::None};
+            float t_min {1.0f};
+
+            for (int depth {0};; ++depth) {
+                if (depth > MAX_RECURSION_DEPTH) {
+                    pixel.terminal = GBuffer::Terminal::Black;
+                    return pixel;
+                }
+
+                float closest_t {INFINITY};
+                std::shared_ptr<Objects::IRenderable> closest_object {nullptr};
+                // Primary ray: tile candidates; bounces: whole scene
+                closest_interaction(ray, t_min, INFINITY, depth == 0 ? candidates : scene.get_object_set(), closest_t, closest_object);
+
+                if (closest_object == nullptr) {
+                    pixel.terminal = GBuffer::Terminal::Background;
+                    return pixel;
+                }
+
+                const vec3 P {ray.at(closest_t)};
+                const vec3 N {closest_object->normal_at(P)};
+                out.push_back({P, N, -ray.get_direction(), ids.at(closest_object.get())});
+                ++pixel.hit_count;
+
+                if (closest_object->get_reflectivity() <= 0) return pixel;
+
+                const vec3 R {normalize(reflect(ray.get_direction(), N))};
+                ray = Ray(P + R * EPS, R);
+                t_min = EPS;
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------------------
+    // G-buffer pass
+    // -----------------------------------------------------------------------------
+
+    GBuffer GBuffer::build(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool, const int tile_size) {
+        if (scene.needs_sampling()) throw std::invalid_argument("G-buffers cannot hold area lights or glossy reflections");
+        GBuffer gbuffer;
+        gbuffer.width = width;
+        gbuffer.height = height;
+        // Charged up front as one hit per pixel, corrected once the chains are known
+        const std::size_t pixel_count {static_cast<std::size_t>(width) * height};
+        gbuffer.charge = Memory::Charge(Memory::Subsystem::Pixels, pixel_count * (sizeof(Pixel) + sizeof(Hit)), "G-buffer");
+        gbuffer.pixels.resize(pixel_count);
+
+        ObjectIds ids;
+        const auto& objects {scene.get_objects()};
+        for (std::uint32_t i {0}; i < objects.size(); ++i) ids.emplace(objects[i].get(), i);
+
+        // Tiles record into private hit lists, which are then stitched together
+        const std::vector<Tile> tiles {make_tiles(width, height, tile_size)};
+        std::vector<std::vector<Hit>> tile_hits(tiles.size());
+
+        pool.parallel_for(tiles.size(), [&](const std::size_t t) {
+            const Tile& tile {tiles[t]};
+            std::vector<Hit>& local {tile_hits[t]};
+            local.reserve(static_cast<std::size_t>(tile.x1 - tile.x0) * (tile.y1 - tile.y0));
+
+            ObjectSet culled;
+            const ObjectSet& candidates {cull_for_tile(scene, camera, width, height, tile, culled)};
+
+            for (int y {tile.y0}; y < tile.y1; ++y) {
+                const int y_canvas {height / 2 - y};
+                for (int x {tile.x0}; x < tile.x1; ++x) {
+                    const int x_canvas {x - width / 2};
+                    const vec3 direction {normalize(camera.direction(x_canvas, y_canvas, width, height))};
+                    gbuffer.pixels[static_cast<std::size_t>(y) * width + x] = record_chain(Ray(camera.position, direction), scene, candidates, ids, local);
+                }
+            }
+        });
+
+        std::vector<std::uint32_t> offsets(tiles.size() + 1, 0);
+        for (std::size_t t {0}; t < tiles.size(); ++t) offsets[t + 1] = offsets[t] + static_cast<std::uint32_t>(tile_hits[t].size());
+        gbuffer.charge = Memory::Charge();
+        gbuffer.charge = Memory::Charge(Memory::Subsystem::Pixels, gbuffer.memory_bytes() + offsets.back() * sizeof(Hit), "G-buffer");
+        gbuffer.hits.resize(offsets.back());
+
+        pool.parallel_for(tiles.size(), [&](const std::size_t t) {
+            const Tile& tile {tiles[t]};
+            std::ranges::copy(tile_hits[t], gbuffer.hits.begin() + offsets[t]);
+            for (int y {tile.y0}; y < tile.y1; ++y) {
+                for (int x {tile.x0}; x < tile.x1; ++x) {
+                    gbuffer.pixels[static_cast<std::size_t>(y) * width + x].first_hit += offsets[t];
+                }
+            }
+            std::vector<Hit>().swap(tile_hits[t]);
+        });
+
+        return gbuffer;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Relight pass
+    // -----------------------------------------------------------------------------
+
+    /**
+     * All hits are lit first with the batch kernel, then chains are composed
+     * back to front with the same RGB arithmetic as trace_ray. shade_batch
+     * matches compute_lighting bit for bit, so the result matches a full
+     * render bit for bit.
+     */
+    std::vector<RGB> GBuffer::relight(const Scene& scene, ThreadPool& pool) const {
+        if (scene.needs_sampling()) throw std::invalid_argument("G-buffers cannot be relit with area lights");
+        std::vector<RGB> framebuffer(pixels.size());
+        const auto& objects {scene.get_objects()};
+        const Kernels::KernelTable& kernels {Kernels::active()};
+        const Kernels::LightSoA lights {scene.light_soa()};
+
+        // Gather hits into SoA batches (stack buffers, no allocation per batch)
+        constexpr std::size_t BATCH {512};
+        const Memory::Charge charge(Memory::Subsystem::Pixels, hits.size() * sizeof(float), "relight intensities");
+        std::vector<float> intensity(hits.size());
+        pool.parallel_for((hits.size() + BATCH - 1) / BATCH, [&](const std::size_t b) {
+            const std::size_t first {b * BATCH};
+            const std::size_t n {std::min(BATCH, hits.size() - first)};
+            float px[BATCH], py[BATCH], pz[BATCH], nx[BATCH], ny[BATCH], nz[BATCH], vx[BATCH], vy[BATCH], vz[BATCH];
+            int shininess[BATCH];
+            for (std::size_t i {0}; i < n; ++i) {
+                const Hit& hit {hits[first + i]};
+                px[i] = hit.position.x; py[i] = hit.position.y; pz[i] = hit.position.z;
+                nx[i] = hit.normal.x; ny[i] = hit.normal.y; nz[i] = hit.normal.z;
+                vx[i] = hit.view.x; vy[i] = hit.view.y; vz[i] = hit.view.z;
+                shininess[i] = objects[hit.object_id]->get_material().specular;
+            }
+            kernels.shade_batch({px, py, pz, nx, ny, nz, vx, vy, vz, shininess, n}, lights, intensity.data() + first);
+        });
+
+        pool.parallel_for(static_cast<std::size_t>(height), [&](const std::size_t y) {
+            for (std::size_t i {y * width}; i < (y + 1) * width; ++i) {
+                const Pixel& pixel {pixels[i]};
+
+                RGB color {pixel.terminal == Terminal::Black ? BLACK : BACKGROUND_COLOR};
+                bool has_tail {pixel.terminal != Terminal::None};
+
+                for (int k {pixel.hit_count - 1}; k >= 0; --k) {
+                    const std::uint32_t h {pixel.first_hit + static_cast<std::uint32_t>(k)};
+                    const Objects::Material& material {objects[hits[h].object_id]->get_material()};
+                    RGB local_color {material.color * intensity[h]};
+
+                    if (has_tail) {
+                        const float reflectivity {material.reflectivity};
+                        local_color = local_color * (1.0f - reflectivity) + color * reflectivity;
+                    }
+                    color = local_color;
+                    has_tail = true;
+                }
+                framebuffer[i] = color;
+            }
+        });
+
+        return framebuffer;
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_GBUFFER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_GBUFFER_HPP
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "Utilities/MemoryAccounting.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief Per-pixel hit records for deferred shading and fast relighting.
+     *
+     * Each pixel stores its primary hit and the chain of mirror bounces that
+     * trace_ray would follow (up to MAX_RECURSION_DEPTH). The tracer casts no
+     * shadow rays, so lighting never depends on visibility and relight() gives
+     * the same image as a full render with the scene's current lights, without
+     * intersecting anything.
+     *
+     * Geometry and reflectivity are baked into the chains; colors, specular
+     * exponents and lights may change between relights. Area lights and glossy
+     * materials need shadow rays and sampled lobes, so scenes with them are
+     * rejected (std::invalid_argument).
+     */
+    class GBuffer {
+    public:
+        struct Hit {
+            glm::vec3 position;
+            glm::vec3 normal;
+            glm::vec3 view;              // unit vector back along the incoming ray
+            std::uint32_t object_id;     // index into Scene::get_objects()
+        };
+
+        /// What the chain ends in after its last reflective hit.
+        enum class Terminal : std::uint8_t { None, Background, Black };
+
+        struct Pixel {
+            std::uint32_t first_hit;     // index into hits
+            std::uint8_t hit_count;
+            Terminal terminal;
+        };
+
+        /// Trace all primary and reflection rays once and record the hit chains. @throws Memory::BudgetExceeded
+        static GBuffer build(const Scene& scene, const Camera& camera, int width, int height, ThreadPool& pool, int tile_size = 32);
+
+        /// Shade the recorded chains with the scene's current lights and materials.
+        std::vector<RGB> relight(const Scene& scene, ThreadPool& pool) const;
+
+        // Getters
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+        const std::vector<Pixel>& get_pixels() const { return pixels; }
+        const std::vector<Hit>& get_hits() const { return hits; }
+        std::size_t memory_bytes() const { return pixels.size() * sizeof(Pixel) + hits.size() * sizeof(Hit); }
+
+    private:
+        int width {0};
+        int height {0};
+        std::vector<Pixel> pixels;
+        std::vector<Hit> hits;
+        Memory::Charge charge;
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_GBUFFER_HPP
@@ -0,0 +1,217 @@
+#include "RayTracing/ImageWriter.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include "RayTracing/RayTracing.hpp"
+#include "Utilities/Kernels.hpp"
+
+namespace RayTracing {
+
+    namespace {
+        // QOI ops (https://qoiformat.org/qoi-specification.pdf)
+        constexpr unsigned char QOI_OP_INDEX {0x00};
+        constexpr unsigned char QOI_OP_DIFF  {0x40};
+        constexpr unsigned char QOI_OP_LUMA  {0x80};
+        constexpr unsigned char QOI_OP_RUN   {0xc0};
+        constexpr unsigned char QOI_OP_RGB   {0xfe};
+        constexpr int QOI_MAX_RUN {62};
+        constexpr std::size_t QOI_HEADER_SIZE {14};
+        constexpr std::array<unsigned char, 4> QOI_MAGIC {'q', 'o', 'i', 'f'};
+        constexpr std::array<unsigned char, 8> QOI_END {0, 0, 0, 0, 0, 0, 0, 1};
+
+        // Opaque pixel packed as r | g << 8 | b << 16 | 255 << 24
+        using Pixel = std::uint32_t;
+        constexpr Pixel QOI_START_PIXEL {0xff000000u};  // r = g = b = 0, a = 255
+
+        Pixel pack(const unsigned char* rgb) {
+            return rgb[0] | (Pixel{rgb[1]} << 8) | (Pixel{rgb[2]} << 16) | 0xff000000u;
+        }
+
+        unsigned slot_of(const Pixel p) {
+            return ((p & 0xff) * 3 + ((p >> 8) & 0xff) * 5 + ((p >> 16) & 0xff) * 7 + 255 * 11) % 64;
+        }
+
+        // Decoder state before a band: previous pixel and the colour index
+        struct State {
+            Pixel previous {QOI_START_PIXEL};
+            std::array<Pixel, 64> index {};
+        };
+
+        // Last pixel per hash slot within one band (0 = slot not touched; real pixels are opaque so never 0)
+        std::array<Pixel, 64> band_slots(const unsigned char* rgb, const std::size_t pixels) {
+            std::array<Pixel, 64> slots {};
+            for (std::size_t i {0}; i < pixels; ++i) {
+                const Pixel p {pack(rgb + 3 * i)};
+                slots[slot_of(p)] = p;
+            }
+            return slots;
+        }
+
+        // Encode one band starting from state; appends to out and returns the number of bytes written
+        std::size_t encode_band(const unsigned char* rgb, const std::size_t pixels, State state, unsigned char* out) {
+            unsigned char* const begin {out};
+            int run {0};
+
+            for (std::size_t i {0}; i < pixels; ++i) {
+                const Pixel p {pack(rgb + 3 * i)};
+
+                if (p == state.previous) {
+                    if (++run == QOI_MAX_RUN) {
+                        *out++ = QOI_OP_RUN | (run - 1);
+                        run = 0;
+                    }
+                    continue;
+                }
+                if (run > 0) {
+                    *out++ = QOI_OP_RUN | (run - 1);
+                    run = 0;
+                }
+
+                const unsigned slot {slot_of(p)};
+                if (state.index[slot] == p) {
+                    *out++ = QOI_OP_INDEX | slot;
+                } else {
+                    state.index[slot] = p;
+
+                    const auto channel = [](const Pixel x, const int shift) { return static_cast<int>((x >> shift) & 0xff); };
+                    const auto wrap = [](const int d) { return static_cast<int>(static_cast<signed char>(d)); };
+                    const int dr {wrap(channel(p, 0) - channel(state.previous, 0))};
+                    const int dg {wrap(channel(p, 8) - channel(state.previous, 8))};
+                    const int db {wrap(channel(p, 16) - channel(state.previous, 16))};
+                    const int dr_dg {dr - dg};
+                    const int db_dg {db - dg};
+
+                    if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                        *out++ = QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2);
+                    } else if (dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 && db_dg > -9 && db_dg < 8) {
+                        *out++ = QOI_OP_LUMA | (dg + 32);
+                        *out++ = (dr_dg + 8) << 4 | (db_dg + 8);
+                    } else {
+                        *out++ = QOI_OP_RGB;
+                        *out++ = static_cast<unsigned char>(channel(p, 0));
+                        *out++ = static_cast<unsigned char>(channel(p, 8));
+                        *out++ = static_cast<unsigned char>(channel(p, 16));
+                    }
+                }
+                state.previous = p;
+            }
+            if (run > 0) *out++ = QOI_OP_RUN | (run - 1);
+            return static_cast<std::size_t>(out - begin);
+        }
+
+        void put_u32_be(unsigned char* out, const std::uint32_t v) {
+            out[0] = static_cast<unsigned char>(v >> 24);
+            out[1] = static_cast<unsigned char>(v >> 16);
+            out[2] = static_cast<unsigned char>(v >> 8);
+            out[3] = static_cast<unsigned char>(v);
+        }
+
+        void write_file(const std::string& filename, const std::vector<unsigned char>& bytes) {
+            std::ofstream ofs(filename, std::ios::binary);
+            ofs.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            ofs.close();
+            if (!ofs) throw std::runtime_error("failed to write " + filename);
+        }
+
+        std::string extension_of(const std::string& filename) {
+            const std::size_t dot {filename.find_last_of('.')};
+            if (dot == std::string::npos || filename.find('/', dot) != std::string::npos) return "";
+            std::string ext {filename.substr(dot + 1)};
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return ext;
+        }
+    }
+
+    std::vector<unsigned char> encode_qoi(std::span<const RGB> pixels, const int width, const int height, ThreadPool* pool) {
+        if (width <= 0 || height <= 0 || pixels.size() != static_cast<std::size_t>(width) * height) {
+            throw std::invalid_argument("pixel buffer does not match " + std::to_string(width) + "x" + std::to_string(height));
+        }
+
+        // Bands of whole rows, a few per thread
+        const std::size_t threads {pool ? static_cast<std::size_t>(pool->size()) + 1 : 1};
+        const std::size_t band_count {std::min<std::size_t>(height, 4 * threads)};
+        const std::size_t rows_per_band {(static_cast<std::size_t>(height) + band_count - 1) / band_count};
+        const std::size_t band_pixels {rows_per_band * width};
+        const auto band_begin = [&](const std::size_t band) { return std::min(band * band_pixels, pixels.size()); };
+        const auto for_each_band = [&](const std::function<void(std::size_t)>& body) {
+            if (pool) {
+                pool->parallel_for(band_count, body);
+            } else {
+                for (std::size_t band {0}; band < band_count; ++band) body(band);
+            }
+        };
+
+        // Pass 1: quantise to bytes and record each band's last pixel per hash slot
+        static_assert(sizeof(RGB) == 3 * sizeof(int), "RGB must be three packed ints");
+        const std::unique_ptr<unsigned char[]> rgb {std::make_unique_for_overwrite<unsigned char[]>(pixels.size() * 3)};
+        std::vector<std::array<Pixel, 64>> slots(band_count);
+        for_each_band([&](const std::size_t band) {
+            const std::size_t begin {band_begin(band)}, count {band_begin(band + 1) - begin};
+            Kernels::active().tonemap_rgb8(reinterpret_cast<const int*>(pixels.data() + begin), count, rgb.get() + 3 * begin);
+            slots[band] = band_slots(rgb.get() + 3 * begin, count);
+        });
+
+        // Decoder state at every band start (serial, 64 entries per band)
+        std::vector<State> states(band_count);
+        for (std::size_t band {1}; band < band_count; ++band) {
+            states[band] = states[band - 1];
+            for (std::size_t s {0}; s < 64; ++s) {
+                if (slots[band - 1][s] != 0) states[band].index[s] = slots[band - 1][s];
+            }
+            if (band_begin(band) > 0) states[band].previous = pack(rgb.get() + 3 * (band_begin(band) - 1));
+        }
+
+        // Pass 2: encode bands into uninitialised worst-case scratch (4 bytes per pixel)
+        std::vector<std::unique_ptr<unsigned char[]>> encoded(band_count);
+        std::vector<std::size_t> encoded_size(band_count);
+        for_each_band([&](const std::size_t band) {
+            const std::size_t begin {band_begin(band)}, count {band_begin(band + 1) - begin};
+            encoded[band] = std::make_unique_for_overwrite<unsigned char[]>(4 * count);
+            encoded_size[band] = encode_band(rgb.get() + 3 * begin, count, states[band], encoded[band].get());
+        });
+
+        // Stitch
+        std::size_t total {QOI_HEADER_SIZE + QOI_END.size()};
+        for (const std::size_t size : encoded_size) total += size;
+
+        std::vector<unsigned char> out;
+        out.reserve(total);
+        out.resize(QOI_HEADER_SIZE);
+        std::copy(QOI_MAGIC.begin(), QOI_MAGIC.end(), out.begin());
+        put_u32_be(out.data() + 4, static_cast<std::uint32_t>(width));
+        put_u32_be(out.data() + 8, static_cast<std::uint32_t>(height));
+        out[12] = 3;  // channels
+        out[13] = 0;  // sRGB with linear alpha
+        for (std::size_t band {0}; band < band_count; ++band) {
+            out.insert(out.end(), encoded[band].get(), encoded[band].get() + encoded_size[band]);
+        }
+        out.insert(out.end(), QOI_END.begin(), QOI_END.end());
+        return out;
+    }
+
+    void save_qoi(const std::string& filename, std::span<const RGB> pixels, const int width, const int height, ThreadPool* pool) {
+        write_file(filename, encode_qoi(pixels, width, height, pool));
+    }
+
+    void save_image(const std::string& filename, std::span<const RGB> pixels, const int width, const int height, ThreadPool* pool) {
+        const std::string ext {extension_of(filename)};
+        if (ext == "qoi") {
+            save_qoi(filename, pixels, width, height, pool);
+        } else if (ext == "ppm") {
+            save_ppm_binary(filename, pixels, width, height);
+        } else {
+            throw std::invalid_argument("unsupported image format for '" + filename + "' (expected .ppm or .qoi)");
+        }
+    }
+
+    std::string with_suffix(const std::string& filename, const std::string& suffix) {
+        const std::size_t dot {filename.find_last_of('.')};
+        if (dot == std::string::npos || filename.find('/', dot) != std::string::npos) return filename + suffix;
+        return filename.substr(0, dot) + suffix + filename.substr(dot);
+    }
+}
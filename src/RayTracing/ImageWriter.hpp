@@ -0,0 +1,32 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_IMAGEWRITER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_IMAGEWRITER_HPP
+#include <span>
+#include <string>
+#include <vector>
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief Encode pixels as a QOI ("Quite OK Image") stream, 3 channels, sRGB.
+     *
+     * Rows are split into bands that are quantised and encoded in parallel on
+     * pool (serially if pool is null). QOI's decoder state before any pixel
+     * depends only on earlier pixels (the previous pixel and, per hash slot,
+     * the last pixel that hashed there), so each band's start state is built
+     * from cheap per-band slot tables instead of encoding the prefix. Runs are
+     * simply cut at band boundaries. The result is a single valid stream.
+     */
+    std::vector<unsigned char> encode_qoi(std::span<const RGB> pixels, int width, int height, ThreadPool* pool = nullptr);
+
+    void save_qoi(const std::string& filename, std::span<const RGB> pixels, int width, int height, ThreadPool* pool = nullptr);
+
+    /// Write .qoi or .ppm by the filename's extension; throws std::invalid_argument for anything else.
+    void save_image(const std::string& filename, std::span<const RGB> pixels, int width, int height, ThreadPool* pool = nullptr);
+
+    /// filename with suffix inserted before its extension ("out.qoi", "_relit" -> "out_relit.qoi").
+    std::string with_suffix(const std::string& filename, const std::string& suffix);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_IMAGEWRITER_HPP
@@ -0,0 +1,92 @@
+#include "RayTracing/ProgressiveRenderer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace RayTracing {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        bool on_grid(const int x, const int y, const int stride) {
+            return x % stride == 0 && y % stride == 0;
+        }
+
+        int first_on_grid(const int from, const int stride) {
+            return (from + stride - 1) / stride * stride;
+        }
+
+        // Trace the tile's pixels on this level's grid that the coarser grid (0: none) has not
+        std::size_t trace_level_tile(const Scene& scene, const Camera& camera, const int width, const int height, const Tile& tile,
+                                     const int stride, const int coarser, RGB* framebuffer) {
+            ObjectSet culled;
+            const ObjectSet& candidates {cull_for_tile(scene, camera, width, height, tile, culled)};
+
+            std::size_t traced {0};
+            for (int y {first_on_grid(tile.y0, stride)}; y < tile.y1; y += stride) {
+                RGB* row {framebuffer + static_cast<std::size_t>(y) * width};
+                for (int x {first_on_grid(tile.x0, stride)}; x < tile.x1; x += stride) {
+                    if (coarser > 0 && on_grid(x, y, coarser)) continue;
+                    row[x] = trace_pixel(scene, candidates, camera, width, height, x, y);
+                    ++traced;
+                }
+            }
+            return traced;
+        }
+
+        // Bilinear fill of row y's off-grid pixels from the four surrounding samples (held constant past the last one)
+        void fill_row(const int width, const int height, const int stride, const int y, RGB* framebuffer) {
+            const int y0 {y - y % stride};
+            const int y1 {std::min(y0 + stride, (height - 1) / stride * stride)};
+            const float fy {y1 > y0 ? static_cast<float>(y - y0) / static_cast<float>(stride) : 0.0f};
+            const RGB* top {framebuffer + static_cast<std::size_t>(y0) * width};
+            const RGB* bottom {framebuffer + static_cast<std::size_t>(y1) * width};
+            RGB* row {framebuffer + static_cast<std::size_t>(y) * width};
+            const int last_x {(width - 1) / stride * stride};
+
+            for (int x {0}; x < width; ++x) {
+                if (on_grid(x, y, stride)) continue;
+                const int x0 {x - x % stride};
+                const int x1 {std::min(x0 + stride, last_x)};
+                const float fx {x1 > x0 ? static_cast<float>(x - x0) / static_cast<float>(stride) : 0.0f};
+
+                const float w00 {(1.0f - fx) * (1.0f - fy)}, w10 {fx * (1.0f - fy)}, w01 {(1.0f - fx) * fy}, w11 {fx * fy};
+                const auto mix = [&](const int RGB::* channel) {
+                    return static_cast<int>(std::lround(w00 * static_cast<float>(top[x0].*channel) + w10 * static_cast<float>(top[x1].*channel)
+                                                      + w01 * static_cast<float>(bottom[x0].*channel) + w11 * static_cast<float>(bottom[x1].*channel)));
+                };
+                row[x] = RGB(mix(&RGB::r), mix(&RGB::g), mix(&RGB::b));
+            }
+        }
+    }
+
+    std::vector<RGB> render_progressive(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool,
+                                        const ProgressCallback& publish, const int tile_size) {
+        const Clock::time_point start {Clock::now()};
+        std::vector<RGB> framebuffer(static_cast<std::size_t>(width) * height);
+
+        int coarser {0};
+        int index {0};
+        for (const int stride : PROGRESSIVE_STRIDES) {
+            const std::vector<Tile> tiles {make_tiles(width, height, tile_size)};
+            std::atomic<std::size_t> traced {0};
+            pool.parallel_for(tiles.size(), [&](const std::size_t i) {
+                traced.fetch_add(trace_level_tile(scene, camera, width, height, tiles[i], stride, coarser, framebuffer.data()), std::memory_order_relaxed);
+            });
+            if (stride > 1) {
+                pool.parallel_for(static_cast<std::size_t>(height), [&](const std::size_t y) {
+                    fill_row(width, height, stride, static_cast<int>(y), framebuffer.data());
+                });
+            }
+
+            if (publish) {
+                const ProgressiveLevel level {index, stride, traced.load(), std::chrono::duration<double, std::milli>(Clock::now() - start).count()};
+                publish(level, framebuffer);
+            }
+            coarser = stride;
+            ++index;
+        }
+        return framebuffer;
+    }
+}
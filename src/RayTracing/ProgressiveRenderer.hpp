@@ -0,0 +1,41 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_PROGRESSIVERENDERER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_PROGRESSIVERENDERER_HPP
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /// Pixel spacing of the traced samples in each progressive level: 1/16, 1/4, then all pixels.
+    inline constexpr int PROGRESSIVE_STRIDES[] {4, 2, 1};
+
+    /// What a progressive level contributed, reported when it is published.
+    struct ProgressiveLevel {
+        int index {0};              // 0 is the coarsest
+        int stride {1};             // traced pixels are those with x % stride == 0 and y % stride == 0
+        std::size_t traced {0};     // pixels traced by this level (coarser levels' samples are reused)
+        double elapsed_ms {0.0};    // since the render started
+    };
+
+    /// Called on the rendering thread with each complete, upsampled image; keep it short or copy the pixels.
+    using ProgressCallback = std::function<void(const ProgressiveLevel& level, const std::vector<RGB>& framebuffer)>;
+
+    /**
+     * @brief render() that publishes a coarse image early and then refines it.
+     *
+     * Each level traces the pixels on its grid that no coarser level traced,
+     * then fills the others by bilinear interpolation between the traced
+     * samples, so every published image is complete. Every pixel is traced
+     * exactly once, at the same position render() uses: the total work is
+     * render()'s plus the cheap fills, and the last level is identical to
+     * render()'s image.
+     */
+    std::vector<RGB> render_progressive(const Scene& scene, const Camera& camera, int width, int height, ThreadPool& pool,
+                                        const ProgressCallback& publish, int tile_size = 32);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_PROGRESSIVERENDERER_HPP
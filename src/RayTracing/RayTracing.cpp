@@ -1,22 +1,399 @@
 #include "RayTracing.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <iostream>
 #include <glm/glm.hpp>
 #include <fstream>
+#include <exception>
+#include <stdexcept>
+#include <span>
+#include <string>
 
+#include <unordered_set>
 #include <utility>
+#include "Objects/Instance.hpp"
+#include "Objects/Quadric.hpp"
+#include "Objects/Sphere.hpp"
 namespace RayTracing {
 
     using namespace glm;
 
     // -----------------------------------------------------------------------------
-    // Constants / configuration
+    // Object sets
     // -----------------------------------------------------------------------------
 
-    static constexpr float EPS                  {1e-4};
-    static const RGB BLACK                      {0.0f, 0.0f, 0.0f};
-    static const RGB BACKGROUND_COLOR           {255, 255, 255};    // White background
-    static constexpr int MAX_RECURSION_DEPTH    {3};                // Max recursion for reflections
+    void ObjectSet::add(const std::shared_ptr<Objects::IRenderable>& object) {
+        if (const auto sphere {std::dynamic_pointer_cast<Objects::Sphere>(object)}) {
+            const vec3 c {sphere->get_center()};
+            spheres.push_back(object);
+            sphere_cx.push_back(c.x);
+            sphere_cy.push_back(c.y);
+            sphere_cz.push_back(c.z);
+            sphere_r2.push_back(sphere->get_radius() * sphere->get_radius());
+        } else if (const auto quadric {std::dynamic_pointer_cast<Objects::Quadric>(object)}) {
+            quadrics.push_back(object);
+            const Objects::Quadric::Fields& fields {quadric->get_fields()};
+            for (std::size_t k {0}; k < fields.size(); ++k) quadric_fields[k].push_back(fields[k]);
+            quadric_bounds.push_back(object->bounds());
+        } else {
+            other_objects.push_back(object);
+            other_bounds.push_back(object->bounds());
+        }
+    }
+
+    namespace {
+        PrimitiveKind kind_of(const Objects::IRenderable& object) {
+            if (dynamic_cast<const Objects::Sphere*>(&object) != nullptr) return PrimitiveKind::Sphere;
+            if (dynamic_cast<const Objects::Quadric*>(&object) != nullptr) return PrimitiveKind::Quadric;
+            return PrimitiveKind::Other;
+        }
+    }
+
+    void ObjectSet::build(const std::vector<std::shared_ptr<Objects::IRenderable>>& objects, ThreadPool* pool,
+                          const BvhBuildOptions& options, SceneBuildStats* stats_out) {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start {Clock::now()};
+        const auto ms_since = [](const Clock::time_point since) { return std::chrono::duration<double, std::milli>(Clock::now() - since).count(); };
+        clear();
+
+        SceneBuildStats stats;
+        stats.primitives = objects.size();
+        stats.threads = pool == nullptr ? 1 : pool->size() + 1;
+
+        std::vector<PrimitiveKind> kinds(objects.size());
+        std::vector<AABB> object_bounds(objects.size());
+        for_each_chunk(pool, objects.size(), 1024, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i {begin}; i < end; ++i) {
+                kinds[i] = kind_of(*objects[i]);
+                object_bounds[i] = objects[i]->bounds();
+            }
+        });
+        const auto bounded_count {static_cast<std::size_t>(std::count_if(object_bounds.begin(), object_bounds.end(), [](const AABB& box) { return box.is_finite(); }))};
+        stats.bounds_ms = ms_since(start);
+
+        // Arrays are sized exactly once, so the arena holds no dead copies
+        use_arena(std::make_shared<Memory::Arena>());
+        std::array<std::size_t, PRIMITIVE_KIND_COUNT> sizes {};
+        for (const PrimitiveKind kind : kinds) ++sizes[static_cast<std::size_t>(kind)];
+        reserve(sizes);
+
+        if (bounded_count < std::max<std::size_t>(2, options.min_primitives)) {
+            for (const auto& object : objects) add(object);
+        } else {
+            BvhLayout layout {build_bvh(object_bounds, kinds, pool, options, stats)};
+            const Clock::time_point layout_start {Clock::now()};
+
+            // Each kind's arrays in hierarchy order, written in parallel at precomputed slots
+            spheres.resize(sizes[0]);
+            for (auto* v : {&sphere_cx, &sphere_cy, &sphere_cz, &sphere_r2}) v->resize(sizes[0]);
+            quadrics.resize(sizes[1]);
+            for (auto& field : quadric_fields) field.resize(sizes[1]);
+            quadric_bounds.resize(sizes[1]);
+            other_objects.resize(sizes[2]);
+            other_bounds.resize(sizes[2]);
+
+            for_each_chunk(pool, objects.size(), 4096, [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t p {begin}; p < end; ++p) {
+                    const std::uint32_t source {layout.order[p]};
+                    const std::uint32_t slot {layout.slot[p]};
+                    const std::shared_ptr<Objects::IRenderable>& object {objects[source]};
+                    switch (kinds[source]) {
+                        case PrimitiveKind::Sphere: {
+                            const auto& sphere {static_cast<const Objects::Sphere&>(*object)};
+                            const vec3 c {sphere.get_center()};
+                            spheres[slot] = object;
+                            sphere_cx[slot] = c.x;
+                            sphere_cy[slot] = c.y;
+                            sphere_cz[slot] = c.z;
+                            sphere_r2[slot] = sphere.get_radius() * sphere.get_radius();
+                            break;
+                        }
+                        case PrimitiveKind::Quadric: {
+                            const Objects::Quadric::Fields& fields {static_cast<const Objects::Quadric&>(*object).get_fields()};
+                            quadrics[slot] = object;
+                            for (std::size_t k {0}; k < fields.size(); ++k) quadric_fields[k][slot] = fields[k];
+                            quadric_bounds[slot] = object_bounds[source];
+                            break;
+                        }
+                        case PrimitiveKind::Other:
+                            other_objects[slot] = object;
+                            other_bounds[slot] = object_bounds[source];
+                            break;
+                    }
+                }
+            });
+            bounded = layout.bounded;
+            stats.format = options.format;
+            if (options.format == BvhFormat::Wide) {
+                stats.layout_ms = ms_since(layout_start);
+                const Clock::time_point collapse_start {Clock::now()};
+                const WideBvh wide {collapse_bvh(layout.nodes)};
+                wide_hierarchy.reserve(wide.nodes.size());
+                wide_hierarchy.assign(wide.nodes.begin(), wide.nodes.end());
+                wide_leaves.reserve(wide.leaves.size());
+                wide_leaves.assign(wide.leaves.begin(), wide.leaves.end());
+                stats.nodes = wide.nodes.size();
+                stats.hierarchy_bytes = wide.nodes.size() * sizeof(WideBvhNode) + wide.leaves.size() * sizeof(BvhLeaf);
+                stats.collapse_ms = ms_since(collapse_start);
+            } else {
+                hierarchy.reserve(layout.nodes.size());
+                hierarchy.assign(layout.nodes.begin(), layout.nodes.end());
+                stats.hierarchy_bytes = layout.nodes.size() * sizeof(BvhNode);
+                stats.layout_ms = ms_since(layout_start);
+            }
+        }
+
+        stats.total_ms = ms_since(start);
+        if (stats_out != nullptr) *stats_out = stats;
+    }
+
+    void ObjectSet::add_sphere_from(const ObjectSet& other, const std::size_t i) {
+        spheres.push_back(other.spheres[i]);
+        sphere_cx.push_back(other.sphere_cx[i]);
+        sphere_cy.push_back(other.sphere_cy[i]);
+        sphere_cz.push_back(other.sphere_cz[i]);
+        sphere_r2.push_back(other.sphere_r2[i]);
+    }
+
+    void ObjectSet::add_quadric_from(const ObjectSet& other, const std::size_t i) {
+        quadrics.push_back(other.quadrics[i]);
+        for (std::size_t k {0}; k < quadric_fields.size(); ++k) quadric_fields[k].push_back(other.quadric_fields[k][i]);
+        quadric_bounds.push_back(other.quadric_bounds[i]);
+    }
+
+    void ObjectSet::add_other_from(const ObjectSet& other, const std::size_t i) {
+        other_objects.push_back(other.other_objects[i]);
+        other_bounds.push_back(other.other_bounds[i]);
+    }
+
+    void ObjectSet::use_arena(const std::shared_ptr<Memory::Arena>& arena) {
+        for (auto* v : {&sphere_cx, &sphere_cy, &sphere_cz, &sphere_r2}) *v = Memory::ArenaVector<float>(Memory::ArenaAllocator<float>(arena));
+        for (auto& field : quadric_fields) field = Memory::ArenaVector<float>(Memory::ArenaAllocator<float>(arena));
+        quadric_bounds = Memory::ArenaVector<AABB>(Memory::ArenaAllocator<AABB>(arena));
+        other_bounds = Memory::ArenaVector<AABB>(Memory::ArenaAllocator<AABB>(arena));
+        hierarchy = Memory::ArenaVector<BvhNode>(Memory::ArenaAllocator<BvhNode>(arena));
+        wide_hierarchy = Memory::ArenaVector<WideBvhNode>(Memory::ArenaAllocator<WideBvhNode>(arena));
+        wide_leaves = Memory::ArenaVector<BvhLeaf>(Memory::ArenaAllocator<BvhLeaf>(arena));
+    }
+
+    void ObjectSet::reserve(const std::array<std::size_t, PRIMITIVE_KIND_COUNT>& sizes) {
+        spheres.reserve(sizes[0]);
+        for (auto* v : {&sphere_cx, &sphere_cy, &sphere_cz, &sphere_r2}) v->reserve(sizes[0]);
+        quadrics.reserve(sizes[1]);
+        for (auto& field : quadric_fields) field.reserve(sizes[1]);
+        quadric_bounds.reserve(sizes[1]);
+        other_objects.reserve(sizes[2]);
+        other_bounds.reserve(sizes[2]);
+    }
+
+    ObjectSet ObjectSet::replicate(const std::shared_ptr<Memory::Arena>& arena) const {
+        ObjectSet copy;
+        copy.use_arena(arena);
+        copy.reserve({spheres.size(), quadrics.size(), other_objects.size()});
+        copy.hierarchy.reserve(hierarchy.size());
+        copy.wide_hierarchy.reserve(wide_hierarchy.size());
+        copy.wide_leaves.reserve(wide_leaves.size());
+
+        copy.spheres = spheres;
+        copy.quadrics = quadrics;
+        copy.other_objects = other_objects;
+        const auto copy_into = [](auto& to, const auto& from) { to.assign(from.begin(), from.end()); };
+        copy_into(copy.sphere_cx, sphere_cx);
+        copy_into(copy.sphere_cy, sphere_cy);
+        copy_into(copy.sphere_cz, sphere_cz);
+        copy_into(copy.sphere_r2, sphere_r2);
+        for (std::size_t k {0}; k < quadric_fields.size(); ++k) copy_into(copy.quadric_fields[k], quadric_fields[k]);
+        copy_into(copy.quadric_bounds, quadric_bounds);
+        copy_into(copy.other_bounds, other_bounds);
+        copy_into(copy.hierarchy, hierarchy);
+        copy_into(copy.wide_hierarchy, wide_hierarchy);
+        copy_into(copy.wide_leaves, wide_leaves);
+        copy.bounded = bounded;
+        return copy;
+    }
+
+    void ObjectSet::clear() {
+        spheres.clear();
+        quadrics.clear();
+        other_objects.clear();
+        quadric_bounds.clear();
+        other_bounds.clear();
+        hierarchy.clear();
+        wide_hierarchy.clear();
+        wide_leaves.clear();
+        bounded = {};
+        for (auto& field : quadric_fields) field.clear();
+        for (auto* v : {&sphere_cx, &sphere_cy, &sphere_cz, &sphere_r2}) v->clear();
+    }
+
+    std::size_t ObjectSet::memory_bytes() const {
+        std::size_t field_bytes {0};
+        for (const auto& field : quadric_fields) field_bytes += field.capacity() * sizeof(float);
+        return (spheres.capacity() + quadrics.capacity() + other_objects.capacity()) * sizeof(std::shared_ptr<Objects::IRenderable>)
+             + (sphere_cx.capacity() + sphere_cy.capacity() + sphere_cz.capacity() + sphere_r2.capacity()) * sizeof(float) + field_bytes
+             + (quadric_bounds.capacity() + other_bounds.capacity()) * sizeof(AABB)
+             + hierarchy.capacity() * sizeof(BvhNode) + wide_hierarchy.capacity() * sizeof(WideBvhNode) + wide_leaves.capacity() * sizeof(BvhLeaf);
+    }
+
+    Kernels::SphereSoA ObjectSet::sphere_soa(const std::size_t first, const std::size_t count) const {
+        return {sphere_cx.data() + first, sphere_cy.data() + first, sphere_cz.data() + first, sphere_r2.data() + first, count};
+    }
+
+    Kernels::QuadricSoA ObjectSet::quadric_soa(const std::size_t first, const std::size_t count) const {
+        Kernels::QuadricSoA soa {};
+        for (std::size_t k {0}; k < quadric_fields.size(); ++k) soa.field[k] = quadric_fields[k].data() + first;
+        soa.count = count;
+        return soa;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Scene
+    // -----------------------------------------------------------------------------
+
+    /**
+     * @brief Build a scene and flatten spheres and lights for the dispatched kernels.
+     *
+     * The flattened arrays are a snapshot: mutating an object or light after the
+     * scene is built is not seen by the kernels.
+     */
+    Scene::Scene(
+        const std::vector<std::shared_ptr<Objects::IRenderable>>& objects_,
+        const std::vector<std::shared_ptr<Objects::Light>>& lights_,
+        ThreadPool* pool
+    ) : objects(objects_), lights(lights_) {
+
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start {Clock::now()};
+
+        // make_shared puts each object behind a control block of two counters;
+        // instanced prototypes are shared and counted once. Chunks tally in
+        // parallel, each with the prototypes it met, which are merged after.
+        constexpr std::size_t CONTROL_BLOCK {2 * sizeof(long)};
+        struct Tally {
+            std::size_t bytes {0};
+            bool glossy {false};
+            std::unordered_set<const Objects::IRenderable*> prototypes;
+        };
+        const std::size_t chunks {chunk_count(pool, objects.size(), 4096)};
+        std::vector<Tally> tallies(chunks);
+        const auto tally = [&](const std::size_t c) {
+            Tally& t {tallies[c]};
+            for (std::size_t i {c * objects.size() / chunks}; i < (c + 1) * objects.size() / chunks; ++i) {
+                const Objects::IRenderable& object {*objects[i]};
+                t.bytes += object.memory_bytes() + CONTROL_BLOCK;
+                const Objects::Material& material {object.get_material()};
+                t.glossy = t.glossy || (material.reflectivity > 0.0f && material.glossiness > 0.0f);
+                if (const auto* instance {dynamic_cast<const Objects::Instance*>(&object)}) t.prototypes.insert(instance->get_prototype().get());
+            }
+        };
+        if (chunks == 1) tally(0);
+        else pool->parallel_for(chunks, tally);
+
+        std::size_t geometry_bytes {objects.capacity() * sizeof(std::shared_ptr<Objects::IRenderable>)};
+        std::unordered_set<const Objects::IRenderable*> prototypes;
+        for (const Tally& t : tallies) {
+            geometry_bytes += t.bytes;
+            glossy = glossy || t.glossy;
+            for (const Objects::IRenderable* prototype : t.prototypes) {
+                if (prototypes.insert(prototype).second) geometry_bytes += prototype->memory_bytes() + CONTROL_BLOCK;
+            }
+        }
+        geometry_charge = Memory::Charge(Memory::Subsystem::Geometry, geometry_bytes, "scene geometry");
+        const double accounting_ms {std::chrono::duration<double, std::milli>(Clock::now() - start).count()};
+
+        object_set.build(objects, pool, {}, &build_stats);
+        build_stats.accounting_ms = accounting_ms;
+        build_stats.total_ms += accounting_ms;
+        acceleration_charge = Memory::Charge(Memory::Subsystem::Acceleration, object_set.memory_bytes(), "scene object set");
+
+        flatten_lights();
+    }
+
+    void Scene::replicate_per_node() {
+        const std::size_t nodes {Numa::node_count()};
+        if (nodes < 2 || replicas) return;
+        Memory::Charge charge(Memory::Subsystem::Acceleration, nodes * object_set.memory_bytes(), "per-node scene copies");
+
+        auto copies {std::make_shared<std::vector<ObjectSet>>(nodes)};
+        std::vector<std::exception_ptr> errors(nodes);
+        std::vector<std::thread> writers;
+        for (std::size_t node {0}; node < nodes; ++node) {
+            writers.emplace_back([&, node] {
+                try {
+                    Numa::pin_to_node(node);
+                    (*copies)[node] = object_set.replicate(std::make_shared<Memory::Arena>());
+                } catch (...) {
+                    errors[node] = std::current_exception();
+                }
+            });
+        }
+        for (std::thread& writer : writers) writer.join();
+        for (const std::exception_ptr& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+        replicas = std::move(copies);
+        replicas_charge = std::move(charge);
+    }
+
+    void Scene::add_load_times(const double read_ms, const double primitives_ms) {
+        build_stats.read_ms += read_ms;
+        build_stats.primitives_ms += primitives_ms;
+        build_stats.total_ms += read_ms + primitives_ms;
+    }
+
+    void Scene::set_lights(const std::vector<std::shared_ptr<Objects::Light>>& lights_) {
+        lights = lights_;
+        flatten_lights();
+    }
+
+    void Scene::set_sampling(const SamplingSettings& sampling_) {
+        if (sampling_.min_samples < 1 || sampling_.max_samples < sampling_.min_samples || !(sampling_.tolerance >= 0.0f)) {
+            throw std::invalid_argument("sampling needs 1 <= min_samples <= max_samples and tolerance >= 0");
+        }
+        sampling = sampling_;
+    }
+
+    void Scene::flatten_lights() {
+        ambient = 0.0f;
+        area_lights.clear();
+        for (auto* v : {&point_x, &point_y, &point_z, &point_intensity, &dir_x, &dir_y, &dir_z, &dir_intensity}) v->clear();
+
+        for (const auto& light : lights) {
+            if (light->get_type() == Objects::Light::Type::Ambient) {
+                ambient += light->get_intensity();
+            } else if (const auto pt {std::dynamic_pointer_cast<Objects::PointLight>(light)}) {
+                const vec3 p {pt->get_position()};
+                point_x.push_back(p.x);
+                point_y.push_back(p.y);
+                point_z.push_back(p.z);
+                point_intensity.push_back(light->get_intensity());
+            } else if (const auto dl {std::dynamic_pointer_cast<Objects::DirectionalLight>(light)}) {
+                const vec3 d {normalize(dl->get_direction())};
+                dir_x.push_back(d.x);
+                dir_y.push_back(d.y);
+                dir_z.push_back(d.z);
+                dir_intensity.push_back(light->get_intensity());
+            } else if (auto area {std::dynamic_pointer_cast<const Objects::AreaLight>(light)}) {
+                area_lights.push_back(std::move(area));
+            }
+        }
+
+        constexpr std::size_t LIGHT_BYTES {std::max({sizeof(Objects::PointLight), sizeof(Objects::DirectionalLight), sizeof(Objects::AreaLight)}) + 2 * sizeof(long)};
+        std::size_t light_bytes {(lights.capacity() + area_lights.capacity()) * sizeof(std::shared_ptr<Objects::Light>) + lights.size() * LIGHT_BYTES};
+        for (const auto* v : {&point_x, &point_y, &point_z, &point_intensity, &dir_x, &dir_y, &dir_z, &dir_intensity}) light_bytes += v->capacity() * sizeof(float);
+        lights_charge = Memory::Charge(Memory::Subsystem::Lights, light_bytes, "scene lights");
+    }
+
+    Kernels::LightSoA Scene::light_soa() const {
+        return {
+            ambient,
+            point_x.data(), point_y.data(), point_z.data(), point_intensity.data(), point_x.size(),
+            dir_x.data(), dir_y.data(), dir_z.data(), dir_intensity.data(), dir_x.size()
+        };
+    }
 
     // -----------------------------------------------------------------------------
     // Canvas → Viewport mapping
@@ -53,19 +430,158 @@ namespace RayTracing {
         return std::fabs(length(v) - 1.0f) <= epsilon;
     }
 
-    inline void closest_interaction(const Ray& ray, const float& t_min, const float& t_max, const Scene& scene, float& closest_t, std::shared_ptr<Objects::IRenderable>& closest_object) {
-            closest_t = INFINITY;
-            closest_object = nullptr;
+    /**
+     * @brief Find the nearest object hit by a ray with t in (t_min, t_max).
+     *
+     * On a miss closest_object is null and closest_t is INFINITY.
+     */
+    void closest_interaction(const Ray& ray, const float& t_min, const float& t_max, const Scene& scene, float& closest_t, std::shared_ptr<Objects::IRenderable>& closest_object) {
+        closest_interaction(ray, t_min, t_max, scene.get_object_set(), closest_t, closest_object);
+    }
 
-        for (const auto& object : scene.get_objects()) {
-            for (const std::vector<float> all_ts {object->intersect(ray)}; const auto& t : all_ts) {
-                if (t > t_min && t < t_max && t < closest_t) {
+    namespace {
+        // Nearest hit below closest_t among each kind's entries [begin[k], end[k]); spheres win exact ties, then quadrics
+        void nearest_in(const ObjectSet& set, const std::array<std::size_t, PRIMITIVE_KIND_COUNT>& begin, const std::array<std::size_t, PRIMITIVE_KIND_COUNT>& end,
+                        const Ray& ray, const float t_min, const float t_max, float& closest_t, std::shared_ptr<Objects::IRenderable>& closest_object) {
+            const vec3 O {ray.get_origin()};
+            const vec3 D {ray.get_direction()};
+            const float origin[3] {O.x, O.y, O.z};
+            const float direction[3] {D.x, D.y, D.z};
+
+            // Spheres and quadrics go through the batched kernels
+            if (end[0] > begin[0]) {
+                float t {INFINITY};
+                if (const int index {Kernels::active().nearest_sphere(origin, direction, t_min, std::min(t_max, closest_t), set.sphere_soa(begin[0], end[0] - begin[0]), t)}; index >= 0) {
                     closest_t = t;
-                    closest_object = object;
+                    closest_object = set.get_spheres()[begin[0] + index];
                 }
             }
+            if (end[1] > begin[1]) {
+                float t {INFINITY};
+                if (const int index {Kernels::active().nearest_quadric(origin, direction, t_min, std::min(t_max, closest_t), set.quadric_soa(begin[1], end[1] - begin[1]), t)}; index >= 0) {
+                    closest_t = t;
+                    closest_object = set.get_quadrics()[begin[1] + index];
+                }
+            }
+            for (std::size_t i {begin[2]}; i < end[2]; ++i) {
+                const auto& object {set.get_other_objects()[i]};
+                for (const std::vector<float> all_ts {object->intersect(ray)}; const auto& t : all_ts) {
+                    if (t > t_min && t < t_max && t < closest_t) {
+                        closest_t = t;
+                        closest_object = object;
+                    }
+                }
+            }
+        }
+    }
+
+    namespace {
+        // The wide hierarchy's part of closest_interaction: all children of a node in one kernel call, pushed farthest first
+        void nearest_in_wide(const ObjectSet& set, const Ray& ray, const float t_min, const float t_max, float& closest_t,
+                             std::shared_ptr<Objects::IRenderable>& closest_object) {
+            const Memory::ArenaVector<WideBvhNode>& nodes {set.get_wide_hierarchy()};
+            const Memory::ArenaVector<BvhLeaf>& leaves {set.get_wide_leaves()};
+            const Kernels::KernelTable& kernels {Kernels::active()};
+            const vec3 D {ray.get_direction()};
+            const float origin[3] {ray.get_origin().x, ray.get_origin().y, ray.get_origin().z};
+            const float inverse_direction[3] {1.0f / D.x, 1.0f / D.y, 1.0f / D.z};
+
+            struct Entry {
+                std::uint32_t ref;      // WIDE_LEAF_REF | leaf index, or node index
+                float t;
+            };
+            constexpr std::uint32_t WIDE_LEAF_REF {0x80000000u};
+            Entry stack[(BVH_WIDTH - 1) * 128 + 1];    // BVH_WIDTH - 1 left behind per level, no deeper than the binary tree
+            int top {0};
+            stack[top++] = {0, t_min};
+
+            while (top > 0) {
+                const Entry entry {stack[--top]};
+                if (entry.t >= closest_t) continue;
+
+                if ((entry.ref & WIDE_LEAF_REF) != 0) {
+                    const BvhLeaf& leaf {leaves[entry.ref & ~WIDE_LEAF_REF]};
+                    std::array<std::size_t, PRIMITIVE_KIND_COUNT> end {};
+                    for (std::size_t k {0}; k < PRIMITIVE_KIND_COUNT; ++k) end[k] = leaf.first[k] + leaf.count[k];
+                    nearest_in(set, {leaf.first[0], leaf.first[1], leaf.first[2]}, end, ray, t_min, t_max, closest_t, closest_object);
+                    continue;
+                }
+
+                const WideBvhNode& node {nodes[entry.ref]};
+                float t_enter[BVH_WIDTH];
+                unsigned hits {kernels.enter_boxes8(node.boxes, origin, inverse_direction, t_min, std::min(t_max, closest_t), t_enter)};
+
+                // Insertion sort by decreasing entry distance, so the nearest child is popped next
+                const int first {top};
+                while (hits != 0) {
+                    const auto c {static_cast<std::size_t>(std::countr_zero(hits))};
+                    hits &= hits - 1;
+                    const std::uint8_t child {node.child[c]};
+                    const Entry pushed {(child & WIDE_LEAF_BIT) != 0 ? WIDE_LEAF_REF | (node.first_leaf + (child & ~WIDE_LEAF_BIT)) : node.first_node + child, t_enter[c]};
+                    int slot {top++};
+                    for (; slot > first && stack[slot - 1].t < pushed.t; --slot) stack[slot] = stack[slot - 1];
+                    stack[slot] = pushed;
+                }
+            }
+        }
+    }
+
+    void closest_interaction(const Ray& ray, const float& t_min, const float& t_max, const ObjectSet& candidates, float& closest_t, std::shared_ptr<Objects::IRenderable>& closest_object) {
+        closest_t = INFINITY;
+        closest_object = nullptr;
+
+        // Whatever the hierarchy does not cover (everything when there is none)
+        const std::array<std::size_t, PRIMITIVE_KIND_COUNT> ends {candidates.get_spheres().size(), candidates.get_quadrics().size(), candidates.get_other_objects().size()};
+        nearest_in(candidates, candidates.get_bounded_counts(), ends, ray, t_min, t_max, closest_t, closest_object);
+
+        if (!candidates.get_wide_hierarchy().empty()) {
+            nearest_in_wide(candidates, ray, t_min, t_max, closest_t, closest_object);
+            return;
+        }
+        const Memory::ArenaVector<BvhNode>& nodes {candidates.get_hierarchy()};
+        if (nodes.empty()) return;
+
+        // Nearest child first; a node is skipped once a closer hit than its entry distance is known
+        const vec3 O {ray.get_origin()};
+        const vec3 D {ray.get_direction()};
+        const vec3 inverse_direction {1.0f / D.x, 1.0f / D.y, 1.0f / D.z};
+        struct Entry {
+            std::uint32_t node;
+            float t;
+        };
+        Entry stack[128];
+        int top {0};
+        if (const float t {enter_box(nodes[0].box, O, inverse_direction, t_min, std::min(t_max, closest_t))}; t >= 0.0f) stack[top++] = {0, t};
+
+        while (top > 0) {
+            const Entry entry {stack[--top]};
+            if (entry.t >= closest_t) continue;
+            const BvhNode& node {nodes[entry.node]};
+
+            if (node.is_leaf()) {
+                std::array<std::size_t, PRIMITIVE_KIND_COUNT> end {};
+                for (std::size_t k {0}; k < PRIMITIVE_KIND_COUNT; ++k) end[k] = node.first[k] + node.count[k];
+                nearest_in(candidates, {node.first[0], node.first[1], node.first[2]}, end, ray, t_min, t_max, closest_t, closest_object);
+                continue;
+            }
+
+            const float limit {std::min(t_max, closest_t)};
+            const std::uint32_t near_child {entry.node + 1};
+            const std::uint32_t far_child {node.first[0]};
+            const float t_near {enter_box(nodes[near_child].box, O, inverse_direction, t_min, limit)};
+            const float t_far {enter_box(nodes[far_child].box, O, inverse_direction, t_min, limit)};
+            if (t_near >= 0.0f && t_far >= 0.0f) {
+                const bool swap {t_far < t_near};
+                stack[top++] = swap ? Entry {near_child, t_near} : Entry {far_child, t_far};
+                stack[top++] = swap ? Entry {far_child, t_far} : Entry {near_child, t_near};
+            } else if (t_near >= 0.0f) {
+                stack[top++] = {near_child, t_near};
+            } else if (t_far >= 0.0f) {
+                stack[top++] = {far_child, t_far};
+            }
         }
     }
+
     // -----------------------------------------------------------------------------
     // Ray tracing core
     // -----------------------------------------------------------------------------
@@ -82,9 +598,88 @@ namespace RayTracing {
      * @param t_max   Upper bound for valid intersections (e.g., infinity).
      * @param scene   Scene containing renderables and lights.
      * @param depth   Current recursion depth (0 for primaries).
+     * @param sampler Sample points for area lights and glossy lobes; null gives
+     *                light centers and mirror reflections.
      * @return        RGB color for the ray.
      */
-    RGB trace_ray(const Ray& ray, float t_min, float t_max, const Scene& scene, const int depth) {
+    RGB trace_ray(const Ray& ray, const float t_min, const float t_max, const Scene& scene, const int depth, const Sampling::PixelSampler* sampler) {
+        return trace_ray(ray, t_min, t_max, scene, scene.get_object_set(), depth, sampler);
+    }
+
+    namespace {
+        // Dimension pairs of a pixel sample: 0 is the position in the pixel, then per bounce
+        // one for the reflection lobe followed by one per area light
+        std::uint32_t sample_dimension(const Scene& scene, const int depth, const std::size_t slot) {
+            return static_cast<std::uint32_t>(1 + static_cast<std::size_t>(depth) * (1 + scene.get_area_lights().size()) + slot);
+        }
+
+        /**
+         * @brief Diffuse and specular light reaching P from the area lights.
+         *
+         * Each light contributes one point (sampled, or its center without a
+         * sampler) if a shadow ray to it is unobstructed; averaging the pixel's
+         * samples integrates over the light and yields the penumbra.
+         */
+        float area_lighting(const vec3& P, const vec3& N_in, const vec3& V_in, const int shininess, const Scene& scene,
+                            const int depth, const Sampling::PixelSampler* sampler) {
+            const vec3 N {normalize(N_in)};
+            const vec3 V {normalize(V_in)};
+            const auto& area_lights {scene.get_area_lights()};
+            float intensity {0.0f};
+
+            for (std::size_t i {0}; i < area_lights.size(); ++i) {
+                const vec2 uv {sampler ? sampler->get_2d(sample_dimension(scene, depth, 1 + i)) : vec2(0.5f)};
+                const vec3 to_light {area_lights[i]->point_at(uv.x, uv.y) - P};
+                const float distance {length(to_light)};
+                const vec3 L {to_light / distance};
+
+                const float n_dot_l {dot(N, L)};
+                if (n_dot_l <= 0.0f) continue;
+
+                float blocker_t {INFINITY};
+                std::shared_ptr<Objects::IRenderable> blocker {nullptr};
+                closest_interaction(Ray(P, L), EPS, distance - EPS, scene, blocker_t, blocker);
+                if (blocker != nullptr) continue;
+
+                intensity += area_lights[i]->get_intensity() * n_dot_l;
+                if (shininess != -1) {
+                    const vec3 R {N * 2.0f * n_dot_l - L};
+                    if (const float r_dot_v {dot(R, V)}; r_dot_v > 0.0f) {
+                        intensity += area_lights[i]->get_intensity() * Kernels::active().specular_power(r_dot_v, shininess);
+                    }
+                }
+            }
+            return intensity;
+        }
+
+        /// Direction drawn uniformly from the cone of half-angle glossiness * MAX_GLOSSY_ANGLE around R (R if it would go below the surface).
+        vec3 glossy_direction(const vec3& R, const vec3& N, const float glossiness, const vec2& uv) {
+            const float cos_max {std::cos(std::min(glossiness, 1.0f) * MAX_GLOSSY_ANGLE)};
+            const float cos_theta {1.0f - uv.x * (1.0f - cos_max)};
+            const float sin_theta {std::sqrt(std::max(0.0f, 1.0f - cos_theta * cos_theta))};
+            const float phi {6.2831853f * uv.y};
+
+            // Orthonormal basis around R (Duff et al. 2017)
+            const float sign {std::copysign(1.0f, R.z)};
+            const float a {-1.0f / (sign + R.z)};
+            const float b {R.x * R.y * a};
+            const vec3 T {1.0f + sign * R.x * R.x * a, sign * b, -sign * R.x};
+            const vec3 B {b, sign + R.y * R.y * a, -R.y};
+
+            const vec3 direction {normalize(T * (sin_theta * std::cos(phi)) + B * (sin_theta * std::sin(phi)) + R * cos_theta)};
+            return dot(direction, N) > 0.0f ? direction : R;
+        }
+    }
+
+    /**
+     * @brief Trace a ray, intersecting it only against the given candidates.
+     *
+     * Used for primary rays with a per-tile culled set; reflected rays always go
+     * back to the full scene. hit (if given) receives the surface this ray
+     * itself hit, not its reflections.
+     */
+    RGB trace_ray(const Ray& ray, float t_min, float t_max, const Scene& scene, const ObjectSet& candidates, const int depth, const Sampling::PixelSampler* sampler,
+                  SurfaceHit* hit) {
         typedef std::shared_ptr<Objects::IRenderable> ObjectPtr;
         if (depth > MAX_RECURSION_DEPTH) {
             return BLACK;
@@ -94,7 +689,8 @@ namespace RayTracing {
         float closest_t {INFINITY};
         ObjectPtr closest_object {nullptr};
 
-        closest_interaction(ray, t_min, t_max, scene, closest_t, closest_object);
+        closest_interaction(ray, t_min, t_max, candidates, closest_t, closest_object);
+        if (hit != nullptr) *hit = {closest_t, closest_object.get()};
 
         // No hit: return background
         if (closest_object == nullptr) {
@@ -107,14 +703,22 @@ namespace RayTracing {
         const vec3 V {-ray.get_direction()};               // view vector (toward camera)
 
         // ----- Local shading (diffuse + specular) -----
-        const float intensity {compute_lighting(P, N, scene.get_lights(), V, closest_object->get_specular())};
-        RGB local_color {closest_object->get_color() * intensity};
+        const float P_[3] {P.x, P.y, P.z}, N_[3] {N.x, N.y, N.z}, V_[3] {V.x, V.y, V.z};
+        const Objects::Material& material {closest_object->get_material()};
+        float intensity {Kernels::active().compute_lighting(P_, N_, V_, material.specular, scene.light_soa())};
+        if (!scene.get_area_lights().empty()) {
+            intensity = std::min(1.0f, intensity + area_lighting(P, N, V, material.specular, scene, depth, sampler));
+        }
+        RGB local_color {material.color * intensity};
 
-        // ----- Reflections -----
-        if (float reflectivity {closest_object->get_reflectivity()}; reflectivity > 0) {
-            const vec3 R {normalize(reflect(ray.get_direction(), N))};
+        // ----- Reflections (blurred around the mirror direction for glossy materials) -----
+        if (const float reflectivity {material.reflectivity}; reflectivity > 0) {
+            vec3 R {normalize(reflect(ray.get_direction(), N))};
+            if (sampler != nullptr && material.glossiness > 0.0f) {
+                R = glossy_direction(R, normalize(N), material.glossiness, sampler->get_2d(sample_dimension(scene, depth, 0)));
+            }
             const Ray reflected_ray {P + R * EPS, R};
-            const RGB reflected_color {trace_ray(reflected_ray, EPS, t_max, scene, depth + 1)};
+            const RGB reflected_color {trace_ray(reflected_ray, EPS, t_max, scene, depth + 1, sampler)};
             local_color = local_color * (1.0f - reflectivity) + reflected_color * reflectivity;
         }
 
@@ -148,6 +752,9 @@ namespace RayTracing {
                 continue;
             }
 
+            // Area lights need shadow rays against the scene (see trace_ray)
+            if (light->get_type() == Objects::Light::Type::Area) continue;
+
             // Direction from P toward the light
             vec3 L;
 
@@ -194,23 +801,21 @@ namespace RayTracing {
      * @param width     Image width in pixels.
      * @param height    Image height in pixels.
      */
-    void save_ppm_binary(const std::string& filename, const std::vector<RGB>& pixels, const int width, const int height) {
+    void save_ppm_binary(const std::string& filename, std::span<const RGB> pixels, const int width, const int height) {
 
         // Ensure all pixel vector is the same size as the window
-        if (pixels.size() != width * height) {throw;}
+        if (pixels.size() != static_cast<std::size_t>(width) * height) {
+            throw std::invalid_argument("pixel buffer does not match " + std::to_string(width) + "x" + std::to_string(height));
+        }
+
+        static_assert(sizeof(RGB) == 3 * sizeof(int), "RGB must be three packed ints");
+        std::vector<unsigned char> bytes(pixels.size() * 3);
+        Kernels::active().tonemap_rgb8(reinterpret_cast<const int*>(pixels.data()), pixels.size(), bytes.data());
 
         std::ofstream ofs(filename, std::ios::binary);
         ofs << "P6\n" << width << " " << height << "\n255\n";
-
-        for (const auto& pixel : pixels) {
-            unsigned char r {static_cast<unsigned char>(std::clamp(pixel.r, 0, 255))};
-            unsigned char g {static_cast<unsigned char>(std::clamp(pixel.g, 0, 255))};
-            unsigned char b {static_cast<unsigned char>(std::clamp(pixel.b, 0, 255))};
-
-            ofs.write(reinterpret_cast<char*>(&r), 1);
-            ofs.write(reinterpret_cast<char*>(&g), 1);
-            ofs.write(reinterpret_cast<char*>(&b), 1);
-        }
+        ofs.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
         ofs.close();
+        if (!ofs) throw std::runtime_error("failed to write " + filename);
     }
 }
\ No newline at end of file
@@ -3,33 +3,199 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
 #include "Utilities/RGB.hpp"
 #include "Utilities/Ray.hpp"
+#include "Utilities/Kernels.hpp"
+#include "Utilities/AABB.hpp"
+#include "Utilities/Arena.hpp"
+#include "Utilities/MemoryAccounting.hpp"
+#include "Utilities/Numa.hpp"
+#include "Utilities/Sampler.hpp"
+#include "Utilities/ThreadPool.hpp"
+#include "RayTracing/Bvh.hpp"
 #include "Objects/IRenderable.hpp"
 #include "Objects/Light.hpp"
 #include <glm/glm.hpp>
 
 namespace RayTracing {
 
+    // -----------------------------------------------------------------------------
+    // Constants / configuration
+    // -----------------------------------------------------------------------------
+
+    inline constexpr float EPS                  {1e-4};
+    inline const RGB BLACK                      {0.0f, 0.0f, 0.0f};
+    inline const RGB BACKGROUND_COLOR           {255, 255, 255};    // White background
+    inline constexpr int MAX_RECURSION_DEPTH    {3};                // Max recursion for reflections
+    inline constexpr float MAX_GLOSSY_ANGLE     {0.7853982f};       // Half-angle of the reflection lobe at glossiness 1 (45 degrees)
+
+    /**
+     * @brief Per-pixel sample budget for scenes with area lights or glossy materials.
+     *
+     * A pixel takes min_samples samples, then more in batches of min_samples
+     * until the 95% confidence half-width of its mean luminance is within
+     * tolerance (0-255 scale) or it reaches max_samples. Flat regions stop
+     * after the first batch; penumbrae and glossy highlights get the rest.
+     * Scenes without either are traced with one ray per pixel, as before.
+     */
+    struct SamplingSettings {
+        std::uint32_t seed {1};
+        int min_samples {16};
+        int max_samples {64};
+        float tolerance {2.0f};
+    };
+
+    /**
+     * @brief Renderables arranged for the kernels: spheres and other quadrics as SoA, the rest by pointer.
+     *
+     * A Scene holds one for all of its objects; the tile renderer builds
+     * smaller ones holding only what a tile's frustum can reach. Large sets
+     * built with build() also carry a bounding volume hierarchy, binary or
+     * wide (see BvhFormat); each kind's array then starts with the primitives
+     * it covers, in leaf order, and ends with the unbounded ones. Sets from build() keep their kernel arrays
+     * in one arena (see Memory::get_page_policy); others use the heap.
+     */
+    class ObjectSet {
+        std::vector<std::shared_ptr<Objects::IRenderable>> spheres;         // index-aligned with sphere_* arrays
+        std::vector<std::shared_ptr<Objects::IRenderable>> quadrics;        // Objects::Quadric, index-aligned with quadric_fields
+        std::vector<std::shared_ptr<Objects::IRenderable>> other_objects;   // everything else
+        Memory::ArenaVector<float> sphere_cx, sphere_cy, sphere_cz, sphere_r2;
+        std::array<Memory::ArenaVector<float>, Kernels::QuadricSoA::FIELD_COUNT> quadric_fields;
+        Memory::ArenaVector<AABB> quadric_bounds;                           // index-aligned with quadrics
+        Memory::ArenaVector<AABB> other_bounds;                             // index-aligned with other_objects
+        Memory::ArenaVector<BvhNode> hierarchy;                             // Binary format
+        Memory::ArenaVector<WideBvhNode> wide_hierarchy;                    // Wide format (both empty: test everything)
+        Memory::ArenaVector<BvhLeaf> wide_leaves;
+        std::array<std::size_t, PRIMITIVE_KIND_COUNT> bounded {};           // per kind, the leading entries under the hierarchy
+
+        // Empty the kernel arrays and allocate them from arena from now on
+        void use_arena(const std::shared_ptr<Memory::Arena>& arena);
+        void reserve(const std::array<std::size_t, PRIMITIVE_KIND_COUNT>& sizes);
+
+    public:
+        // Append any renderable (spheres and quadrics are detected and flattened) to a set without a hierarchy
+        void add(const std::shared_ptr<Objects::IRenderable>& object);
+
+        /**
+         * @brief Replace the contents with objects, in parallel on pool (serially if null).
+         *
+         * With at least options.min_primitives bounded objects the set is
+         * reordered and gets a hierarchy (see build_bvh); otherwise it equals
+         * adding the objects one by one. stats (if given) receives the phase timings.
+         */
+        void build(const std::vector<std::shared_ptr<Objects::IRenderable>>& objects, ThreadPool* pool,
+                   const BvhBuildOptions& options = {}, SceneBuildStats* stats = nullptr);
+
+        /// Copy whose kernel arrays live in arena, first touched by the calling thread (objects are shared).
+        ObjectSet replicate(const std::shared_ptr<Memory::Arena>& arena) const;
+
+        // Copy the i-th sphere / quadric / other object of another set without re-inspecting it
+        void add_sphere_from(const ObjectSet& other, std::size_t i);
+        void add_quadric_from(const ObjectSet& other, std::size_t i);
+        void add_other_from(const ObjectSet& other, std::size_t i);
+
+        void clear();
+
+        // Getters
+        std::size_t size() const { return spheres.size() + quadrics.size() + other_objects.size(); }
+        std::size_t memory_bytes() const;
+        const std::vector<std::shared_ptr<Objects::IRenderable>>& get_spheres() const { return spheres; }
+        const std::vector<std::shared_ptr<Objects::IRenderable>>& get_quadrics() const { return quadrics; }
+        const std::vector<std::shared_ptr<Objects::IRenderable>>& get_other_objects() const { return other_objects; }
+        const Memory::ArenaVector<AABB>& get_quadric_bounds() const { return quadric_bounds; }
+        const Memory::ArenaVector<AABB>& get_other_bounds() const { return other_bounds; }
+        const Memory::ArenaVector<BvhNode>& get_hierarchy() const { return hierarchy; }
+        const Memory::ArenaVector<WideBvhNode>& get_wide_hierarchy() const { return wide_hierarchy; }
+        const Memory::ArenaVector<BvhLeaf>& get_wide_leaves() const { return wide_leaves; }
+        bool has_hierarchy() const { return !hierarchy.empty() || !wide_hierarchy.empty(); }
+        const std::array<std::size_t, PRIMITIVE_KIND_COUNT>& get_bounded_counts() const { return bounded; }
+        Kernels::SphereSoA sphere_soa() const { return sphere_soa(0, spheres.size()); }
+        Kernels::QuadricSoA quadric_soa() const { return quadric_soa(0, quadrics.size()); }
+        Kernels::SphereSoA sphere_soa(std::size_t first, std::size_t count) const;
+        Kernels::QuadricSoA quadric_soa(std::size_t first, std::size_t count) const;
+    };
+
     class Scene {
         std::vector<std::shared_ptr<Objects::IRenderable>> objects;
         std::vector<std::shared_ptr<Objects::Light>> lights;
+
+        // Flattened copies consumed by the dispatched kernels (built once in the constructor)
+        ObjectSet object_set;
+        std::shared_ptr<const std::vector<ObjectSet>> replicas;    // per NUMA node, if replicated
+        std::vector<float> point_x, point_y, point_z, point_intensity;
+        std::vector<float> dir_x, dir_y, dir_z, dir_intensity;
+        float ambient {0.0f};
+        std::vector<std::shared_ptr<const Objects::AreaLight>> area_lights;
+        SamplingSettings sampling;
+        bool glossy {false};                // Any material with a blurred reflection
+        SceneBuildStats build_stats;
+
+        // Charged to Memory::Accounting for as long as this scene (or a copy) lives
+        Memory::Charge geometry_charge;
+        Memory::Charge acceleration_charge;
+        Memory::Charge lights_charge;
+        Memory::Charge replicas_charge;
+
+        void flatten_lights();
+
     public:
-        // Constructors
+        // Constructors (@throws Memory::BudgetExceeded when the scene does not fit the memory budget); pool parallelises the build
         Scene(
             const std::vector<std::shared_ptr<Objects::IRenderable>>& objects_,
-            const std::vector<std::shared_ptr<Objects::Light>>& lights_
-        ) : objects(objects_), lights(lights_) {}
+            const std::vector<std::shared_ptr<Objects::Light>>& lights_,
+            ThreadPool* pool = nullptr
+        );
 
         // Getters
         const std::vector<std::shared_ptr<Objects::IRenderable>>& get_objects() const { return objects; }
         const std::vector<std::shared_ptr<Objects::Light>>& get_lights() const { return lights; }
+        const SceneBuildStats& get_build_stats() const { return build_stats; }
+
+        // Setters (geometry is fixed once built; lights may be swapped, e.g. for relighting)
+        void set_lights(const std::vector<std::shared_ptr<Objects::Light>>& lights_);
+        /// @throws std::invalid_argument unless 1 <= min_samples <= max_samples and tolerance >= 0
+        void set_sampling(const SamplingSettings& sampling_);
+        /// Time a loader spent before constructing the scene, added to get_build_stats().
+        void add_load_times(double read_ms, double primitives_ms);
+
+        // Sampling
+        const SamplingSettings& get_sampling() const { return sampling; }
+        const std::vector<std::shared_ptr<const Objects::AreaLight>>& get_area_lights() const { return area_lights; }
+        bool needs_sampling() const { return glossy || !area_lights.empty(); }
+
+        /**
+         * @brief Give every NUMA node its own copy of the kernel arrays and hierarchy.
+         *
+         * Each copy is written by a thread pinned to its node, so its pages
+         * live there; get_object_set() then hands threads their node's copy.
+         * The objects themselves (hit on every shading step, but far less
+         * often than the arrays) stay shared. A no-op on single-node machines.
+         * @throws Memory::BudgetExceeded if the copies do not fit the memory budget
+         */
+        void replicate_per_node();
+
+        // Kernel views (valid for the lifetime of the scene)
+        const ObjectSet& get_object_set() const { return replicas ? (*replicas)[Numa::current_node() % replicas->size()] : object_set; }
+        Kernels::LightSoA light_soa() const;
+    };
+
+    /// Nearest surface along a ray; object is null on a miss.
+    struct SurfaceHit {
+        float t {INFINITY};
+        const Objects::IRenderable* object {nullptr};
     };
 
     glm::vec3 canvas_to_viewport(int x, int y, float Vw, float Vh, float d, int Cw, int Ch);
-    RGB trace_ray(const Ray& ray, float t_min, float t_max, const Scene& scene, int depth = 0);
+    void closest_interaction(const Ray& ray, const float& t_min, const float& t_max, const Scene& scene, float& closest_t, std::shared_ptr<Objects::IRenderable>& closest_object);
+    void closest_interaction(const Ray& ray, const float& t_min, const float& t_max, const ObjectSet& candidates, float& closest_t, std::shared_ptr<Objects::IRenderable>& closest_object);
+    RGB trace_ray(const Ray& ray, float t_min, float t_max, const Scene& scene, int depth = 0, const Sampling::PixelSampler* sampler = nullptr);
+    RGB trace_ray(const Ray& ray, float t_min, float t_max, const Scene& scene, const ObjectSet& candidates, int depth = 0, const Sampling::PixelSampler* sampler = nullptr,
+                  SurfaceHit* hit = nullptr);
     float compute_lighting(const glm::vec3& P, const glm::vec3& N_in, const std::vector<std::shared_ptr<Objects::Light>>& lights, const glm::vec3& V_in, int shininess);
-    void save_ppm_binary(const std::string& filename, const std::vector<RGB>& pixels, int width, int height);
+    void save_ppm_binary(const std::string& filename, std::span<const RGB> pixels, int width, int height);
 }
 
 #endif // RAYTRACINGCPP_SRC_RAYTRACING_RAYTRACING_HPP
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "RayTracing/RenderServer.hpp"
+#include "RayTracing/ImageWriter.hpp"
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace RayTracing {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        double ms_between(const Clock::time_point a, const Clock::time_point b) {
+            return std::chrono::duration<double, std::milli>(b - a).count();
+        }
+
+        glm::vec3 parse_vec3(const std::string& text) {
+            glm::vec3 v;
+            char c1, c2;
+            std::istringstream ss(text);
+            if (!(ss >> v.x >> c1 >> v.y >> c2 >> v.z) || c1 != ',' || c2 != ',') {
+                throw std::invalid_argument("expected x,y,z but got '" + text + "'");
+            }
+            return v;
+        }
+
+        void send_all(const int fd, const std::string& data) {
+            std::size_t sent {0};
+            while (sent < data.size()) {
+                const ssize_t n {::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL)};
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return;   // client went away; drop the reply
+                sent += static_cast<std::size_t>(n);
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Job parsing
+    // -----------------------------------------------------------------------------
+
+    RenderJob parse_job(const std::string& line) {
+        std::istringstream ls(line);
+        std::string command;
+        ls >> command;
+        if (command != "render") throw std::invalid_argument("not a render command");
+
+        RenderJob job;
+        std::optional<glm::vec3> eye, look;
+
+        for (std::string token; ls >> token;) {
+            const auto eq {token.find('=')};
+            if (eq == std::string::npos) throw std::invalid_argument("expected key=value but got '" + token + "'");
+            const std::string key {token.substr(0, eq)};
+            const std::string value {token.substr(eq + 1)};
+
+            if (key == "scene") {
+                job.scene_id = value;
+            } else if (key == "size") {
+                char x;
+                std::istringstream ss(value);
+                if (!(ss >> job.width >> x >> job.height) || x != 'x' || job.width <= 0 || job.height <= 0) {
+                    throw std::invalid_argument("expected size=WxH but got '" + value + "'");
+                }
+            } else if (key == "out") {
+                job.output = value;
+            } else if (key == "eye") {
+                eye = parse_vec3(value);
+            } else if (key == "look") {
+                look = parse_vec3(value);
+            } else {
+                throw std::invalid_argument("unknown key '" + key + "'");
+            }
+        }
+
+        if (job.scene_id.empty()) throw std::invalid_argument("missing scene=<id>");
+        if (eye || look) {
+            const glm::vec3 from {eye.value_or(glm::vec3(0, 0, 0))};
+            job.camera = Camera::look_at(from, look.value_or(from + glm::vec3(0, 0, 1)));
+        }
+        return job;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Command handling
+    // -----------------------------------------------------------------------------
+
+    std::optional<std::string> RenderServer::handle(const std::string& line) {
+        std::istringstream ls(line);
+        std::string command;
+        if (!(ls >> command)) return std::string{};
+
+        if (command == "quit") return std::nullopt;
+
+        std::ostringstream response;
+        if (command == "stats") {
+            response << "ok jobs=" << jobs_done << " cached_scenes=" << cache.size() << " threads=" << pool.size();
+            return response.str();
+        }
+
+        try {
+            const RenderJob job {parse_job(line)};
+
+            const auto t0 {Clock::now()};
+            bool cached {false};
+            const std::shared_ptr<const Scene> scene {cache.get(job.scene_id, &cached)};
+            const auto t1 {Clock::now()};
+            const std::vector<RGB> framebuffer {render(*scene, job.camera, job.width, job.height, pool)};
+            const auto t2 {Clock::now()};
+            save_image(job.output, framebuffer, job.width, job.height, &pool);
+            const auto t3 {Clock::now()};
+
+            ++jobs_done;
+            response << std::fixed << std::setprecision(2)
+                     << "ok out=" << job.output
+                     << " scene=" << (cached ? "hit" : "miss")
+                     << " load_ms=" << ms_between(t0, t1)
+                     << " render_ms=" << ms_between(t1, t2)
+                     << " write_ms=" << ms_between(t2, t3)
+                     << " total_ms=" << ms_between(t0, t3);
+        } catch (const std::exception& e) {
+            response << "error " << e.what();
+        }
+        return response.str();
+    }
+
+    // -----------------------------------------------------------------------------
+    // Transports
+    // -----------------------------------------------------------------------------
+
+    void RenderServer::serve(std::istream& in, std::ostream& out) {
+        for (std::string line; std::getline(in, line);) {
+            const std::optional<std::string> response {handle(line)};
+            if (!response) {
+                out << "bye" << std::endl;
+                return;
+            }
+            if (!response->empty()) out << *response << std::endl;
+        }
+    }
+
+    void RenderServer::serve_unix_socket(const std::string& path) {
+        sockaddr_un addr {};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) throw std::invalid_argument("socket path too long: " + path);
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        const int server_fd {::socket(AF_UNIX, SOCK_STREAM, 0)};
+        if (server_fd < 0) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+
+        ::unlink(path.c_str());
+        if (::bind(server_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(server_fd, 8) < 0) {
+            const std::string reason {std::strerror(errno)};
+            ::close(server_fd);
+            throw std::runtime_error("cannot listen on " + path + ": " + reason);
+        }
+
+        bool running {true};
+        while (running) {
+            const int fd {::accept(server_fd, nullptr, nullptr)};
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            std::string buffer;
+            char chunk[4096];
+            while (running) {
+                const ssize_t n {::read(fd, chunk, sizeof(chunk))};
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                buffer.append(chunk, static_cast<std::size_t>(n));
+
+                for (std::size_t pos {buffer.find('\n')}; pos != std::string::npos; pos = buffer.find('\n')) {
+                    const std::string line {buffer.substr(0, pos)};
+                    buffer.erase(0, pos + 1);
+
+                    const std::optional<std::string> response {handle(line)};
+                    if (!response) {
+                        send_all(fd, "bye\n");
+                        running = false;
+                        break;
+                    }
+                    if (!response->empty()) send_all(fd, *response + "\n");
+                }
+            }
+            ::close(fd);
+        }
+
+        ::close(server_fd);
+        ::unlink(path.c_str());
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_RENDERSERVER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_RENDERSERVER_HPP
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include "RayTracing/Renderer.hpp"
+#include "RayTracing/SceneCache.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /// One render request as received by the server.
+    struct RenderJob {
+        std::string scene_id;
+        int width {600};
+        int height {600};
+        Camera camera;
+        std::string output {"output.ppm"};
+    };
+
+    /**
+     * @brief Parse a job line of the form
+     *
+     *   render scene=<id> [size=WxH] [out=<path>] [eye=x,y,z] [look=x,y,z]
+     *
+     * eye/look build a look-at camera; omitting both keeps the default camera.
+     * The output format follows the extension of out (.ppm or .qoi).
+     *
+     * @throws std::invalid_argument on malformed lines.
+     */
+    RenderJob parse_job(const std::string& line);
+
+    /**
+     * @brief Long-running render daemon.
+     *
+     * Reads one command per line and answers with one line:
+     *
+     *   render ...   -> "ok out=<path> scene=<hit|miss> load_ms=.. render_ms=.. write_ms=.. total_ms=.."
+     *   stats        -> "ok jobs=<n> cached_scenes=<n> threads=<n>"
+     *   quit         -> "bye" and the server stops
+     *
+     * Errors are reported as "error <message>" and do not stop the server. Jobs
+     * run one after another; each one is spread over the shared pool.
+     */
+    class RenderServer {
+        SceneCache& cache;
+        ThreadPool& pool;
+        std::size_t jobs_done {0};
+
+    public:
+        RenderServer(SceneCache& cache_, ThreadPool& pool_) : cache(cache_), pool(pool_) {}
+
+        /// Handle one command; returns the response, or nullopt once quit was requested.
+        std::optional<std::string> handle(const std::string& line);
+
+        /// Serve commands from a stream pair (e.g. stdin/stdout) until EOF or quit.
+        void serve(std::istream& in, std::ostream& out);
+
+        /// Listen on a Unix domain socket, serving one connection at a time until quit.
+        void serve_unix_socket(const std::string& path);
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_RENDERSERVER_HPP
@@ -0,0 +1,230 @@
+#include "RayTracing/Renderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace RayTracing {
+
+    using namespace glm;
+
+    // -----------------------------------------------------------------------------
+    // Camera
+    // -----------------------------------------------------------------------------
+
+    Camera Camera::look_at(const vec3& eye, const vec3& target, const vec3& up_hint) {
+        Camera camera;
+        camera.position = eye;
+        camera.forward = normalize(target - eye);
+
+        // Fall back to +z as hint when looking straight along the up hint
+        vec3 hint {up_hint};
+        if (std::fabs(dot(normalize(hint), camera.forward)) > 0.999f) hint = vec3(0, 0, 1);
+
+        camera.right = normalize(cross(hint, camera.forward));
+        camera.up = cross(camera.forward, camera.right);
+        return camera;
+    }
+
+    vec3 Camera::direction(const int x_canvas, const int y_canvas, const int Cw, const int Ch) const {
+        const vec3 v {canvas_to_viewport(x_canvas, y_canvas, viewport_width, viewport_height, projection_distance, Cw, Ch)};
+        return right * v.x + up * v.y + forward * v.z;
+    }
+
+    vec3 Camera::direction(const float x_canvas, const float y_canvas, const int Cw, const int Ch) const {
+        return right * (x_canvas * viewport_width / Cw) + up * (y_canvas * viewport_height / Ch) + forward * projection_distance;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Tiles
+    // -----------------------------------------------------------------------------
+
+    std::vector<Tile> make_tiles(const int width, const int height, const int tile_size) {
+        std::vector<Tile> tiles;
+        const int size {std::max(1, tile_size)};
+        tiles.reserve(static_cast<std::size_t>((width + size - 1) / size) * ((height + size - 1) / size));
+
+        for (int y {0}; y < height; y += size) {
+            for (int x {0}; x < width; x += size) {
+                tiles.push_back({x, y, std::min(x + size, width), std::min(y + size, height)});
+            }
+        }
+        return tiles;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Per-tile frustum culling
+    // -----------------------------------------------------------------------------
+
+    const ObjectSet& cull_for_tile(const Scene& scene, const Camera& camera, const int width, const int height, const Tile& tile, ObjectSet& out) {
+        const ObjectSet& all {scene.get_object_set()};
+        if (all.has_hierarchy()) return all;
+        out.clear();
+
+        // Canvas coordinates of the tile's outer pixel edges
+        const float x_left   {static_cast<float>(tile.x0 - width / 2) - 0.5f};
+        const float x_right  {static_cast<float>(tile.x1 - 1 - width / 2) + 0.5f};
+        const float y_top    {static_cast<float>(height / 2 - tile.y0) + 0.5f};
+        const float y_bottom {static_cast<float>(height / 2 - (tile.y1 - 1)) - 0.5f};
+
+        const auto corner = [&](const float xc, const float yc) {
+            return camera.right * (xc * camera.viewport_width / width)
+                 + camera.up * (yc * camera.viewport_height / height)
+                 + camera.forward * camera.projection_distance;
+        };
+        const vec3 corners[4] {corner(x_left, y_top), corner(x_right, y_top), corner(x_right, y_bottom), corner(x_left, y_bottom)};
+        const vec3 middle {corners[0] + corners[1] + corners[2] + corners[3]};
+
+        // Side planes through the eye, unit normals pointing into the frustum
+        vec3 normals[4];
+        for (int i {0}; i < 4; ++i) {
+            vec3 n {normalize(cross(corners[i], corners[(i + 1) % 4]))};
+            if (dot(n, middle) < 0.0f) n = -n;
+            normals[i] = n;
+        }
+
+        const vec3 eye {camera.position};
+
+        const Kernels::SphereSoA spheres {all.sphere_soa()};
+        for (std::size_t i {0}; i < spheres.count; ++i) {
+            const vec3 c {spheres.cx[i] - eye.x, spheres.cy[i] - eye.y, spheres.cz[i] - eye.z};
+            const float r {std::sqrt(spheres.radius2[i])};
+            bool inside {true};
+            for (const vec3& n : normals) inside = inside && dot(n, c) >= -r;
+            if (inside) out.add_sphere_from(all, i);
+        }
+
+        const auto box_inside = [&](const AABB& box) {
+            bool inside {true};
+            if (box.is_finite()) {
+                for (const vec3& n : normals) {
+                    // Box corner furthest along n
+                    const vec3 p {n.x >= 0 ? box.max.x : box.min.x,
+                                  n.y >= 0 ? box.max.y : box.min.y,
+                                  n.z >= 0 ? box.max.z : box.min.z};
+                    inside = inside && dot(n, p - eye) >= 0.0f;
+                }
+            }
+            return inside;
+        };
+
+        const auto& quadric_bounds {all.get_quadric_bounds()};
+        for (std::size_t i {0}; i < quadric_bounds.size(); ++i) {
+            if (box_inside(quadric_bounds[i])) out.add_quadric_from(all, i);
+        }
+
+        const auto& bounds {all.get_other_bounds()};
+        for (std::size_t i {0}; i < bounds.size(); ++i) {
+            if (box_inside(bounds[i])) out.add_other_from(all, i);
+        }
+        return out;
+    }
+
+    /**
+     * @brief Trace all pixels in a tile.
+     *
+     * Pixel (x, y) maps to canvas coordinates (x - width/2, height/2 - y), exactly
+     * as the original single-threaded loop did, so output does not depend on tiling.
+     * Primary rays only test the tile's culled candidates.
+     */
+    void render_tile(const Scene& scene, const Camera& camera, const int width, const int height, const Tile& tile, RGB* framebuffer, const int first_row) {
+        // Per-thread scratch: the candidate arrays keep their capacity from tile to tile
+        thread_local ObjectSet culled;
+        const ObjectSet& candidates {cull_for_tile(scene, camera, width, height, tile, culled)};
+        render_tile(scene, candidates, camera, width, height, tile, framebuffer, first_row);
+        culled.clear();     // let go of the scene's objects
+    }
+
+    RGB sample_pixel(const Scene& scene, const ObjectSet& candidates, const Camera& camera, const int width, const int height, const int x, const int y,
+                     int* sample_count) {
+        const SamplingSettings& settings {scene.get_sampling()};
+        Sampling::PixelSampler sampler(settings.seed, x, y);
+        const float x_canvas {static_cast<float>(x - width / 2)};
+        const float y_canvas {static_cast<float>(height / 2 - y)};
+
+        // Running sums for the color and a Welford mean / variance of luminance
+        float sum_r {0.0f}, sum_g {0.0f}, sum_b {0.0f};
+        float mean {0.0f}, m2 {0.0f};
+        int n {0};
+
+        while (n < settings.max_samples) {
+            for (const int batch_end {std::min(n + settings.min_samples, settings.max_samples)}; n < batch_end;) {
+                sampler.set_index(static_cast<std::uint32_t>(n));
+
+                // Jitter within the pixel, inside the half-pixel margin the tile culling keeps
+                const vec2 offset {sampler.get_2d(0) - vec2(0.5f)};
+                const vec3 direction {normalize(camera.direction(x_canvas + offset.x, y_canvas - offset.y, width, height))};
+                const RGB sample {trace_ray(Ray(camera.position, direction), 1.0f, INFINITY, scene, candidates, 0, &sampler)};
+
+                sum_r += static_cast<float>(sample.r);
+                sum_g += static_cast<float>(sample.g);
+                sum_b += static_cast<float>(sample.b);
+                const float luminance {0.2126f * static_cast<float>(sample.r) + 0.7152f * static_cast<float>(sample.g) + 0.0722f * static_cast<float>(sample.b)};
+                ++n;
+                const float delta {luminance - mean};
+                mean += delta / static_cast<float>(n);
+                m2 += delta * (luminance - mean);
+            }
+
+            // Converged once the 95% confidence interval of the mean is within tolerance
+            if (n > 1 && 1.96f * std::sqrt(m2 / static_cast<float>(n - 1) / static_cast<float>(n)) <= settings.tolerance) break;
+        }
+
+        if (sample_count != nullptr) *sample_count = n;
+        const float scale {1.0f / static_cast<float>(n)};
+        return {std::round(sum_r * scale), std::round(sum_g * scale), std::round(sum_b * scale)};
+    }
+
+    RGB trace_pixel(const Scene& scene, const ObjectSet& candidates, const Camera& camera, const int width, const int height, const int x, const int y,
+                    SurfaceHit* hit) {
+        const vec3 direction {normalize(camera.direction(x - width / 2, height / 2 - y, width, height))};
+        if (scene.needs_sampling()) {
+            if (hit != nullptr) {
+                std::shared_ptr<Objects::IRenderable> object;
+                closest_interaction(Ray(camera.position, direction), 1.0f, INFINITY, candidates, hit->t, object);
+                hit->object = object.get();
+            }
+            return sample_pixel(scene, candidates, camera, width, height, x, y);
+        }
+        return trace_ray(Ray(camera.position, direction), 1.0f, INFINITY, scene, candidates, 0, nullptr, hit);
+    }
+
+    void render_tile(const Scene& scene, const ObjectSet& candidates, const Camera& camera, const int width, const int height, const Tile& tile, RGB* framebuffer, const int first_row) {
+        if (scene.needs_sampling()) {
+            for (int y {tile.y0}; y < tile.y1; ++y) {
+                RGB* row {framebuffer + static_cast<std::size_t>(y - first_row) * width};
+                for (int x {tile.x0}; x < tile.x1; ++x) row[x] = sample_pixel(scene, candidates, camera, width, height, x, y);
+            }
+            return;
+        }
+
+        for (int y {tile.y0}; y < tile.y1; ++y) {
+            const int y_canvas {height / 2 - y};
+            RGB* row {framebuffer + static_cast<std::size_t>(y - first_row) * width};
+            for (int x {tile.x0}; x < tile.x1; ++x) {
+                const int x_canvas {x - width / 2};
+                const vec3 direction {normalize(camera.direction(x_canvas, y_canvas, width, height))};
+                row[x] = trace_ray(Ray(camera.position, direction), 1.0f, INFINITY, scene, candidates, 0);
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Full-frame render
+    // -----------------------------------------------------------------------------
+
+    std::vector<RGB> render(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool, const int tile_size) {
+        std::vector<RGB> framebuffer(static_cast<std::size_t>(width) * height);
+        render_into(scene, camera, width, height, pool, framebuffer, tile_size);
+        return framebuffer;
+    }
+
+    void render_into(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool, const std::span<RGB> framebuffer,
+                     const int tile_size) {
+        if (framebuffer.size() != static_cast<std::size_t>(width) * height) throw std::invalid_argument("framebuffer does not hold width * height pixels");
+        const std::vector<Tile> tiles {make_tiles(width, height, tile_size)};
+
+        pool.parallel_for(tiles.size(), [&](const std::size_t i) {
+            render_tile(scene, camera, width, height, tiles[i], framebuffer.data());
+        });
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_RENDERER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_RENDERER_HPP
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include "RayTracing/RayTracing.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief Pinhole camera: eye position plus an orthonormal view basis.
+     *
+     * The default camera sits at the origin looking down +z, which reproduces
+     * the original fixed viewpoint of canvas_to_viewport.
+     */
+    struct Camera {
+        glm::vec3 position {0.0f, 0.0f, 0.0f};
+        glm::vec3 right    {1.0f, 0.0f, 0.0f};
+        glm::vec3 up       {0.0f, 1.0f, 0.0f};
+        glm::vec3 forward  {0.0f, 0.0f, 1.0f};
+        float viewport_width  {1.0f};
+        float viewport_height {1.0f};
+        float projection_distance {1.0f};
+
+        /// Camera at eye looking at target, with world +y as the up hint.
+        static Camera look_at(const glm::vec3& eye, const glm::vec3& target, const glm::vec3& up_hint = {0, 1, 0});
+
+        /// World-space direction (unnormalized) through canvas pixel (x, y) of a Cw x Ch canvas.
+        glm::vec3 direction(int x_canvas, int y_canvas, int Cw, int Ch) const;
+
+        /// Same mapping for a sub-pixel canvas position (used for supersampling).
+        glm::vec3 direction(float x_canvas, float y_canvas, int Cw, int Ch) const;
+    };
+
+    /// Half-open pixel rectangle [x0, x1) x [y0, y1).
+    struct Tile {
+        int x0, y0, x1, y1;
+    };
+
+    /// Split a width x height image into row-major tiles of at most tile_size pixels per side.
+    std::vector<Tile> make_tiles(int width, int height, int tile_size);
+
+    /**
+     * @brief Collect the objects a tile's primary rays can possibly hit.
+     *
+     * The tile frustum is the pyramid from the camera through its corner pixels
+     * (padded by half a pixel). Spheres are tested exactly against its four side
+     * planes, other objects by their bounding boxes; unbounded objects (planes)
+     * are always kept. Returns the set to trace against: out, or the scene's
+     * own set when its hierarchy already skips what the tile cannot reach.
+     */
+    const ObjectSet& cull_for_tile(const Scene& scene, const Camera& camera, int width, int height, const Tile& tile, ObjectSet& out);
+
+    /**
+     * @brief Adaptively supersampled color of pixel (x, y), for scenes that need sampling.
+     *
+     * Samples follow scene.get_sampling(); the result depends only on the
+     * seed and the pixel, so any tiling or thread count gives the same image.
+     * sample_count (if given) receives the number of samples taken.
+     */
+    RGB sample_pixel(const Scene& scene, const ObjectSet& candidates, const Camera& camera, int width, int height, int x, int y,
+                     int* sample_count = nullptr);
+
+    /// Color of pixel (x, y) exactly as render() produces it (through sample_pixel when the scene needs sampling); hit (if given) receives what the ray through its center hits.
+    RGB trace_pixel(const Scene& scene, const ObjectSet& candidates, const Camera& camera, int width, int height, int x, int y, SurfaceHit* hit = nullptr);
+
+    /**
+     * @brief Trace every pixel of a tile into framebuffer (row-major, stride = width).
+     *
+     * Image row y lands in framebuffer row y - first_row, so a caller holding
+     * only a band of rows starting at first_row can render straight into it.
+     * Scenes with area lights or glossy materials go through sample_pixel.
+     */
+    void render_tile(const Scene& scene, const Camera& camera, int width, int height, const Tile& tile, RGB* framebuffer, int first_row = 0);
+    void render_tile(const Scene& scene, const ObjectSet& candidates, const Camera& camera, int width, int height, const Tile& tile, RGB* framebuffer, int first_row = 0);
+
+    /// Render a full image by distributing tiles over the pool.
+    std::vector<RGB> render(const Scene& scene, const Camera& camera, int width, int height, ThreadPool& pool, int tile_size = 32);
+
+    /**
+     * @brief render() into width * height pixels the caller owns.
+     *
+     * Nothing is written before a worker traces a tile, so the untouched
+     * pages of a Memory::PageBuffer are first touched (and placed on a NUMA
+     * node) by the threads that render them.
+     */
+    void render_into(const Scene& scene, const Camera& camera, int width, int height, ThreadPool& pool, std::span<RGB> framebuffer, int tile_size = 32);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_RENDERER_HPP
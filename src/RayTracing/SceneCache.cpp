@@ -0,0 +1,42 @@
+#include "RayTracing/SceneCache.hpp"
+
+namespace RayTracing {
+
+    SceneCache::SceneCache(const std::size_t capacity_, Loader loader_)
+        : capacity(capacity_ == 0 ? 1 : capacity_), loader(std::move(loader_)) {}
+
+    std::shared_ptr<const Scene> SceneCache::get(const std::string& id, bool* was_cached) {
+        {
+            std::lock_guard lock(mutex);
+            if (const auto it {index.find(id)}; it != index.end()) {
+                entries.splice(entries.begin(), entries, it->second);
+                if (was_cached) *was_cached = true;
+                return it->second->second;
+            }
+        }
+
+        // Load outside the lock so other scenes stay available meanwhile
+        std::shared_ptr<const Scene> scene {loader(id)};
+        if (was_cached) *was_cached = false;
+
+        std::lock_guard lock(mutex);
+        if (const auto it {index.find(id)}; it != index.end()) {
+            // Someone else loaded it first; keep theirs
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->second;
+        }
+
+        entries.emplace_front(id, scene);
+        index[id] = entries.begin();
+        while (entries.size() > capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        return scene;
+    }
+
+    std::size_t SceneCache::size() const {
+        std::lock_guard lock(mutex);
+        return entries.size();
+    }
+}
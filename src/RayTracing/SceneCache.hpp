@@ -0,0 +1,44 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_SCENECACHE_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_SCENECACHE_HPP
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "RayTracing/RayTracing.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief Thread-safe LRU cache of compiled scenes keyed by scene id.
+     *
+     * A Scene is immutable once built (its kernel arrays are flattened in the
+     * constructor), so cached entries are handed out as shared_ptr<const Scene>
+     * and stay valid for in-flight jobs even after eviction.
+     */
+    class SceneCache {
+    public:
+        using Loader = std::function<std::shared_ptr<const Scene>(const std::string& id)>;
+
+        SceneCache(std::size_t capacity_, Loader loader_);
+
+        /// Return the scene for id, loading it (and evicting the least recently used entry) on a miss.
+        std::shared_ptr<const Scene> get(const std::string& id, bool* was_cached = nullptr);
+
+        std::size_t size() const;
+        std::size_t get_capacity() const { return capacity; }
+
+    private:
+        using Entry = std::pair<std::string, std::shared_ptr<const Scene>>;
+
+        std::size_t capacity;
+        Loader loader;
+        std::list<Entry> entries;   // most recently used first
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        mutable std::mutex mutex;
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_SCENECACHE_HPP
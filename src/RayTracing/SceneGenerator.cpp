@@ -0,0 +1,163 @@
+#include "RayTracing/SceneGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <glm/glm.hpp>
+#include "RayTracing/SceneLoader.hpp"
+
+namespace RayTracing {
+
+    using namespace glm;
+
+    namespace {
+        // std::mt19937's sequence is fixed by the standard, the std distributions' are not;
+        // these keep generated scenes identical across standard libraries.
+        class Random {
+            std::mt19937 engine;
+
+        public:
+            explicit Random(const std::uint32_t seed) : engine(seed) {}
+
+            // Uniform in [lo, hi)
+            float uniform(const float lo = 0.0f, const float hi = 1.0f) {
+                return lo + (hi - lo) * static_cast<float>(engine() >> 8) * (1.0f / 16777216.0f);
+            }
+
+            int integer(const int lo, const int hi) { return std::min(hi, lo + static_cast<int>(uniform() * static_cast<float>(hi - lo + 1))); }
+
+            // Standard normal (Box-Muller)
+            float normal() {
+                const float u1 {std::max(uniform(), 1e-7f)};
+                const float u2 {uniform()};
+                return std::sqrt(-2.0f * std::log(u1)) * std::cos(6.2831853f * u2);
+            }
+
+            vec3 unit_vector() {
+                for (;;) {
+                    const vec3 v {uniform(-1, 1), uniform(-1, 1), uniform(-1, 1)};
+                    if (const float l2 {dot(v, v)}; l2 > 1e-4f && l2 <= 1.0f) return v / std::sqrt(l2);
+                }
+            }
+        };
+
+        std::vector<vec3> place(const GeneratorOptions& options, const vec3& centre, const float half, const float spacing, Random& random) {
+            const std::size_t n {options.object_count()};
+            std::vector<vec3> positions;
+            positions.reserve(n);
+
+            switch (options.layout) {
+                case Layout::Uniform:
+                    for (std::size_t i {0}; i < n; ++i) {
+                        positions.push_back(centre + vec3(random.uniform(-half, half), random.uniform(-half, half), random.uniform(-half, half)));
+                    }
+                    break;
+
+                case Layout::Clustered: {
+                    const std::size_t cluster_count {std::max<std::size_t>(1, n / 64)};
+                    std::vector<vec3> clusters;
+                    for (std::size_t c {0}; c < cluster_count; ++c) {
+                        clusters.push_back(centre + vec3(random.uniform(-half, half), random.uniform(-half, half), random.uniform(-half, half)));
+                    }
+                    for (std::size_t i {0}; i < n; ++i) {
+                        const vec3 offset {random.normal(), random.normal(), random.normal()};
+                        positions.push_back(clusters[i % cluster_count] + offset * (1.5f * spacing));
+                    }
+                    break;
+                }
+
+                case Layout::Grid: {
+                    const std::size_t side {static_cast<std::size_t>(std::ceil(std::cbrt(static_cast<double>(n))))};
+                    for (std::size_t i {0}; i < n; ++i) {
+                        const vec3 cell {static_cast<float>(i % side), static_cast<float>(i / side % side), static_cast<float>(i / side / side)};
+                        positions.push_back(centre - vec3(half) + (cell + 0.5f) * spacing);
+                    }
+                    break;
+                }
+            }
+            return positions;
+        }
+    }
+
+    std::optional<Layout> parse_layout(const std::string_view name) {
+        if (name == "uniform") return Layout::Uniform;
+        if (name == "clustered") return Layout::Clustered;
+        if (name == "grid") return Layout::Grid;
+        return std::nullopt;
+    }
+
+    std::string to_string(const Layout layout) {
+        switch (layout) {
+            case Layout::Uniform: return "uniform";
+            case Layout::Clustered: return "clustered";
+            case Layout::Grid: return "grid";
+        }
+        return "unknown";
+    }
+
+    void write_generated_scene(std::ostream& out, const GeneratorOptions& options) {
+        Random random(options.seed);
+        const std::size_t n {std::max<std::size_t>(1, options.object_count())};
+
+        // Box of side 2*half holding n cells of size spacing, in front of the camera
+        const float half {std::max(3.0f, 1.5f * static_cast<float>(std::cbrt(static_cast<double>(n))))};
+        const float spacing {2.0f * half / static_cast<float>(std::ceil(std::cbrt(static_cast<double>(n))))};
+        const vec3 centre {0.0f, 0.0f, 2.0f + 2.5f * half};
+        const float size {0.35f * spacing};
+
+        out << "# Generated: " << options.spheres << " spheres, " << options.cylinders << " cylinders, " << options.tori
+            << " tori, layout " << to_string(options.layout) << ", " << options.point_lights << " point lights, seed " << options.seed << "\n";
+
+        const auto new_material = [&] {
+            std::ostringstream m;
+            const float reflectivity {random.uniform() < options.reflective_fraction ? random.uniform(0.1f, 0.8f) : 0.0f};
+            constexpr int speculars[] {-1, 10, 100, 500};
+            m << random.integer(0, 255) << " " << random.integer(0, 255) << " " << random.integer(0, 255) << "  "
+              << speculars[random.integer(0, 3)] << " " << reflectivity;
+            return m.str();
+        };
+        // A bounded palette keeps the material table small however many objects there are
+        std::vector<std::string> palette;
+        for (std::size_t i {0}; i < options.materials; ++i) palette.push_back(new_material());
+        const auto material = [&] {
+            return palette.empty() ? new_material() : palette[static_cast<std::size_t>(random.integer(0, static_cast<int>(palette.size()) - 1))];
+        };
+        const auto triple = [](const vec3& v) {
+            std::ostringstream t;
+            t << v.x << " " << v.y << " " << v.z;
+            return t.str();
+        };
+
+        const std::vector<vec3> positions {place(options, centre, half, spacing, random)};
+        std::size_t next {0};
+        for (std::size_t i {0}; i < options.spheres; ++i) {
+            out << "sphere " << material() << "  " << triple(positions[next++]) << "  " << size << "\n";
+        }
+        for (std::size_t i {0}; i < options.cylinders; ++i) {
+            const vec3 axis {random.unit_vector()};
+            const vec3 base {positions[next++] - axis * size};
+            out << "cylinder " << material() << "  " << triple(axis) << "  " << triple(base) << "  " << 0.5f * size << " " << 2.0f * size << "\n";
+        }
+        for (std::size_t i {0}; i < options.tori; ++i) {
+            out << "torus " << material() << "  " << triple(random.unit_vector()) << "  " << triple(positions[next++]) << "  "
+                << 0.7f * size << " " << 0.25f * size << "\n";
+        }
+        if (options.floor) {
+            out << "plane 200 200 200  100 0  0 1 0  0 " << -(half + 2.0f * spacing) << " 0\n";
+        }
+
+        out << "ambient 0.2\n";
+        const float intensity {0.8f / static_cast<float>(std::max<std::size_t>(1, options.point_lights))};
+        for (std::size_t i {0}; i < options.point_lights; ++i) {
+            const vec3 p {centre + vec3(random.uniform(-2 * half, 2 * half), half + random.uniform(1.0f, half), random.uniform(-2 * half, half))};
+            out << "point " << intensity << "  " << triple(p) << "\n";
+        }
+    }
+
+    Scene generate_scene(const GeneratorOptions& options, ThreadPool* pool) {
+        std::stringstream text;
+        write_generated_scene(text, options);
+        return parse_scene(text, "<generated>", pool);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_SCENEGENERATOR_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_SCENEGENERATOR_HPP
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "RayTracing/RayTracing.hpp"
+
+namespace RayTracing {
+
+    /// How generated primitives are placed.
+    enum class Layout {
+        Uniform,    // uniformly random in a box in front of the camera
+        Clustered,  // Gaussian clumps of ~64 objects around random centres
+        Grid,       // regular cubic lattice
+    };
+
+    std::optional<Layout> parse_layout(std::string_view name);
+    std::string to_string(Layout layout);
+
+    struct GeneratorOptions {
+        std::size_t spheres {100};
+        std::size_t cylinders {0};
+        std::size_t tori {0};
+        Layout layout {Layout::Uniform};
+        std::size_t point_lights {1};         // plus one ambient light
+        float reflective_fraction {0.2f};     // share of objects with reflectivity in [0.1, 0.8]
+        std::size_t materials {64};           // distinct materials objects draw from (0: a new one per object)
+        bool floor {true};                    // add a matte floor plane under everything
+        std::uint32_t seed {1};
+
+        std::size_t object_count() const { return spheres + cylinders + tori; }
+    };
+
+    /**
+     * @brief Write a procedural stress scene in the SceneLoader text format.
+     *
+     * The volume grows with the cube root of the object count so density
+     * (and the size of each primitive) stays roughly constant; it sits in front
+     * of the default camera, partly outside the view so culling has work to
+     * do. Point lights share a total intensity of 0.8 regardless of their
+     * number. Output depends only on the options, including the seed.
+     */
+    void write_generated_scene(std::ostream& out, const GeneratorOptions& options);
+
+    /// The scene write_generated_scene describes, parsed in memory (and compiled on pool if given).
+    Scene generate_scene(const GeneratorOptions& options, ThreadPool* pool = nullptr);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_SCENEGENERATOR_HPP
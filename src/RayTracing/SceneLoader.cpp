@@ -0,0 +1,326 @@
+#include "RayTracing/SceneLoader.hpp"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Objects/Cone.hpp"
+#include "Objects/Cylinder.hpp"
+#include "Objects/Ellipsoid.hpp"
+#include "Objects/Instance.hpp"
+#include "Objects/Light.hpp"
+#include "Objects/Plane.hpp"
+#include "Objects/Sphere.hpp"
+#include "Objects/Torus.hpp"
+#include "Utilities/Arena.hpp"
+
+namespace RayTracing {
+
+    namespace {
+        struct Material {
+            RGB color;
+            int specular;
+            float reflectivity;
+        };
+
+        Material read_material(std::istream& in) {
+            int r, g, b, specular;
+            float reflectivity;
+            in >> r >> g >> b >> specular >> reflectivity;
+            return {RGB(r, g, b), specular, reflectivity};
+        }
+
+        glm::vec3 read_vec3(std::istream& in) {
+            float x, y, z;
+            in >> x >> y >> z;
+            return {x, y, z};
+        }
+
+        // A scene's objects share one arena, so they sit together in a few (huge) pages
+        template <class T, class... Args>
+        std::shared_ptr<T> make_object(const std::shared_ptr<Memory::Arena>& arena, Args&&... args) {
+            return std::allocate_shared<T>(Memory::ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+        }
+
+        bool is_primitive(const std::string& kind) {
+            return kind == "sphere" || kind == "plane" || kind == "cylinder" || kind == "cone" || kind == "ellipsoid" || kind == "torus";
+        }
+
+        // Parse the rest of a primitive line; nullptr when kind is not a primitive
+        std::shared_ptr<Objects::IRenderable> read_primitive(const std::string& kind, std::istream& ls, const std::shared_ptr<Memory::Arena>& arena) {
+            if (kind == "sphere") {
+                const Material m {read_material(ls)};
+                const glm::vec3 center {read_vec3(ls)};
+                float radius;
+                ls >> radius;
+                return make_object<Objects::Sphere>(arena, m.color, m.specular, m.reflectivity, center, radius);
+            }
+            if (kind == "plane") {
+                const Material m {read_material(ls)};
+                const glm::vec3 normal {read_vec3(ls)};
+                const glm::vec3 point {read_vec3(ls)};
+                return make_object<Objects::Plane>(arena, m.color, m.specular, m.reflectivity, normal, point);
+            }
+            if (kind == "cylinder") {
+                const Material m {read_material(ls)};
+                const glm::vec3 axis {read_vec3(ls)};
+                const glm::vec3 base {read_vec3(ls)};
+                float radius, height;
+                ls >> radius >> height;
+                return make_object<Objects::Cylinder>(arena, base, radius, height, m.color, m.specular, m.reflectivity, axis);
+            }
+            if (kind == "cone") {
+                const Material m {read_material(ls)};
+                const glm::vec3 axis {read_vec3(ls)};
+                const glm::vec3 apex {read_vec3(ls)};
+                float half_angle, height;
+                ls >> half_angle >> height;
+                return make_object<Objects::Cone>(arena, apex, axis, half_angle * 3.14159265358979323846f / 180.0f, height, m.color, m.specular, m.reflectivity);
+            }
+            if (kind == "ellipsoid") {
+                const Material m {read_material(ls)};
+                const glm::vec3 center {read_vec3(ls)};
+                const glm::vec3 radii {read_vec3(ls)};
+                return make_object<Objects::Ellipsoid>(arena, center, radii, m.color, m.specular, m.reflectivity);
+            }
+            if (kind == "torus") {
+                const Material m {read_material(ls)};
+                const glm::vec3 axis {read_vec3(ls)};
+                const glm::vec3 center {read_vec3(ls)};
+                float major, minor;
+                ls >> major >> minor;
+                return make_object<Objects::Torus>(arena, center, major, minor, m.color, m.specular, m.reflectivity, axis);
+            }
+            return nullptr;
+        }
+
+        // Rotation by degrees about axis (Rodrigues), as a column-major matrix
+        glm::mat3 rotation(const glm::vec3& axis_in, const float degrees) {
+            const glm::vec3 a {glm::normalize(axis_in)};
+            const float radians {degrees * 3.14159265358979323846f / 180.0f};
+            const float c {std::cos(radians)};
+            const float s {std::sin(radians)};
+            const float k {1.0f - c};
+            return {
+                glm::vec3(c + k * a.x * a.x,       k * a.x * a.y + s * a.z, k * a.x * a.z - s * a.y),
+                glm::vec3(k * a.x * a.y - s * a.z, c + k * a.y * a.y,       k * a.y * a.z + s * a.x),
+                glm::vec3(k * a.x * a.z + s * a.y, k * a.y * a.z - s * a.x, c + k * a.z * a.z)
+            };
+        }
+
+        // Optional "glossy <glossiness>" after a primitive's values
+        void read_finish(std::istream& ls, Objects::IRenderable& object) {
+            if (!ls) return;
+            std::string word;
+            if (!(ls >> word)) {
+                ls.clear(std::ios::eofbit);     // nothing after the values
+                return;
+            }
+            if (word != "glossy") throw std::runtime_error("unexpected '" + word + "' after primitive values");
+            float glossiness;
+            ls >> glossiness;
+            if (ls) object.set_glossiness(glossiness);
+        }
+
+        // instance <name> [translate x y z] [rotate ax ay az degrees] [scale sx sy sz] [material r g b specular reflectivity] [glossy g]
+        std::shared_ptr<Objects::IRenderable> read_instance(
+            std::istream& ls,
+            const std::unordered_map<std::string, std::shared_ptr<const Objects::IRenderable>>& prototypes,
+            const std::shared_ptr<Memory::Arena>& arena
+        ) {
+            std::string name;
+            ls >> name;
+            const auto found {prototypes.find(name)};
+            if (found == prototypes.end()) {
+                throw std::runtime_error("instance of undefined prototype '" + name + "'");
+            }
+
+            // Operations apply to the prototype in the order written
+            glm::mat3 linear {1.0f};
+            glm::vec3 translation {0.0f};
+            bool has_material {false};
+            bool has_glossiness {false};
+            Material m {};
+            float glossiness {0.0f};
+            for (std::string op; ls >> op;) {
+                if (op == "translate") {
+                    translation = translation + read_vec3(ls);
+                } else if (op == "rotate") {
+                    const glm::vec3 axis {read_vec3(ls)};
+                    float degrees;
+                    ls >> degrees;
+                    const glm::mat3 r {rotation(axis, degrees)};
+                    linear = r * linear;
+                    translation = r * translation;
+                } else if (op == "scale") {
+                    const glm::vec3 s {read_vec3(ls)};
+                    const glm::mat3 scale {glm::vec3(s.x, 0, 0), glm::vec3(0, s.y, 0), glm::vec3(0, 0, s.z)};
+                    linear = scale * linear;
+                    translation = scale * translation;
+                } else if (op == "material") {
+                    m = read_material(ls);
+                    has_material = true;
+                } else if (op == "glossy") {
+                    ls >> glossiness;
+                    has_glossiness = true;
+                } else {
+                    throw std::runtime_error("unknown instance option '" + op + "'");
+                }
+                if (!ls) return nullptr;    // reported as malformed by the caller
+            }
+            ls.clear();                     // running out of options is the normal end of the line
+
+            if (has_material || has_glossiness) {
+                Objects::Material material {has_material ? Objects::Material{m.color, m.specular, m.reflectivity} : found->second->get_material()};
+                if (has_glossiness) material.glossiness = glossiness;
+                std::shared_ptr<Objects::Instance> instance {make_object<Objects::Instance>(arena, found->second, linear, translation)};
+                instance->set_material(material);
+                return instance;
+            }
+            return make_object<Objects::Instance>(arena, found->second, linear, translation);
+        }
+    }
+
+    Scene load_scene(const std::string& path, ThreadPool* pool) {
+        std::ifstream ifs(path);
+        if (!ifs) {
+            throw std::runtime_error("Cannot open scene file '" + path + "'");
+        }
+        return parse_scene(ifs, path, pool);
+    }
+
+    Scene parse_scene(std::istream& in, const std::string& source_name, ThreadPool* pool) {
+        using Clock = std::chrono::steady_clock;
+        const auto ms_since = [](const Clock::time_point since) { return std::chrono::duration<double, std::milli>(Clock::now() - since).count(); };
+        const Clock::time_point read_start {Clock::now()};
+
+        std::vector<std::shared_ptr<Objects::IRenderable>> objects;
+        std::vector<std::shared_ptr<Objects::Light>> lights;
+        std::unordered_map<std::string, std::shared_ptr<const Objects::IRenderable>> prototypes;
+        std::optional<SamplingSettings> sampling;
+        const std::shared_ptr<Memory::Arena> arena {std::make_shared<Memory::Arena>()};
+
+        // Primitive lines only keep their place here; they are parsed after the read, in parallel
+        struct PrimitiveLine {
+            int line_number;
+            std::string kind;
+            std::string_view values;            // the rest of the line
+            std::size_t slot;                   // in objects
+        };
+        std::vector<PrimitiveLine> primitive_lines;
+        std::ostringstream buffer;
+        buffer << in.rdbuf();
+        const std::string text {std::move(buffer).str()};
+        const auto located = [&](const int line_number, const std::string& what) { return source_name + ":" + std::to_string(line_number) + ": " + what; };
+        std::optional<std::pair<int, std::string>> failure;     // first malformed line of the read, if any
+
+        std::size_t begin {0};
+        for (int line_number {1}; begin < text.size() && !failure; ++line_number) {
+            const std::size_t end {std::min(text.find('\n', begin), text.size())};
+            std::string_view line {std::string_view(text).substr(begin, end - begin)};
+            begin = end + 1;
+            if (const auto hash {line.find('#')}; hash != std::string_view::npos) line = line.substr(0, hash);
+
+            constexpr std::string_view SPACE {" \t\n\v\f\r"};
+            const std::size_t kind_begin {line.find_first_not_of(SPACE)};
+            if (kind_begin == std::string_view::npos) continue;
+            const std::size_t kind_end {std::min(line.find_first_of(SPACE, kind_begin), line.size())};
+            const std::string kind {line.substr(kind_begin, kind_end - kind_begin)};
+            if (is_primitive(kind)) {
+                primitive_lines.push_back({line_number, kind, line.substr(kind_end), objects.size()});
+                objects.emplace_back();
+                continue;
+            }
+
+            std::istringstream ls {std::string(line.substr(kind_end))};
+            try {
+                if (kind == "define") {
+                    std::string name, primitive_kind;
+                    ls >> name >> primitive_kind;
+                    auto prototype {read_primitive(primitive_kind, ls, arena)};
+                    if (prototype) read_finish(ls, *prototype);
+                    if (ls && !prototype) throw std::runtime_error("cannot define '" + name + "' as unknown primitive '" + primitive_kind + "'");
+                    if (ls && !prototypes.emplace(name, std::move(prototype)).second) throw std::runtime_error("prototype '" + name + "' is already defined");
+                } else if (kind == "instance") {
+                    auto instance {read_instance(ls, prototypes, arena)};
+                    if (instance) objects.push_back(std::move(instance));
+                    else ls.setstate(std::ios::failbit);
+                } else if (kind == "ambient") {
+                    float intensity;
+                    ls >> intensity;
+                    if (ls) lights.emplace_back(std::make_shared<Objects::AmbientLight>(intensity));
+                } else if (kind == "point") {
+                    float intensity;
+                    ls >> intensity;
+                    const glm::vec3 position {read_vec3(ls)};
+                    if (ls) lights.emplace_back(std::make_shared<Objects::PointLight>(intensity, position));
+                } else if (kind == "directional") {
+                    float intensity;
+                    ls >> intensity;
+                    const glm::vec3 direction {read_vec3(ls)};
+                    if (ls) lights.emplace_back(std::make_shared<Objects::DirectionalLight>(intensity, direction));
+                } else if (kind == "area") {
+                    float intensity;
+                    ls >> intensity;
+                    const glm::vec3 corner {read_vec3(ls)};
+                    const glm::vec3 edge_u {read_vec3(ls)};
+                    const glm::vec3 edge_v {read_vec3(ls)};
+                    if (ls) lights.emplace_back(std::make_shared<Objects::AreaLight>(intensity, corner, edge_u, edge_v));
+                } else if (kind == "sampling") {
+                    SamplingSettings settings;
+                    ls >> settings.seed >> settings.min_samples >> settings.max_samples >> settings.tolerance;
+                    if (ls) sampling = settings;
+                } else {
+                    throw std::runtime_error("unknown entry '" + kind + "'");
+                }
+                if (!ls) failure = {line_number, "missing or malformed values for '" + kind + "'"};
+            } catch (const std::exception& e) {
+                failure = {line_number, e.what()};
+            }
+        }
+        const double read_ms {ms_since(read_start)};
+
+        // Parsing and constant setup (normalised axes, torus bases) of the primitives read so far; errors are kept per line
+        const Clock::time_point primitives_start {Clock::now()};
+        std::vector<std::string> errors(primitive_lines.size());
+        for_each_chunk(pool, primitive_lines.size(), 1024, [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t i {first}; i < last; ++i) {
+                const std::string& kind {primitive_lines[i].kind};
+                std::istringstream ls {std::string(primitive_lines[i].values)};
+                try {
+                    auto primitive {read_primitive(kind, ls, arena)};
+                    read_finish(ls, *primitive);
+                    if (!ls) errors[i] = "missing or malformed values for '" + kind + "'";
+                    else objects[primitive_lines[i].slot] = std::move(primitive);
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
+                }
+            }
+        });
+        const double primitives_ms {ms_since(primitives_start)};
+
+        // The earliest malformed line is reported, as if the file had been read in one pass
+        for (std::size_t i {0}; i < primitive_lines.size(); ++i) {
+            if (errors[i].empty()) continue;
+            if (!failure || primitive_lines[i].line_number < failure->first) failure = {primitive_lines[i].line_number, errors[i]};
+            break;
+        }
+        if (failure) throw std::runtime_error(located(failure->first, failure->second));
+
+        Scene scene {objects, lights, pool};
+        scene.add_load_times(read_ms, primitives_ms);
+        try {
+            if (sampling) scene.set_sampling(*sampling);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(source_name + ": " + e.what());
+        }
+        return scene;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_SCENELOADER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_SCENELOADER_HPP
+#include <istream>
+#include <string>
+#include "RayTracing/RayTracing.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief Parse a plain-text scene description.
+     *
+     * One primitive or light per line; '#' starts a comment. Materials come first
+     * (color 0-255, specular exponent, reflectivity), then geometry:
+     *
+     *   sphere      r g b  specular reflectivity  cx cy cz  radius
+     *   plane       r g b  specular reflectivity  nx ny nz  px py pz
+     *   cylinder    r g b  specular reflectivity  ax ay az  bx by bz  radius height
+     *   cone        r g b  specular reflectivity  ax ay az  px py pz  half_angle_degrees height   (axis from apex p to base)
+     *   ellipsoid   r g b  specular reflectivity  cx cy cz  rx ry rz
+     *   torus       r g b  specular reflectivity  ax ay az  cx cy cz  major minor
+     *   ambient     intensity
+     *   point       intensity  x y z
+     *   directional intensity  x y z
+     *   area        intensity  cx cy cz  ux uy uz  vx vy vz    (corner and two edges)
+     *
+     * Any primitive line may end with "glossy g" to blur its reflections
+     * (0 = mirror, 1 = widest lobe). Area lights and glossy materials are
+     * rendered with adaptive supersampling, tuned by an optional line
+     * (default: seed 1, 16 to 64 samples per pixel, tolerance 2):
+     *
+     *   sampling    seed  min_samples max_samples  tolerance
+     *
+     * Repeated geometry is declared once and placed many times. A definition
+     * takes any primitive line and is not rendered itself; each instance shares
+     * it and applies its transform steps in the order written, optionally with
+     * its own material:
+     *
+     *   define      name  <primitive line>
+     *   instance    name  [translate x y z] [rotate ax ay az degrees] [scale sx sy sz]
+     *                     [material r g b specular reflectivity] [glossy g]
+     *
+     * When a pool is given, primitive lines are parsed on it after the file
+     * is read, and the scene is compiled on it (see ObjectSet::build).
+     *
+     * @throws std::runtime_error on unreadable files or malformed lines (with line number).
+     */
+    Scene load_scene(const std::string& path, ThreadPool* pool = nullptr);
+    Scene parse_scene(std::istream& in, const std::string& source_name = "<stream>", ThreadPool* pool = nullptr);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_SCENELOADER_HPP
@@ -0,0 +1,189 @@
+#include "RayTracing/SharedFramebuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RayTracing {
+
+    namespace {
+        constexpr std::size_t align64(const std::size_t n) { return (n + 63) & ~std::size_t{63}; }
+
+        std::string segment_name(const std::string& name) {
+            return name.starts_with('/') ? name : "/" + name;
+        }
+
+        std::runtime_error system_failure(const std::string& what, const std::string& name) {
+            return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+        }
+
+        // Readers map the segment read-only; atomic_ref needs a non-const referent but only loads through it
+        template <typename T>
+        T load_acquire(const T& value) {
+            return std::atomic_ref<T>(const_cast<T&>(value)).load(std::memory_order_acquire);
+        }
+    }
+
+    // --- Writer ---
+    SharedFramebuffer::SharedFramebuffer(const std::string& name_, const int width_, const int height_, const int tile_size_)
+        : name(segment_name(name_)), width(width_), height(height_), tile_size(std::max(1, tile_size_)),
+          tiles(static_cast<std::size_t>((width_ + tile_size - 1) / tile_size) * ((height_ + tile_size - 1) / tile_size)) {
+        const std::size_t bitmap_offset {align64(sizeof(SharedFramebufferHeader))};
+        const std::size_t pixels_offset {bitmap_offset + align64((tiles + 7) / 8)};
+        mapping_size = pixels_offset + static_cast<std::size_t>(width) * height * sizeof(RGB);
+        charge = Memory::Charge(Memory::Subsystem::Pixels, mapping_size, "shared framebuffer");
+
+        const int fd {::shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+        if (fd < 0) throw system_failure("cannot create shared framebuffer", name);
+        if (::ftruncate(fd, static_cast<off_t>(mapping_size)) < 0) {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw system_failure("cannot size shared framebuffer", name);
+        }
+
+        mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);    // the mapping keeps the segment
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            ::shm_unlink(name.c_str());
+            throw system_failure("cannot map shared framebuffer", name);
+        }
+
+        auto* base {static_cast<unsigned char*>(mapping)};
+        header = reinterpret_cast<SharedFramebufferHeader*>(base);
+        bitmap = base + bitmap_offset;
+        framebuffer = reinterpret_cast<RGB*>(base + pixels_offset);
+
+        // The segment is zero-filled: frame 0, nothing done. The magic goes in
+        // last so a reader never accepts a half-initialised header.
+        header->width = static_cast<std::uint32_t>(width);
+        header->height = static_cast<std::uint32_t>(height);
+        header->tile_size = static_cast<std::uint32_t>(tile_size);
+        header->pixel_size = static_cast<std::uint32_t>(sizeof(RGB));
+        header->tile_count = tiles;
+        header->bitmap_offset = bitmap_offset;
+        header->pixels_offset = pixels_offset;
+        header->segment_size = mapping_size;
+        header->writer_pid = ::getpid();
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, SharedFramebufferHeader::MAGIC, sizeof(header->magic));
+    }
+
+    SharedFramebuffer::~SharedFramebuffer() {
+        if (mapping) ::munmap(mapping, mapping_size);
+        ::shm_unlink(name.c_str());
+    }
+
+    void SharedFramebuffer::begin_frame() {
+        for (std::size_t i {0}; i < (tiles + 7) / 8; ++i) {
+            std::atomic_ref<std::uint8_t>(bitmap[i]).store(0, std::memory_order_relaxed);
+        }
+        std::atomic_ref<std::uint32_t>(header->state).store(SharedFramebufferHeader::Rendering, std::memory_order_relaxed);
+        std::atomic_ref<std::uint64_t>(header->frame).fetch_add(1, std::memory_order_release);
+        std::atomic_ref<std::uint64_t>(header->generation).fetch_add(1, std::memory_order_release);
+    }
+
+    void SharedFramebuffer::mark_done(const std::size_t tile) {
+        // Release: the tile's pixels are in the segment before its bit is
+        std::atomic_ref<std::uint8_t>(bitmap[tile / 8]).fetch_or(static_cast<std::uint8_t>(1u << (tile % 8)), std::memory_order_release);
+        std::atomic_ref<std::uint64_t>(header->generation).fetch_add(1, std::memory_order_release);
+    }
+
+    void SharedFramebuffer::finish() {
+        std::atomic_ref<std::uint32_t>(header->state).store(SharedFramebufferHeader::Finished, std::memory_order_relaxed);
+        std::atomic_ref<std::uint64_t>(header->generation).fetch_add(1, std::memory_order_release);
+    }
+
+    // --- Reader ---
+    SharedFramebufferReader::SharedFramebufferReader(const std::string& name_) {
+        const std::string name {segment_name(name_)};
+        const int fd {::shm_open(name.c_str(), O_RDONLY, 0)};
+        if (fd < 0) throw system_failure("cannot open shared framebuffer", name);
+
+        struct stat st {};
+        if (::fstat(fd, &st) < 0) {
+            ::close(fd);
+            throw system_failure("cannot stat shared framebuffer", name);
+        }
+        mapping_size = static_cast<std::size_t>(st.st_size);
+        if (mapping_size < sizeof(SharedFramebufferHeader)) {
+            ::close(fd);
+            throw std::runtime_error("shared framebuffer " + name + " is not initialised yet");
+        }
+
+        mapping = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            throw system_failure("cannot map shared framebuffer", name);
+        }
+
+        const auto* base {static_cast<const unsigned char*>(mapping)};
+        header = reinterpret_cast<const SharedFramebufferHeader*>(base);
+        const bool published {std::memcmp(header->magic, SharedFramebufferHeader::MAGIC, sizeof(header->magic)) == 0};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!published || header->pixel_size != sizeof(RGB) || header->segment_size != mapping_size
+            || header->pixels_offset + static_cast<std::size_t>(header->width) * header->height * sizeof(RGB) > mapping_size) {
+            ::munmap(mapping, mapping_size);
+            throw std::runtime_error("shared framebuffer " + name + " is not initialised or has an unknown layout");
+        }
+        bitmap = base + header->bitmap_offset;
+        framebuffer = reinterpret_cast<const RGB*>(base + header->pixels_offset);
+    }
+
+    SharedFramebufferReader::~SharedFramebufferReader() {
+        if (mapping) ::munmap(mapping, mapping_size);
+    }
+
+    std::uint64_t SharedFramebufferReader::frame() const { return load_acquire(header->frame); }
+    std::uint64_t SharedFramebufferReader::generation() const { return load_acquire(header->generation); }
+
+    SharedFramebufferHeader::State SharedFramebufferReader::state() const {
+        return static_cast<SharedFramebufferHeader::State>(load_acquire(header->state));
+    }
+
+    std::size_t SharedFramebufferReader::done_count() const {
+        std::size_t count {0};
+        for (std::size_t i {0}; i < (tile_count() + 7) / 8; ++i) {
+            count += static_cast<std::size_t>(std::popcount(load_acquire(bitmap[i])));
+        }
+        return count;
+    }
+
+    bool SharedFramebufferReader::is_done(const std::size_t tile) const {
+        return load_acquire(bitmap[tile / 8]) & (1u << (tile % 8));
+    }
+
+    bool SharedFramebufferReader::writer_alive() const {
+        return ::kill(static_cast<pid_t>(header->writer_pid), 0) == 0 || errno == EPERM;
+    }
+
+    std::uint64_t SharedFramebufferReader::snapshot(std::vector<RGB>& out) const {
+        const std::uint64_t observed {generation()};
+        out.assign(framebuffer, framebuffer + static_cast<std::size_t>(get_width()) * get_height());
+        return observed;
+    }
+
+    // --- Rendering ---
+    std::vector<RGB> render_to_shared(const Scene& scene, const Camera& camera, ThreadPool& pool, SharedFramebuffer& shared) {
+        const int width {shared.get_width()};
+        const int height {shared.get_height()};
+        const std::vector<Tile> tiles {make_tiles(width, height, shared.get_tile_size())};
+
+        shared.begin_frame();
+        pool.parallel_for(tiles.size(), [&](const std::size_t i) {
+            render_tile(scene, camera, width, height, tiles[i], shared.pixels());
+            shared.mark_done(i);
+        });
+        shared.finish();
+
+        return {shared.pixels(), shared.pixels() + static_cast<std::size_t>(width) * height};
+    }
+}
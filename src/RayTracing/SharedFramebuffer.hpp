@@ -0,0 +1,126 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_SHAREDFRAMEBUFFER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_SHAREDFRAMEBUFFER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "Utilities/MemoryAccounting.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /**
+     * @brief Layout of a shared-memory framebuffer segment.
+     *
+     * The segment holds this header, a completion bitmap with one bit per
+     * tile (row-major, as make_tiles) and the width x height RGB pixels, each
+     * part 64-byte aligned. frame, generation, state and the bitmap are only
+     * accessed atomically; the rest is written once before the segment is
+     * published.
+     */
+    struct SharedFramebufferHeader {
+        static constexpr char MAGIC[8] {'R', 'T', 'S', 'H', 'M', 'F', 'B', '1'};
+
+        enum State : std::uint32_t { Idle = 0, Rendering = 1, Finished = 2 };
+
+        char magic[8];
+        std::uint32_t width, height, tile_size, pixel_size;
+        std::uint64_t tile_count;
+        std::uint64_t bitmap_offset, pixels_offset, segment_size;
+        std::int64_t writer_pid;
+        std::uint64_t frame;        // bumped when a new frame starts (bitmap cleared)
+        std::uint64_t generation;   // bumped after every finished tile and state change
+        std::uint32_t state;
+    };
+
+    /**
+     * @brief Writer side: a framebuffer in a POSIX shared-memory segment.
+     *
+     * Tiles are traced straight into the segment, so publishing costs one
+     * atomic OR and one atomic add per finished tile and nothing else; readers
+     * never take a lock the renderer waits on. A reader may see a tile half
+     * written, but its bit is set (release) only after its pixels are.
+     *
+     * The name is unlinked on destruction; readers that still have it mapped
+     * keep the final image.
+     */
+    class SharedFramebuffer {
+    public:
+        /// Create (replacing any stale segment of the same name) and map; a missing leading '/' is added.
+        SharedFramebuffer(const std::string& name, int width, int height, int tile_size);
+        ~SharedFramebuffer();
+
+        SharedFramebuffer(const SharedFramebuffer&) = delete;
+        SharedFramebuffer& operator=(const SharedFramebuffer&) = delete;
+
+        // Getters
+        const std::string& get_name() const { return name; }
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+        int get_tile_size() const { return tile_size; }
+        std::size_t tile_count() const { return tiles; }
+        RGB* pixels() const { return framebuffer; }
+
+        /// Clear the completion bitmap and start a new frame (pixels are kept until overwritten).
+        void begin_frame();
+        void mark_done(std::size_t tile);
+        void finish();
+
+    private:
+        std::string name;
+        int width, height, tile_size;
+        std::size_t tiles;
+        void* mapping {nullptr};
+        std::size_t mapping_size {0};
+        SharedFramebufferHeader* header {nullptr};
+        std::uint8_t* bitmap {nullptr};
+        RGB* framebuffer {nullptr};
+        Memory::Charge charge;
+    };
+
+    /**
+     * @brief Read-only view of a segment published by a SharedFramebuffer, possibly in another process.
+     */
+    class SharedFramebufferReader {
+    public:
+        /// @throws std::runtime_error if the segment does not exist or is not a framebuffer
+        explicit SharedFramebufferReader(const std::string& name);
+        ~SharedFramebufferReader();
+
+        SharedFramebufferReader(const SharedFramebufferReader&) = delete;
+        SharedFramebufferReader& operator=(const SharedFramebufferReader&) = delete;
+
+        // Getters
+        int get_width() const { return static_cast<int>(header->width); }
+        int get_height() const { return static_cast<int>(header->height); }
+        int get_tile_size() const { return static_cast<int>(header->tile_size); }
+        std::size_t tile_count() const { return header->tile_count; }
+
+        std::uint64_t frame() const;
+        std::uint64_t generation() const;
+        SharedFramebufferHeader::State state() const;
+        std::size_t done_count() const;
+        bool is_done(std::size_t tile) const;
+
+        /// False once the writing process has exited (cleanly or not).
+        bool writer_alive() const;
+
+        /// Copy the pixels into out; returns the generation observed before copying.
+        std::uint64_t snapshot(std::vector<RGB>& out) const;
+
+    private:
+        void* mapping {nullptr};
+        std::size_t mapping_size {0};
+        const SharedFramebufferHeader* header {nullptr};
+        const std::uint8_t* bitmap {nullptr};
+        const RGB* framebuffer {nullptr};
+    };
+
+    /// render() that traces into a shared framebuffer so external viewers can follow progress.
+    std::vector<RGB> render_to_shared(const Scene& scene, const Camera& camera, ThreadPool& pool, SharedFramebuffer& shared);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_SHAREDFRAMEBUFFER_HPP
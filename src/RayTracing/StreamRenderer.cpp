@@ -0,0 +1,107 @@
+#include "RayTracing/StreamRenderer.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "Utilities/Kernels.hpp"
+#include "Utilities/MemoryAccounting.hpp"
+
+namespace RayTracing {
+
+    namespace {
+        // One reorder-window entry: a band's traced pixels and their PPM bytes
+        struct Slot {
+            std::vector<RGB> pixels;
+            std::vector<unsigned char> bytes;
+            std::size_t byte_count {0};
+            bool ready {false};
+        };
+    }
+
+    namespace {
+        std::size_t resolve_window(const std::size_t window, const std::size_t band_count, const ThreadPool& pool) {
+            const std::size_t requested {window == 0 ? 2 * (static_cast<std::size_t>(pool.size()) + 1) : window};
+            return std::max<std::size_t>(1, std::min(requested, band_count));
+        }
+    }
+
+    std::size_t stream_buffer_bytes(const int width, const int height, const int band_height, const std::size_t window, const ThreadPool& pool) {
+        const int rows {std::max(1, band_height)};
+        const std::size_t band_count {static_cast<std::size_t>((height + rows - 1) / rows)};
+        return resolve_window(window, band_count, pool) * static_cast<std::size_t>(width) * rows * (sizeof(RGB) + 3);
+    }
+
+    StreamStats render_ppm_stream(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool,
+                                  std::ostream& out, const int band_height, std::size_t window) {
+        const int rows {std::max(1, band_height)};
+        const std::size_t band_count {static_cast<std::size_t>((height + rows - 1) / rows)};
+        const std::size_t band_pixels {static_cast<std::size_t>(width) * rows};
+        window = resolve_window(window, band_count, pool);
+
+        const Memory::Charge charge(Memory::Subsystem::Pixels, window * band_pixels * (sizeof(RGB) + 3), "stream window");
+        std::vector<Slot> slots(window);
+        for (Slot& slot : slots) {
+            slot.pixels.resize(band_pixels);
+            slot.bytes.resize(band_pixels * 3);
+        }
+
+        out << "P6\n" << width << " " << height << "\n255\n";
+
+        std::mutex mutex;
+        std::condition_variable slot_freed;
+        std::size_t next_to_write {0};
+        bool writing {false};
+        bool failed {!out};
+
+        pool.parallel_for(band_count, [&](const std::size_t band) {
+            // Bands are claimed in order, so the oldest unwritten band is always
+            // being traced by someone who is not waiting here.
+            {
+                std::unique_lock lock(mutex);
+                slot_freed.wait(lock, [&] { return band < next_to_write + window; });
+            }
+
+            Slot& slot {slots[band % window]};
+            const int y0 {static_cast<int>(band) * rows};
+            const int y1 {std::min(y0 + rows, height)};
+            for (int x0 {0}; x0 < width; x0 += rows) {
+                render_tile(scene, camera, width, height, {x0, y0, std::min(x0 + rows, width), y1}, slot.pixels.data(), y0);
+            }
+            const std::size_t pixels {static_cast<std::size_t>(y1 - y0) * width};
+            Kernels::active().tonemap_rgb8(reinterpret_cast<const int*>(slot.pixels.data()), pixels, slot.bytes.data());
+
+            // A single writer drains every ready band in order; writes happen outside the lock
+            std::unique_lock lock(mutex);
+            slot.byte_count = pixels * 3;
+            slot.ready = true;
+            if (writing) return;
+            writing = true;
+            while (next_to_write < band_count && slots[next_to_write % window].ready) {
+                Slot& head {slots[next_to_write % window]};
+                lock.unlock();
+                if (!failed) {
+                    out.write(reinterpret_cast<const char*>(head.bytes.data()), static_cast<std::streamsize>(head.byte_count));
+                    failed = !out;
+                }
+                lock.lock();
+                head.ready = false;
+                ++next_to_write;
+                slot_freed.notify_all();
+            }
+            writing = false;
+        });
+
+        out.flush();
+        if (failed || !out) throw std::runtime_error("failed to write streamed image");
+        return {band_count, window, window * band_pixels * (sizeof(RGB) + 3)};
+    }
+
+    StreamStats render_ppm_file(const Scene& scene, const Camera& camera, const int width, const int height, ThreadPool& pool,
+                                const std::string& filename, const int band_height, const std::size_t window) {
+        std::ofstream ofs(filename, std::ios::binary);
+        if (!ofs) throw std::runtime_error("cannot open " + filename + " for writing");
+        return render_ppm_stream(scene, camera, width, height, pool, ofs, band_height, window);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_STREAMRENDERER_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_STREAMRENDERER_HPP
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /// What a streaming render did, for logging.
+    struct StreamStats {
+        std::size_t bands {0};
+        std::size_t window {0};        // bands that may be in flight at once
+        std::size_t buffer_bytes {0};  // pixel memory held by the reorder window
+    };
+
+    /**
+     * @brief Render straight to a binary PPM without holding the whole frame.
+     *
+     * The image is cut into full-width bands of band_height rows. Bands are
+     * traced in parallel (each split into culled tiles, like render()) and
+     * handed to the output strictly top to bottom through a reorder window of
+     * window bands; a worker that runs too far ahead of the oldest unwritten
+     * band waits for a free slot. Peak pixel memory is therefore
+     * window x width x band_height x 15 bytes, independent of the image height.
+     * window = 0 picks two bands per thread. Pixels are identical to render().
+     *
+     * Throws std::runtime_error if the stream fails, Memory::BudgetExceeded if
+     * the window does not fit the memory budget.
+     */
+    StreamStats render_ppm_stream(const Scene& scene, const Camera& camera, int width, int height, ThreadPool& pool,
+                                  std::ostream& out, int band_height = 32, std::size_t window = 0);
+
+    /// Pixel memory render_ppm_stream holds with these settings (StreamStats::buffer_bytes, known in advance).
+    std::size_t stream_buffer_bytes(int width, int height, int band_height, std::size_t window, const ThreadPool& pool);
+
+    /// render_ppm_stream into a file.
+    StreamStats render_ppm_file(const Scene& scene, const Camera& camera, int width, int height, ThreadPool& pool,
+                                const std::string& filename, int band_height = 32, std::size_t window = 0);
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_STREAMRENDERER_HPP
@@ -0,0 +1,224 @@
+#include "RayTracing/TemporalReprojector.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace RayTracing {
+
+    using namespace glm;
+
+    namespace {
+        constexpr std::uint64_t NO_SAMPLE {~std::uint64_t {0}};
+
+        enum class Fate : std::uint8_t { Reused, Disoccluded, Rejected, Refreshed };
+
+        // Spreads a pixel's place in the refresh rotation over the image
+        std::uint32_t scramble(std::uint32_t i) {
+            i ^= i >> 16;
+            i *= 0x7feb352du;
+            i ^= i >> 15;
+            i *= 0x846ca68bu;
+            i ^= i >> 16;
+            return i;
+        }
+
+        float depth_of(const std::uint64_t key) {
+            return std::bit_cast<float>(static_cast<std::uint32_t>(key >> 32));
+        }
+
+        // Ray parameter from which origin + s * direction lies in what camera saw: beyond its projection plane, within its viewport
+        float seen_from(const Camera& camera, const vec3& origin, const vec3& direction) {
+            const vec3 q {origin - camera.position};
+            const float qx {dot(q, camera.right)}, qy {dot(q, camera.up)}, qz {dot(q, camera.forward)};
+            const float dx {dot(direction, camera.right)}, dy {dot(direction, camera.up)}, dz {dot(direction, camera.forward)};
+            const float half_x {0.5f * camera.viewport_width / camera.projection_distance};
+            const float half_y {0.5f * camera.viewport_height / camera.projection_distance};
+
+            // The view is convex, so the ray enters it where it last crosses into one of its bounds (a + s * b >= 0)
+            const std::pair<float, float> bounds[] {
+                {half_x * qz - qx, half_x * dz - dx}, {half_x * qz + qx, half_x * dz + dx},
+                {half_y * qz - qy, half_y * dz - dy}, {half_y * qz + qy, half_y * dz + dy},
+                {qz - camera.projection_distance, dz}};
+            float s {0.0f};
+            for (const auto& [a, b] : bounds) {
+                if (a >= 0.0f) continue;
+                if (!(b > 0.0f)) return INFINITY;
+                s = std::max(s, -a / b);
+            }
+            return s;
+        }
+    }
+
+    TemporalReprojector::TemporalReprojector(const int width_, const int height_, const ReprojectionSettings& settings_)
+        : width(width_), height(height_), settings(settings_) {
+        if (width <= 0 || height <= 0) throw std::invalid_argument("reprojection needs a non-empty image");
+        if (!(settings.refresh_fraction >= 0.0f && settings.refresh_fraction <= 1.0f) || !(settings.max_view_angle >= 0.0f) || !(settings.depth_tolerance >= 0.0f)) {
+            throw std::invalid_argument("reprojection needs 0 <= refresh_fraction <= 1, max_view_angle >= 0 and depth_tolerance >= 0");
+        }
+        const std::size_t pixels {static_cast<std::size_t>(width) * height};
+        charge = Memory::Charge(Memory::Subsystem::Pixels, pixels * (2 * sizeof(Sample) + sizeof(std::uint64_t) + sizeof(std::uint8_t)), "temporal history");
+        history.resize(pixels);
+        current.resize(pixels);
+        nearest = std::vector<std::atomic<std::uint64_t>>(pixels);
+        fates.resize(pixels);
+    }
+
+    void TemporalReprojector::reset() {
+        history_scene.reset();
+    }
+
+    std::vector<RGB> TemporalReprojector::render(const std::shared_ptr<const Scene>& scene_, const Camera& camera, ThreadPool& pool, const int tile_size) {
+        const Scene& scene {*scene_};
+        const std::size_t pixels {static_cast<std::size_t>(width) * height};
+        const auto columns {static_cast<std::size_t>(width)};
+        // A scene freed since the last frame has expired, whatever now lives at its address
+        const bool reproject {history_scene.lock() == scene_};
+        const std::uint32_t period {settings.refresh_fraction > 0.0f ? std::max(1u, static_cast<std::uint32_t>(std::lround(1.0f / settings.refresh_fraction))) : 0u};
+
+        // Project every kept sample into the new camera; the nearest one landing in a pixel wins
+        if (reproject) {
+            const float x_scale {camera.projection_distance * static_cast<float>(width) / camera.viewport_width};
+            const float y_scale {camera.projection_distance * static_cast<float>(height) / camera.viewport_height};
+            pool.parallel_for(static_cast<std::size_t>(height), [&](const std::size_t row) {
+                for (std::size_t i {row * columns}; i < (row + 1) * columns; ++i) nearest[i].store(NO_SAMPLE, std::memory_order_relaxed);
+            });
+            pool.parallel_for(static_cast<std::size_t>(height), [&](const std::size_t row) {
+                for (std::size_t i {row * columns}; i < (row + 1) * columns; ++i) {
+                    const Sample& sample {history[i]};
+                    const vec3 q {sample.object != nullptr ? sample.position - camera.position : sample.position};
+                    const float z {dot(q, camera.forward)};
+                    if (!(z > 0.0f)) continue;
+
+                    // Inverse of Camera::direction, rounded to the pixel whose ray passes nearest
+                    const float x {std::floor(dot(q, camera.right) / z * x_scale + 0.5f) + static_cast<float>(width / 2)};
+                    const float y {static_cast<float>(height / 2) - std::floor(dot(q, camera.up) / z * y_scale + 0.5f)};
+                    if (!(x >= 0.0f && x < static_cast<float>(width) && y >= 0.0f && y < static_cast<float>(height))) continue;
+
+                    const float depth {sample.object != nullptr ? length(q) : INFINITY};
+                    const std::uint64_t key {static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(depth)) << 32 | i};
+                    std::atomic<std::uint64_t>& slot {nearest[static_cast<std::size_t>(y) * columns + static_cast<std::size_t>(x)]};
+                    std::uint64_t seen {slot.load(std::memory_order_relaxed)};
+                    while (key < seen && !slot.compare_exchange_weak(seen, key, std::memory_order_relaxed)) {}
+                }
+            });
+        }
+
+        // Decide per pixel whether the sample that landed there can be reused
+        const float min_view_cosine {std::cos(settings.max_view_angle)};
+        const auto key_at = [&](const int x, const int y) {
+            return nearest[static_cast<std::size_t>(y) * columns + static_cast<std::size_t>(x)].load(std::memory_order_relaxed);
+        };
+        const auto judge = [&](const int x, const int y) {
+            if (!reproject) return Fate::Disoccluded;
+            const std::uint64_t key {key_at(x, y)};
+            if (key == NO_SAMPLE) return Fate::Disoccluded;
+            const Sample& sample {history[static_cast<std::uint32_t>(key)]};
+            const auto i {static_cast<std::uint32_t>(static_cast<std::size_t>(y) * columns + static_cast<std::size_t>(x))};
+            if (period > 0 && ((scramble(i) + frame) % period == 0 || sample.age + 1 >= 2 * period)) return Fate::Refreshed;
+
+            // Neighbours that got a sample must hold the same object, and this sample must not lie behind both of them along an axis
+            const float depth {depth_of(key)};
+            for (const auto& [dx, dy] : {std::pair {1, 0}, std::pair {0, 1}}) {
+                int sides {0};
+                float farthest {0.0f};
+                for (const int side : {-1, 1}) {
+                    const int nx {x + side * dx}, ny {y + side * dy};
+                    if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+                    const std::uint64_t neighbour {key_at(nx, ny)};
+                    if (neighbour == NO_SAMPLE) continue;
+                    if (history[static_cast<std::uint32_t>(neighbour)].object != sample.object) return Fate::Rejected;
+                    ++sides;
+                    farthest = std::max(farthest, depth_of(neighbour));
+                }
+                if (sides == 2 && depth > (1.0f + settings.depth_tolerance) * farthest) return Fate::Rejected;
+            }
+
+            if (sample.object != nullptr) {
+                const vec3 to_eye {camera.position - sample.position};
+                if (dot(sample.normal, to_eye) <= 0.0f) return Fate::Rejected;
+                const Objects::Material& material {sample.object->get_material()};
+                if ((material.specular != -1 || material.reflectivity > 0.0f)
+                    && dot(normalize(to_eye), normalize(sample.shaded_from - sample.position)) < min_view_cosine) return Fate::Rejected;
+            }
+
+            // Geometry the previous frame could not see (off its edges, or before its projection plane) may now cover the sample
+            const vec3 direction {camera.direction(x - width / 2, height / 2 - y, width, height)};
+            float reach {seen_from(history_camera, camera.position, direction)};
+            if (sample.object != nullptr) reach = std::min(reach, (1.0f - settings.depth_tolerance) * depth / length(direction));
+            if (reach > 1.0f) {
+                float t;
+                std::shared_ptr<Objects::IRenderable> blocker;
+                closest_interaction(Ray(camera.position, direction), 1.0f, reach, scene, t, blocker);
+                if (blocker != nullptr) return Fate::Disoccluded;
+            }
+            return Fate::Reused;
+        };
+        pool.parallel_for(static_cast<std::size_t>(height), [&](const std::size_t row) {
+            const int y {static_cast<int>(row)};
+            for (int x {0}; x < width; ++x) {
+                const std::size_t i {row * columns + static_cast<std::size_t>(x)};
+                const Fate fate {judge(x, y)};
+                fates[i] = static_cast<std::uint8_t>(fate);
+                if (fate == Fate::Reused) {
+                    current[i] = history[static_cast<std::uint32_t>(key_at(x, y))];
+                    ++current[i].age;
+                }
+            }
+        });
+
+        // Trace the rest, keeping their primary hits for the next frame
+        const std::vector<Tile> tiles {make_tiles(width, height, tile_size)};
+        pool.parallel_for(tiles.size(), [&](const std::size_t t) {
+            const Tile& tile {tiles[t]};
+            bool any {false};
+            for (int y {tile.y0}; y < tile.y1 && !any; ++y) {
+                for (int x {tile.x0}; x < tile.x1; ++x) any = any || fates[static_cast<std::size_t>(y) * columns + x] != static_cast<std::uint8_t>(Fate::Reused);
+            }
+            if (!any) return;
+
+            ObjectSet culled;
+            const ObjectSet& candidates {cull_for_tile(scene, camera, width, height, tile, culled)};
+            for (int y {tile.y0}; y < tile.y1; ++y) {
+                for (int x {tile.x0}; x < tile.x1; ++x) {
+                    const std::size_t i {static_cast<std::size_t>(y) * columns + x};
+                    if (fates[i] == static_cast<std::uint8_t>(Fate::Reused)) continue;
+
+                    SurfaceHit hit;
+                    Sample& sample {current[i]};
+                    sample.color = trace_pixel(scene, candidates, camera, width, height, x, y, &hit);
+                    const vec3 direction {normalize(camera.direction(x - width / 2, height / 2 - y, width, height))};
+                    sample.object = hit.object;
+                    sample.shaded_from = camera.position;
+                    sample.age = 0;
+                    if (hit.object != nullptr) {
+                        sample.position = Ray(camera.position, direction).at(hit.t);
+                        const vec3 normal {hit.object->normal_at(sample.position)};
+                        sample.normal = dot(normal, direction) > 0.0f ? -normal : normal;
+                    } else {
+                        sample.position = direction;
+                    }
+                }
+            }
+        });
+
+        std::vector<RGB> framebuffer(pixels);
+        ReprojectionStats stats;
+        for (std::size_t i {0}; i < pixels; ++i) {
+            framebuffer[i] = current[i].color;
+            switch (static_cast<Fate>(fates[i])) {
+                case Fate::Reused: ++stats.reused; break;
+                case Fate::Disoccluded: ++stats.disoccluded; break;
+                case Fate::Rejected: ++stats.rejected; break;
+                case Fate::Refreshed: ++stats.refreshed; break;
+            }
+        }
+        last_stats = stats;
+        history.swap(current);
+        history_scene = scene_;
+        history_camera = camera;
+        ++frame;
+        return framebuffer;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef RAYTRACINGCPP_SRC_RAYTRACING_TEMPORALREPROJECTOR_HPP
+#define RAYTRACINGCPP_SRC_RAYTRACING_TEMPORALREPROJECTOR_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "Utilities/MemoryAccounting.hpp"
+#include "Utilities/RGB.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace RayTracing {
+
+    /// When a sample carried over from the previous frame may stand in for a traced pixel.
+    struct ReprojectionSettings {
+        float refresh_fraction {0.05f};     // share of pixels re-traced each frame regardless, on a rolling schedule (0 to 1)
+        float max_view_angle {0.07f};       // radians the view of a specular or reflective surface may turn before it is re-shaded (4 degrees)
+        float depth_tolerance {0.02f};      // how much farther than both neighbours on an axis a sample may be before it counts as seen through a gap
+    };
+
+    /// Where the pixels of a frame came from.
+    struct ReprojectionStats {
+        std::size_t reused {0};
+        std::size_t disoccluded {0};        // traced: no sample landed there (everything, on a first frame), or geometry unseen last frame may cover it
+        std::size_t rejected {0};           // traced: the sample failed a consistency check
+        std::size_t refreshed {0};          // traced: due on the rolling schedule
+
+        std::size_t traced() const { return disoccluded + rejected + refreshed; }
+    };
+
+    /**
+     * @brief Renders a camera sequence, reusing the previous frame's shading where it still holds.
+     *
+     * Each traced pixel keeps its primary hit: position, normal, object and
+     * color (a miss keeps its direction, as a point at infinity). The next
+     * frame projects every kept sample into the new camera, the nearest one
+     * winning each pixel, and reuses its color if the neighbours that got a
+     * sample all hold the same object as the pixel, the sample is not farther
+     * than both neighbours on an axis (a surface seen through a gap), still
+     * faces the camera and, on specular or reflective materials, is viewed
+     * within max_view_angle of where it was shaded. Where the camera moved,
+     * the part of the pixel's ray the previous frame could not see (beyond
+     * its edges or before its projection plane) must also hit nothing, so
+     * objects coming in from the edge are traced rather than covered by the
+     * background that was there. All other pixels, plus a rolling
+     * refresh_fraction of them, are traced as render() would.
+     *
+     * Samples keep their hit position, so reuse never drifts by more than
+     * half a pixel. The history refers to the scene's objects and lights and
+     * is kept only while that very scene is rendered: another scene, even one
+     * built where a freed one lived, starts afresh. After changing a scene in
+     * place, call reset(). The camera basis must be orthonormal (as from
+     * Camera::look_at).
+     */
+    class TemporalReprojector {
+    public:
+        /// @throws std::invalid_argument on settings outside their ranges, Memory::BudgetExceeded if the history does not fit the memory budget
+        TemporalReprojector(int width_, int height_, const ReprojectionSettings& settings_ = {});
+
+        /// Next frame of the sequence, as seen from camera.
+        std::vector<RGB> render(const std::shared_ptr<const Scene>& scene_, const Camera& camera, ThreadPool& pool, int tile_size = 32);
+
+        /// Forget the history: the next frame is traced in full.
+        void reset();
+
+        const ReprojectionStats& get_last_stats() const { return last_stats; }
+
+    private:
+        struct Sample {
+            glm::vec3 position {0.0f};              // primary hit, or the ray direction on a miss
+            glm::vec3 normal {0.0f};                // turned towards the eye it was shaded from
+            glm::vec3 shaded_from {0.0f};           // eye position when traced
+            const Objects::IRenderable* object {nullptr};    // null: background
+            RGB color;
+            std::uint32_t age {0};                  // frames since traced
+        };
+
+        int width;
+        int height;
+        ReprojectionSettings settings;
+        std::weak_ptr<const Scene> history_scene;   // whose objects the history refers to (expires with it)
+        Camera history_camera;                      // what the history was seen from
+        std::vector<Sample> history, current;
+        std::vector<std::atomic<std::uint64_t>> nearest;    // per pixel while projecting: depth bits << 32 | source pixel
+        std::vector<std::uint8_t> fates;                    // per pixel: reused, or why it is traced
+        std::uint32_t frame {0};
+        ReprojectionStats last_stats;
+        Memory::Charge charge;
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_RAYTRACING_TEMPORALREPROJECTOR_HPP
@@ -0,0 +1,236 @@
+// Renders generated scenes across object counts, layouts and thread counts and
+// writes one CSV row per run.
+//
+//   ScalingBench [--objects=100,1000,...] [--threads=1,2,...] [--layouts=uniform,clustered,grid]
+//                [--mix=spheres|mixed] [--lights=N] [--size=WxH] [--repeat=N] [--out=path]
+//                [--pages=default,transparent,explicit] [--bvh=binary,wide] [--materials=N]
+//
+// Thread counts default to powers of two up to the core count. Each run is the
+// best of --repeat renders; speedup and efficiency are relative to the run with
+// the fewest threads for the same scene, page policy and hierarchy format. Each
+// page policy rebuilds the scene (its arenas) and backs the framebuffer; dTLB
+// load misses per primary ray come from perf_event_open (empty where perf is
+// unavailable), and pages_speedup is the throughput relative to the first
+// listed policy. Likewise each hierarchy format rebuilds the scene;
+// hierarchy_bytes is the size of its nodes and bvh_speedup the throughput
+// relative to the first listed format. Objects draw from a palette of
+// --materials materials (default 64; 0 gives each object its own).
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "RayTracing/Bvh.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "RayTracing/SceneGenerator.hpp"
+#include "Utilities/Arena.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace {
+    std::vector<std::string> split(const std::string& text) {
+        std::vector<std::string> items;
+        std::istringstream in(text);
+        for (std::string item; std::getline(in, item, ',');) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    std::vector<std::size_t> split_numbers(const std::string& text) {
+        std::vector<std::size_t> numbers;
+        for (const std::string& item : split(text)) numbers.push_back(std::stoul(item));
+        return numbers;
+    }
+
+    // dTLB load misses of this thread and of threads it starts afterwards (they add theirs when they exit)
+    class TlbMissCounter {
+        int fd {-1};
+
+    public:
+        TlbMissCounter() {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+        ~TlbMissCounter() {
+            if (fd >= 0) close(fd);
+        }
+
+        TlbMissCounter(const TlbMissCounter&) = delete;
+        TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+        std::optional<std::uint64_t> read_count() const {
+            std::uint64_t count {0};
+            if (fd < 0 || read(fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return std::nullopt;
+            return count;
+        }
+    };
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::size_t> object_counts {10, 100, 1000};
+    std::vector<std::size_t> thread_counts;
+    std::vector<RayTracing::Layout> layouts {RayTracing::Layout::Uniform, RayTracing::Layout::Clustered, RayTracing::Layout::Grid};
+    bool mixed {false};
+    std::size_t lights {4};
+    int width {256};
+    int height {256};
+    int repeat {3};
+    std::string out_path;
+    std::vector<Memory::PagePolicy> page_policies {Memory::PagePolicy::Default};
+    std::vector<RayTracing::BvhFormat> formats {RayTracing::BvhFormat::Binary};
+    std::size_t materials {RayTracing::GeneratorOptions{}.materials};
+
+    try {
+        for (int i {1}; i < argc; ++i) {
+            const std::string_view arg {argv[i]};
+            const auto value = [&](const std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg.starts_with("--objects=")) {
+                object_counts = split_numbers(value("--objects="));
+            } else if (arg.starts_with("--threads=")) {
+                thread_counts = split_numbers(value("--threads="));
+            } else if (arg.starts_with("--layouts=")) {
+                layouts.clear();
+                for (const std::string& name : split(value("--layouts="))) {
+                    const auto layout {RayTracing::parse_layout(name)};
+                    if (!layout) throw std::invalid_argument("unknown layout '" + name + "'");
+                    layouts.push_back(*layout);
+                }
+            } else if (arg.starts_with("--mix=")) {
+                const std::string mix {value("--mix=")};
+                if (mix != "spheres" && mix != "mixed") throw std::invalid_argument("expected --mix=spheres|mixed");
+                mixed = mix == "mixed";
+            } else if (arg.starts_with("--lights=")) {
+                lights = std::stoul(value("--lights="));
+            } else if (arg.starts_with("--size=")) {
+                const std::string size {value("--size=")};
+                const std::size_t x {size.find('x')};
+                if (x == std::string::npos) throw std::invalid_argument("expected --size=WxH but got '" + size + "'");
+                width = std::stoi(size.substr(0, x));
+                height = std::stoi(size.substr(x + 1));
+            } else if (arg.starts_with("--repeat=")) {
+                repeat = std::max(1, std::stoi(value("--repeat=")));
+            } else if (arg.starts_with("--out=")) {
+                out_path = value("--out=");
+            } else if (arg.starts_with("--pages=")) {
+                page_policies.clear();
+                for (const std::string& name : split(value("--pages="))) {
+                    const auto policy {Memory::parse_page_policy(name)};
+                    if (!policy) throw std::invalid_argument("unknown page policy '" + name + "'");
+                    page_policies.push_back(*policy);
+                }
+            } else if (arg.starts_with("--bvh=")) {
+                formats.clear();
+                for (const std::string& name : split(value("--bvh="))) {
+                    const auto format {RayTracing::parse_bvh_format(name)};
+                    if (!format) throw std::invalid_argument("unknown hierarchy format '" + name + "'");
+                    formats.push_back(*format);
+                }
+            } else if (arg.starts_with("--materials=")) {
+                materials = std::stoul(value("--materials="));
+            } else {
+                throw std::invalid_argument("unknown option '" + std::string(arg) + "'");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (thread_counts.empty()) {
+        const std::size_t cores {std::max(1u, std::thread::hardware_concurrency())};
+        for (std::size_t t {1}; t < cores; t *= 2) thread_counts.push_back(t);
+        thread_counts.push_back(cores);
+    }
+    std::sort(thread_counts.begin(), thread_counts.end());
+
+    std::ofstream file;
+    if (!out_path.empty()) file.open(out_path);
+    std::ostream& csv {out_path.empty() ? std::cout : file};
+    csv << "layout,objects,lights,threads,width,height,seconds,primary_rays_per_second,speedup,efficiency,pages,dtlb_misses_per_ray,pages_speedup,bvh,hierarchy_bytes,bvh_speedup\n";
+
+    const std::size_t pixels {static_cast<std::size_t>(width) * height};
+    for (const RayTracing::Layout layout : layouts) {
+        for (const std::size_t objects : object_counts) {
+            RayTracing::GeneratorOptions options;
+            options.layout = layout;
+            options.point_lights = lights;
+            options.spheres = mixed ? objects - 2 * (objects / 3) : objects;
+            options.cylinders = mixed ? objects / 3 : 0;
+            options.tori = mixed ? objects / 3 : 0;
+            options.materials = materials;
+
+            std::map<std::pair<RayTracing::BvhFormat, std::size_t>, double> first_policy_seconds;    // by format and thread count
+            for (const Memory::PagePolicy policy : page_policies) {
+                std::map<std::size_t, double> first_format_seconds;    // by thread count
+                for (const RayTracing::BvhFormat format : formats) {
+                    Memory::set_page_policy(policy);
+                    RayTracing::set_bvh_format(format);
+                    const RayTracing::Scene scene {RayTracing::generate_scene(options)};
+                    Memory::PageBuffer<RGB> framebuffer(pixels);
+
+                    double baseline_seconds {0.0};
+                    std::size_t baseline_threads {0};
+                    for (const std::size_t threads : thread_counts) {
+                        const std::size_t workers {threads <= 1 ? 1 : threads};
+                        double best {1e300};
+                        const TlbMissCounter tlb_misses;     // before the pool, so its threads are counted too
+                        {
+                            // The pool's threads plus the calling thread make `threads` workers
+                            ThreadPool pool(static_cast<unsigned>(std::max<std::size_t>(1, threads - 1)));
+                            for (int r {0}; r < repeat; ++r) {
+                                const auto t0 {std::chrono::steady_clock::now()};
+                                if (workers == 1) {
+                                    // No helpers: trace every tile on this thread
+                                    for (const RayTracing::Tile& tile : RayTracing::make_tiles(width, height, 32)) {
+                                        RayTracing::render_tile(scene, RayTracing::Camera{}, width, height, tile, framebuffer.data());
+                                    }
+                                } else {
+                                    RayTracing::render_into(scene, RayTracing::Camera{}, width, height, pool, framebuffer.span());
+                                }
+                                best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+                            }
+                        }
+                        const std::optional<std::uint64_t> misses {tlb_misses.read_count()};
+
+                        if (baseline_threads == 0) {
+                            baseline_seconds = best;
+                            baseline_threads = workers;
+                        }
+                        const double speedup {baseline_seconds / best};
+                        const double first_policy {first_policy_seconds.emplace(std::pair {format, workers}, best).first->second};
+                        const double first_format {first_format_seconds.emplace(workers, best).first->second};
+                        csv << RayTracing::to_string(layout) << "," << objects << "," << lights << "," << workers << "," << width << "," << height << ","
+                            << best << "," << static_cast<double>(pixels) / best << "," << speedup << ","
+                            << speedup * static_cast<double>(baseline_threads) / static_cast<double>(workers) << ","
+                            << Memory::to_string(policy) << ",";
+                        if (misses) csv << static_cast<double>(*misses) / (static_cast<double>(pixels) * repeat);
+                        csv << "," << first_policy / best << "," << RayTracing::to_string(format) << "," << scene.get_build_stats().hierarchy_bytes << ","
+                            << first_format / best << "\n";
+                        csv.flush();
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Writes a procedural stress scene for RayTracer --scene=<file>.
+//
+//   SceneGen [--spheres=N] [--cylinders=N] [--tori=N] [--layout=uniform|clustered|grid]
+//            [--lights=N] [--reflective=F] [--materials=N] [--seed=N] [--no-floor] [--out=path]
+//
+// Objects draw from a palette of --materials materials (default 64; 0 gives
+// each object its own). Image resolution is a render option (RayTracer
+// --size=WxH), not part of the scene.
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "RayTracing/SceneGenerator.hpp"
+
+int main(int argc, char* argv[]) {
+    RayTracing::GeneratorOptions options;
+    std::string out_path;
+
+    try {
+        for (int i {1}; i < argc; ++i) {
+            const std::string_view arg {argv[i]};
+            const auto value = [&](const std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg.starts_with("--spheres=")) {
+                options.spheres = std::stoul(value("--spheres="));
+            } else if (arg.starts_with("--cylinders=")) {
+                options.cylinders = std::stoul(value("--cylinders="));
+            } else if (arg.starts_with("--tori=")) {
+                options.tori = std::stoul(value("--tori="));
+            } else if (arg.starts_with("--layout=")) {
+                const auto layout {RayTracing::parse_layout(arg.substr(9))};
+                if (!layout) throw std::invalid_argument("unknown layout '" + value("--layout=") + "'");
+                options.layout = *layout;
+            } else if (arg.starts_with("--lights=")) {
+                options.point_lights = std::stoul(value("--lights="));
+            } else if (arg.starts_with("--reflective=")) {
+                options.reflective_fraction = std::stof(value("--reflective="));
+            } else if (arg.starts_with("--materials=")) {
+                options.materials = std::stoul(value("--materials="));
+            } else if (arg.starts_with("--seed=")) {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value("--seed=")));
+            } else if (arg == "--no-floor") {
+                options.floor = false;
+            } else if (arg.starts_with("--out=")) {
+                out_path = value("--out=");
+            } else {
+                throw std::invalid_argument("unknown option '" + std::string(arg) + "'");
+            }
+        }
+
+        if (out_path.empty()) {
+            RayTracing::write_generated_scene(std::cout, options);
+        } else {
+            std::ofstream out(out_path);
+            RayTracing::write_generated_scene(out, options);
+            if (!out) throw std::runtime_error("failed to write " + out_path);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Follows a render published with RayTracer --shm=<name> and dumps previews.
+//
+//   ShmDump --shm=<name> [--out=preview.ppm] [--interval=<ms>] [--wait=<ms>] [--once]
+//
+// Every interval (default 250 ms) the image is rewritten if any tile finished
+// since the last dump; the file is replaced atomically so an image viewer that
+// reloads it never sees a partial write. Exits after the final image, or when
+// the renderer dies. --wait keeps retrying until the segment appears; --once
+// dumps whatever is there and exits.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "RayTracing/ImageWriter.hpp"
+#include "RayTracing/SharedFramebuffer.hpp"
+
+int main(int argc, char* argv[]) {
+    using Clock = std::chrono::steady_clock;
+    std::string name;
+    std::string out_path {"preview.ppm"};
+    std::chrono::milliseconds interval {250};
+    std::chrono::milliseconds wait {0};
+    bool once {false};
+
+    try {
+        for (int i {1}; i < argc; ++i) {
+            const std::string_view arg {argv[i]};
+            const auto value = [&](const std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg.starts_with("--shm=")) {
+                name = value("--shm=");
+            } else if (arg.starts_with("--out=")) {
+                out_path = value("--out=");
+            } else if (arg.starts_with("--interval=")) {
+                interval = std::chrono::milliseconds(std::stol(value("--interval=")));
+            } else if (arg.starts_with("--wait=")) {
+                wait = std::chrono::milliseconds(std::stol(value("--wait=")));
+            } else if (arg == "--once") {
+                once = true;
+            } else {
+                throw std::invalid_argument("unknown option '" + std::string(arg) + "'");
+            }
+        }
+        if (name.empty()) throw std::invalid_argument("expected --shm=<name>");
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    try {
+        // The renderer may not have created the segment yet
+        std::unique_ptr<RayTracing::SharedFramebufferReader> reader;
+        const Clock::time_point give_up {Clock::now() + wait};
+        while (!reader) {
+            try {
+                reader = std::make_unique<RayTracing::SharedFramebufferReader>(name);
+            } catch (const std::runtime_error&) {
+                if (Clock::now() >= give_up) throw;
+                std::this_thread::sleep_for(std::min(interval, std::chrono::milliseconds(50)));
+            }
+        }
+
+        const int width {reader->get_width()};
+        const int height {reader->get_height()};
+        const std::string temp_path {RayTracing::with_suffix(out_path, ".partial")};
+        std::vector<RGB> pixels;
+        std::uint64_t dumped {0};
+
+        const auto dump = [&] {
+            dumped = reader->snapshot(pixels);
+            RayTracing::save_image(temp_path, pixels, width, height);
+            if (std::rename(temp_path.c_str(), out_path.c_str()) != 0) throw std::runtime_error("cannot replace " + out_path);
+            std::cerr << "frame " << reader->frame() << ": " << reader->done_count() << "/" << reader->tile_count() << " tiles -> " << out_path << "\n";
+        };
+
+        if (once) {
+            dump();
+            return 0;
+        }
+
+        for (;;) {
+            // Read the state first: a Finished seen here means every tile is already in
+            const bool finished {reader->state() == RayTracing::SharedFramebufferHeader::Finished};
+            if (reader->generation() != dumped) dump();
+            if (finished) return 0;
+            if (!reader->writer_alive()) {
+                if (reader->state() == RayTracing::SharedFramebufferHeader::Finished) continue;    // finished just now
+                std::cerr << "Renderer exited before finishing\n";
+                return 1;
+            }
+            std::this_thread::sleep_for(interval);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_AABB_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_AABB_HPP
+#include <limits>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Axis-aligned bounding box.
+ *
+ * The default box is empty (min > max) so that expand() can start from it.
+ * Unbounded primitives such as planes report infinite().
+ */
+struct AABB {
+    glm::vec3 min { std::numeric_limits<float>::infinity()};
+    glm::vec3 max {-std::numeric_limits<float>::infinity()};
+
+    static AABB infinite() {
+        constexpr float inf {std::numeric_limits<float>::infinity()};
+        return {glm::vec3(-inf), glm::vec3(inf)};
+    }
+
+    bool is_empty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    bool is_finite() const {
+        constexpr float inf {std::numeric_limits<float>::infinity()};
+        return min.x > -inf && min.y > -inf && min.z > -inf && max.x < inf && max.y < inf && max.z < inf;
+    }
+
+    void expand(const glm::vec3& p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    void expand(const AABB& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extent() const { return max - min; }
+};
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_AABB_HPP
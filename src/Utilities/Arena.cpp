@@ -0,0 +1,130 @@
+#include "Utilities/Arena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <string>
+#include <sys/mman.h>
+
+namespace Memory {
+
+    namespace {
+        constexpr std::size_t SMALL_PAGE_SIZE {4096};
+        constexpr std::size_t SMALL_BLOCK_SIZE {64 * 1024};
+        std::atomic<PagePolicy> default_policy {PagePolicy::Default};
+
+        std::size_t round_up(const std::size_t bytes, const std::size_t multiple) {
+            return (bytes + multiple - 1) / multiple * multiple;
+        }
+
+        void* map_anonymous(const std::size_t bytes, const int extra_flags) {
+            void* data {mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0)};
+            return data == MAP_FAILED ? nullptr : data;
+        }
+
+        // Over-map by one huge page and trim both ends to a 2 MiB aligned range
+        void* map_aligned(const std::size_t bytes) {
+            auto* raw {static_cast<unsigned char*>(map_anonymous(bytes + HUGE_PAGE_SIZE, 0))};
+            if (raw == nullptr) return nullptr;
+            const auto address {reinterpret_cast<std::uintptr_t>(raw)};
+            auto* aligned {reinterpret_cast<unsigned char*>(round_up(address, HUGE_PAGE_SIZE))};
+            if (aligned > raw) munmap(raw, static_cast<std::size_t>(aligned - raw));
+            if (const std::size_t tail {static_cast<std::size_t>(raw + bytes + HUGE_PAGE_SIZE - (aligned + bytes))}; tail > 0) munmap(aligned + bytes, tail);
+            return aligned;
+        }
+    }
+
+    std::optional<PagePolicy> parse_page_policy(const std::string_view name) {
+        std::string lower(name);
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (lower == "default") return PagePolicy::Default;
+        if (lower == "transparent") return PagePolicy::Transparent;
+        if (lower == "explicit") return PagePolicy::Explicit;
+        return std::nullopt;
+    }
+
+    const char* to_string(const PagePolicy policy) {
+        switch (policy) {
+            case PagePolicy::Default:     return "default";
+            case PagePolicy::Transparent: return "transparent";
+            case PagePolicy::Explicit:    return "explicit";
+        }
+        return "?";
+    }
+
+    void set_page_policy(const PagePolicy policy) {
+        default_policy.store(policy, std::memory_order_relaxed);
+    }
+
+    PagePolicy get_page_policy() {
+        return default_policy.load(std::memory_order_relaxed);
+    }
+
+    // --- Page mappings ---
+    namespace {
+        std::size_t mapped_length(const std::size_t bytes, const PagePolicy policy) {
+            return round_up(std::max<std::size_t>(bytes, 1), policy == PagePolicy::Default ? SMALL_PAGE_SIZE : HUGE_PAGE_SIZE);
+        }
+    }
+
+    void* map_pages(const std::size_t bytes, const PagePolicy policy) {
+        const std::size_t length {mapped_length(bytes, policy)};
+        void* data {nullptr};
+        switch (policy) {
+            case PagePolicy::Default:
+                data = map_anonymous(length, 0);
+                break;
+            case PagePolicy::Explicit:
+                data = map_anonymous(length, MAP_HUGETLB);
+                if (data != nullptr) break;
+                [[fallthrough]];    // no reserved huge pages left
+            case PagePolicy::Transparent:
+                data = map_aligned(length);
+                if (data != nullptr) madvise(data, length, MADV_HUGEPAGE);
+                break;
+        }
+        if (data == nullptr) throw std::bad_alloc();
+        return data;
+    }
+
+    void unmap_pages(void* data, const std::size_t bytes, const PagePolicy policy) {
+        munmap(data, mapped_length(bytes, policy));
+    }
+
+    // --- Arena ---
+    Arena::Arena(const PagePolicy policy_) : policy(policy_) {}
+
+    Arena::~Arena() {
+        for (const Block& block : blocks) unmap_pages(block.data, block.bytes, policy);
+    }
+
+    void* Arena::allocate(const std::size_t bytes, const std::size_t alignment) {
+        std::lock_guard lock(mutex);
+        if (!blocks.empty()) {
+            const std::size_t offset {round_up(used, alignment)};
+            if (offset + bytes <= blocks.back().bytes) {
+                used = offset + bytes;
+                total_used += bytes;
+                return static_cast<unsigned char*>(blocks.back().data) + offset;
+            }
+        }
+
+        // Mappings start page-aligned, which covers any alignment a scene asks for
+        const std::size_t block_bytes {mapped_length(std::max(bytes, policy == PagePolicy::Default ? SMALL_BLOCK_SIZE : HUGE_PAGE_SIZE), policy)};
+        blocks.push_back({map_pages(block_bytes, policy), block_bytes});
+        used = bytes;
+        total_used += bytes;
+        return blocks.back().data;
+    }
+
+    std::size_t Arena::bytes_mapped() const {
+        std::lock_guard lock(mutex);
+        std::size_t total {0};
+        for (const Block& block : blocks) total += block.bytes;
+        return total;
+    }
+
+    std::size_t Arena::bytes_used() const {
+        std::lock_guard lock(mutex);
+        return total_used;
+    }
+}
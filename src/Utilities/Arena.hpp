@@ -0,0 +1,166 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_ARENA_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_ARENA_HPP
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Memory {
+
+    /// How page-backed memory (arenas, page buffers) asks the kernel for pages.
+    enum class PagePolicy : std::uint8_t {
+        Default,        // whatever the system's transparent huge page setting gives
+        Transparent,    // 2 MiB aligned and madvise(MADV_HUGEPAGE)
+        Explicit,       // MAP_HUGETLB from the reserved pool, Transparent if none is left
+    };
+
+    inline constexpr std::size_t HUGE_PAGE_SIZE {std::size_t {2} << 20};
+
+    /// Parse "default", "transparent" or "explicit"; nullopt otherwise.
+    std::optional<PagePolicy> parse_page_policy(std::string_view name);
+    const char* to_string(PagePolicy policy);
+
+    /// Policy of arenas and page buffers created without one (Default until set, e.g. by --huge-pages).
+    void set_page_policy(PagePolicy policy);
+    PagePolicy get_page_policy();
+
+    /**
+     * @brief Anonymous mapping of at least bytes (whole huge pages unless the policy is Default).
+     *
+     * Nothing is touched: each page is placed (on the NUMA node of the thread
+     * that first writes it) and zeroed on first use.
+     * @throws std::bad_alloc if the kernel refuses.
+     */
+    void* map_pages(std::size_t bytes, PagePolicy policy);
+
+    /// Undo map_pages(bytes, policy).
+    void unmap_pages(void* data, std::size_t bytes, PagePolicy policy);
+
+    /**
+     * @brief Bump allocator over page mappings; everything is freed with the arena.
+     *
+     * Blocks are whole huge pages (64 KiB or more of ordinary pages under the
+     * Default policy), so a scene's arrays and objects share a few TLB entries
+     * instead of being scattered over the heap. Untouched pages cost address
+     * space only. Thread-safe.
+     */
+    class Arena {
+    public:
+        explicit Arena(PagePolicy policy_ = get_page_policy());
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(std::size_t bytes, std::size_t alignment);
+
+        PagePolicy get_policy() const { return policy; }
+        std::size_t bytes_mapped() const;
+        std::size_t bytes_used() const;
+
+    private:
+        struct Block {
+            void* data;
+            std::size_t bytes;
+        };
+
+        PagePolicy policy;
+        mutable std::mutex mutex;
+        std::vector<Block> blocks;
+        std::size_t used {0};           // of the last block
+        std::size_t total_used {0};
+    };
+
+    /**
+     * @brief Standard allocator drawing from an Arena, or the heap without one.
+     *
+     * Deallocation into an arena is a no-op, so containers using it should be
+     * sized once. Copies share the arena, which lives as long as any of them
+     * (including those std::allocate_shared keeps in its control blocks).
+     */
+    template <class T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        ArenaAllocator() = default;
+        explicit ArenaAllocator(std::shared_ptr<Arena> arena_) : arena(std::move(arena_)) {}
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.get_arena()) {}
+
+        T* allocate(const std::size_t n) {
+            if (arena) return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t {alignof(T)}));
+        }
+
+        void deallocate(T* p, const std::size_t n) {
+            if (!arena) ::operator delete(p, n * sizeof(T), std::align_val_t {alignof(T)});
+        }
+
+        const std::shared_ptr<Arena>& get_arena() const { return arena; }
+
+        template <class U>
+        bool operator==(const ArenaAllocator<U>& other) const { return arena == other.get_arena(); }
+
+    private:
+        std::shared_ptr<Arena> arena;
+    };
+
+    /// Vector that lives in an arena when given an ArenaAllocator bound to one.
+    template <class T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    /**
+     * @brief Fixed-size page-mapped array whose elements are left unwritten.
+     *
+     * Unlike a std::vector nothing is zeroed up front, so each page lands on
+     * the node of the thread that first writes it, e.g. the worker rendering
+     * the tile that covers it.
+     */
+    template <class T>
+    class PageBuffer {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+
+    public:
+        PageBuffer() = default;
+        explicit PageBuffer(const std::size_t count_, const PagePolicy policy_ = get_page_policy())
+            : data_(count_ == 0 ? nullptr : static_cast<T*>(map_pages(count_ * sizeof(T), policy_))), count(count_), policy(policy_) {}
+        ~PageBuffer() {
+            if (data_ != nullptr) unmap_pages(data_, count * sizeof(T), policy);
+        }
+
+        PageBuffer(const PageBuffer&) = delete;
+        PageBuffer& operator=(const PageBuffer&) = delete;
+        PageBuffer(PageBuffer&& other) noexcept
+            : data_(std::exchange(other.data_, nullptr)), count(std::exchange(other.count, 0)), policy(other.policy) {}
+        PageBuffer& operator=(PageBuffer&& other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(count, other.count);
+            std::swap(policy, other.policy);
+            return *this;
+        }
+
+        T* data() { return data_; }
+        const T* data() const { return data_; }
+        std::size_t size() const { return count; }
+        std::span<T> span() { return {data_, count}; }
+        std::span<const T> span() const { return {data_, count}; }
+
+    private:
+        T* data_ {nullptr};
+        std::size_t count {0};
+        PagePolicy policy {PagePolicy::Default};
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_ARENA_HPP
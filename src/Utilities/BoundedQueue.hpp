@@ -0,0 +1,63 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_BOUNDEDQUEUE_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_BOUNDEDQUEUE_HPP
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * @brief Blocking FIFO with a fixed capacity, for handing work between pipeline stages.
+ *
+ * push() waits while the queue is full, which is what bounds the memory of a
+ * pipeline whose consumer is slower than its producer. After close(), push()
+ * fails and pop() drains what is left, then returns nullopt.
+ */
+template <typename T>
+class BoundedQueue {
+    std::deque<T> items;
+    std::size_t capacity;
+    bool closed {false};
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+
+public:
+    // Constructors
+    explicit BoundedQueue(const std::size_t capacity_) : capacity(capacity_ == 0 ? 1 : capacity_) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Wait for room, then append; false if the queue was closed.
+    bool push(T item) {
+        std::unique_lock lock(mutex);
+        not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    // Wait for an item; nullopt once the queue is closed and empty.
+    std::optional<T> pop() {
+        std::unique_lock lock(mutex);
+        not_empty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return std::nullopt;
+        T item {std::move(items.front())};
+        items.pop_front();
+        not_full.notify_one();
+        return item;
+    }
+
+    void close() {
+        {
+            std::lock_guard lock(mutex);
+            closed = true;
+        }
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+};
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_BOUNDEDQUEUE_HPP
@@ -0,0 +1,48 @@
+#include "Utilities/Cpu.hpp"
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace Cpu {
+
+    IsaLevel detect_isa_level() {
+    #if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        // __builtin_cpu_supports also checks XCR0, so AVX levels are only
+        // reported when the OS saves the wider register state.
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+            __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")) {
+            return IsaLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return IsaLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return IsaLevel::SSE42;
+        }
+    #endif
+        return IsaLevel::Scalar;
+    }
+
+    std::optional<IsaLevel> parse_isa_level(const std::string_view name) {
+        std::string lower(name);
+        std::ranges::transform(lower, lower.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (lower == "scalar" || lower == "none")               return IsaLevel::Scalar;
+        if (lower == "sse4.2" || lower == "sse42")              return IsaLevel::SSE42;
+        if (lower == "avx2")                                    return IsaLevel::AVX2;
+        if (lower == "avx512" || lower == "avx-512")            return IsaLevel::AVX512;
+        return std::nullopt;
+    }
+
+    const char* to_string(const IsaLevel level) {
+        switch (level) {
+            case IsaLevel::Scalar: return "scalar";
+            case IsaLevel::SSE42:  return "SSE4.2";
+            case IsaLevel::AVX2:   return "AVX2";
+            case IsaLevel::AVX512: return "AVX-512";
+        }
+        return "unknown";
+    }
+
+} // namespace Cpu
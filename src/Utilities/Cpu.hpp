@@ -0,0 +1,23 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_CPU_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_CPU_HPP
+#include <optional>
+#include <string_view>
+
+/// Host CPU feature detection used to pick which kernel build runs at startup.
+namespace Cpu {
+
+    /// Instruction-set levels the hot kernels are compiled for (ascending).
+    enum class IsaLevel { Scalar, SSE42, AVX2, AVX512 };
+
+    /// Highest level supported by the running CPU (and OS, for AVX state).
+    IsaLevel detect_isa_level();
+
+    /// Parse "scalar", "sse4.2", "avx2" or "avx512" (case-insensitive).
+    std::optional<IsaLevel> parse_isa_level(std::string_view name);
+
+    /// Human-readable name of a level, e.g. "AVX2".
+    const char* to_string(IsaLevel level);
+
+} // namespace Cpu
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_CPU_HPP
@@ -0,0 +1,50 @@
+#include "Utilities/Kernels.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+namespace Kernels {
+
+    namespace {
+        std::atomic<const KernelTable*> active_table {nullptr};
+
+        const KernelTable& table_for(const Cpu::IsaLevel level) {
+            switch (level) {
+                case Cpu::IsaLevel::AVX512: return avx512_table();
+                case Cpu::IsaLevel::AVX2:   return avx2_table();
+                case Cpu::IsaLevel::SSE42:  return sse42_table();
+                case Cpu::IsaLevel::Scalar: break;
+            }
+            return scalar_table();
+        }
+    }
+
+    Cpu::IsaLevel default_level() {
+        if (const char* env {std::getenv("RAYTRACER_ISA")}; env != nullptr && *env != '\0') {
+            if (const auto forced {Cpu::parse_isa_level(env)}) return *forced;
+            std::cerr << "Ignoring unknown RAYTRACER_ISA value '" << env << "'\n";
+        }
+        return Cpu::detect_isa_level();
+    }
+
+    Cpu::IsaLevel select(const Cpu::IsaLevel requested) {
+        Cpu::IsaLevel level {requested};
+        if (const Cpu::IsaLevel supported {Cpu::detect_isa_level()}; level > supported) {
+            std::cerr << "Requested " << Cpu::to_string(level) << " kernels but this CPU only supports "
+                      << Cpu::to_string(supported) << "; falling back\n";
+            level = supported;
+        }
+        active_table.store(&table_for(level), std::memory_order_release);
+        return level;
+    }
+
+    const KernelTable& active() {
+        const KernelTable* table {active_table.load(std::memory_order_acquire)};
+        if (table == nullptr) {
+            select(default_level());
+            table = active_table.load(std::memory_order_acquire);
+        }
+        return *table;
+    }
+
+} // namespace Kernels
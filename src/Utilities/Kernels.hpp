@@ -0,0 +1,148 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_KERNELS_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_KERNELS_HPP
+#include <cstddef>
+#include <cstdint>
+#include "Utilities/Cpu.hpp"
+
+/// Hot inner loops compiled once per instruction-set level and picked at startup.
+///
+/// Every Kernels_<isa>.cpp translation unit includes KernelsImpl.inl with its
+/// own -m flags. The kernels only see plain arrays declared here, so no inline
+/// function from a shared header (glm, Math.hpp) is ever emitted with wider
+/// instructions than the baseline build.
+namespace Kernels {
+
+    // ---------------------------------------------------------------------
+    // Flattened inputs
+    // ---------------------------------------------------------------------
+
+    /// Spheres in structure-of-arrays layout.
+    struct SphereSoA {
+        const float* cx;
+        const float* cy;
+        const float* cz;
+        const float* radius2;   // radius squared
+        std::size_t count;
+    };
+
+    /**
+     * @brief Clipped quadric surfaces (Objects::Quadric) in structure-of-arrays layout.
+     *
+     * field[F][i] is field F of quadric i. With p = x - origin the surface is
+     * Q(p) = p.A.p + 2 g.p + j = 0 for the symmetric A = [a d e; d b f; e f c]
+     * and g = (g, h, i); Q < 0 is inside. Each clip plane keeps n.p + offset <= 0
+     * and, if its cap field is 1, closes the solid with a flat cap.
+     */
+    struct QuadricSoA {
+        enum Field : std::size_t {
+            ORIGIN_X, ORIGIN_Y, ORIGIN_Z,
+            A, B, C, D, E, F, G, H, I, J,
+            CLIP0_X, CLIP0_Y, CLIP0_Z, CLIP0_OFFSET, CLIP0_CAP,
+            CLIP1_X, CLIP1_Y, CLIP1_Z, CLIP1_OFFSET, CLIP1_CAP,
+            FIELD_COUNT
+        };
+
+        const float* field[FIELD_COUNT];
+        std::size_t count;
+    };
+
+    /// Non-ambient lights in structure-of-arrays layout; ambient terms are pre-summed.
+    struct LightSoA {
+        float ambient;
+        const float* point_x;
+        const float* point_y;
+        const float* point_z;
+        const float* point_intensity;
+        std::size_t point_count;
+        const float* dir_x;      // normalized direction
+        const float* dir_y;
+        const float* dir_z;
+        const float* dir_intensity;
+        std::size_t dir_count;
+    };
+
+    /// Surface hits to shade in structure-of-arrays layout (a tile or wavefront).
+    struct HitSoA {
+        const float* px;
+        const float* py;
+        const float* pz;
+        const float* nx;         // need not be normalized
+        const float* ny;
+        const float* nz;
+        const float* vx;         // towards the viewer, need not be normalized
+        const float* vy;
+        const float* vz;
+        const int* shininess;    // Phong exponent, -1 disables specular
+        std::size_t count;
+    };
+
+    /**
+     * @brief Up to eight boxes quantised to 8-bit grids inside their parent's box.
+     *
+     * On axis a, box i spans origin[a] + lo[a][i] * 2^exponent[a] to
+     * origin[a] + hi[a][i] * 2^exponent[a]; the grid points are exact floats,
+     * so rounding outwards when quantising keeps every box conservative.
+     * Only the first count boxes are used.
+     */
+    struct QuantisedBoxes8 {
+        float origin[3];
+        std::int8_t exponent[3];     // in [-126, 127]
+        std::uint8_t count;
+        std::uint8_t lo[3][8];
+        std::uint8_t hi[3][8];
+    };
+
+    // ---------------------------------------------------------------------
+    // Dispatch table
+    // ---------------------------------------------------------------------
+
+    struct KernelTable {
+        Cpu::IsaLevel level;
+
+        /// Nearest sphere hit with t_min < t < t_max; returns its index or -1.
+        int (*nearest_sphere)(const float origin[3], const float direction[3], float t_min, float t_max,
+                              const SphereSoA& spheres, float& t_out);
+
+        /// Nearest clipped-quadric hit (side or cap) with t_min < t < t_max; returns its index or -1.
+        int (*nearest_quadric)(const float origin[3], const float direction[3], float t_min, float t_max,
+                               const QuadricSoA& quadrics, float& t_out);
+
+        /// Slab test of every box at once; returns a bit mask of the boxes entered within [t_min, t_max], with entry distances in t_enter.
+        unsigned (*enter_boxes8)(const QuantisedBoxes8& boxes, const float origin[3], const float inverse_direction[3], float t_min, float t_max,
+                                 float t_enter[8]);
+
+        /// Distinct real roots of x^4 + b x^3 + c x^2 + d x + e (ascending); returns the count (<= 4).
+        int (*solve_quartic_monic)(double b, double c, double d, double e, double roots[4]);
+
+        /// Phong intensity in [0, 1] at P; N and V need not be normalized.
+        float (*compute_lighting)(const float P[3], const float N[3], const float V[3], int shininess,
+                                  const LightSoA& lights);
+
+        /// x^exponent by repeated squaring: the specular term compute_lighting uses, for shading done outside it.
+        float (*specular_power)(float x, int exponent);
+
+        /// compute_lighting for every hit, vectorised across hits; bit-identical to calling it per hit.
+        void (*shade_batch)(const HitSoA& hits, const LightSoA& lights, float* intensity_out);
+
+        /// Clamp interleaved int RGB triplets to [0, 255] and pack them as bytes.
+        void (*tonemap_rgb8)(const int* rgb, std::size_t pixel_count, unsigned char* out);
+    };
+
+    // Per-level tables (Kernels_<isa>.cpp)
+    const KernelTable& scalar_table();
+    const KernelTable& sse42_table();
+    const KernelTable& avx2_table();
+    const KernelTable& avx512_table();
+
+    /// Currently selected table; the first call selects from RAYTRACER_ISA or CPUID.
+    const KernelTable& active();
+
+    /// Select a level, clamped to what the CPU supports. Returns the level in use.
+    Cpu::IsaLevel select(Cpu::IsaLevel requested);
+
+    /// Level picked when nothing is forced: RAYTRACER_ISA if set and valid, else CPUID.
+    Cpu::IsaLevel default_level();
+
+} // namespace Kernels
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_KERNELS_HPP
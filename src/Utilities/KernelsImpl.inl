@@ -0,0 +1,492 @@
+// Kernel bodies shared by every Kernels_<isa>.cpp translation unit.
+//
+// The including file defines:
+//   RT_KERNEL_NAMESPACE  unique namespace for this build (e.g. avx2)
+//   RT_KERNEL_LEVEL      Cpu::IsaLevel value of this build
+//   RT_KERNEL_TABLE      name of the table accessor (e.g. avx2_table)
+//
+// Everything below has internal linkage on purpose: with per-file -m flags an
+// externally visible inline function could be picked by the linker for the
+// baseline code path and fault on older CPUs. Keep helpers local and avoid
+// calling inline functions from shared project headers.
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "Utilities/Kernels.hpp"
+
+#if !defined(RT_KERNEL_NAMESPACE) || !defined(RT_KERNEL_LEVEL) || !defined(RT_KERNEL_TABLE)
+#error "Define RT_KERNEL_NAMESPACE, RT_KERNEL_LEVEL and RT_KERNEL_TABLE before including KernelsImpl.inl"
+#endif
+
+namespace Kernels::RT_KERNEL_NAMESPACE {
+namespace {
+
+    constexpr float INF {std::numeric_limits<float>::infinity()};
+
+    // ---------------------------------------------------------------------
+    // Sphere intersection (batched)
+    // ---------------------------------------------------------------------
+
+    int nearest_sphere(const float origin[3], const float direction[3], const float t_min, const float t_max,
+                       const SphereSoA& spheres, float& t_out) {
+        // Evaluate a chunk branch-free into a small buffer so the loop vectorises,
+        // then pick the minimum with a scalar scan.
+        constexpr std::size_t CHUNK {64};
+        float t[CHUNK];
+
+        const float ox {origin[0]}, oy {origin[1]}, oz {origin[2]};
+        const float dx {direction[0]}, dy {direction[1]}, dz {direction[2]};
+        const float lo {t_min > 0.0f ? t_min : 0.0f};
+
+        int best {-1};
+        float best_t {t_max};
+
+        for (std::size_t base {0}; base < spheres.count; base += CHUNK) {
+            const std::size_t n {spheres.count - base < CHUNK ? spheres.count - base : CHUNK};
+            const float* cx {spheres.cx + base};
+            const float* cy {spheres.cy + base};
+            const float* cz {spheres.cz + base};
+            const float* r2 {spheres.radius2 + base};
+
+            for (std::size_t i {0}; i < n; ++i) {
+                const float ocx {ox - cx[i]}, ocy {oy - cy[i]}, ocz {oz - cz[i]};
+                // Half-b form; the discriminant is r^2 minus the squared
+                // distance to the line (no cancellation for far origins)
+                const float hb {ocx * dx + ocy * dy + ocz * dz};
+                const float lx {ocx - hb * dx}, ly {ocy - hb * dy}, lz {ocz - hb * dz};
+                const float disc {r2[i] - (lx * lx + ly * ly + lz * lz)};
+                const float sq {std::sqrt(disc > 0.0f ? disc : 0.0f)};
+                const float t1 {-hb - sq};
+                const float t2 {-hb + sq};
+                const float hit {t1 > lo ? t1 : (t2 > lo ? t2 : INF)};
+                t[i] = disc < 0.0f ? INF : hit;
+            }
+
+            for (std::size_t i {0}; i < n; ++i) {
+                if (t[i] < best_t) {
+                    best_t = t[i];
+                    best = static_cast<int>(base + i);
+                }
+            }
+        }
+
+        if (best >= 0) t_out = best_t;
+        return best;
+    }
+
+    // ---------------------------------------------------------------------
+    // Clipped quadric intersection (batched)
+    // ---------------------------------------------------------------------
+
+    int nearest_quadric(const float origin[3], const float direction[3], const float t_min, const float t_max,
+                        const QuadricSoA& quadrics, float& t_out) {
+        using Q = QuadricSoA;
+        constexpr std::size_t CHUNK {64};
+        float t[CHUNK];
+
+        const float ox {origin[0]}, oy {origin[1]}, oz {origin[2]};
+        const float dx {direction[0]}, dy {direction[1]}, dz {direction[2]};
+        const float lo {t_min > 0.0f ? t_min : 0.0f};
+        const float* const* f {quadrics.field};
+
+        int best {-1};
+        float best_t {t_max};
+
+        for (std::size_t base {0}; base < quadrics.count; base += CHUNK) {
+            const std::size_t n {quadrics.count - base < CHUNK ? quadrics.count - base : CHUNK};
+
+            for (std::size_t i {0}; i < n; ++i) {
+                const std::size_t k {base + i};
+                const float px {ox - f[Q::ORIGIN_X][k]}, py {oy - f[Q::ORIGIN_Y][k]}, pz {oz - f[Q::ORIGIN_Z][k]};
+                const float a {f[Q::A][k]}, b {f[Q::B][k]}, c {f[Q::C][k]};
+                const float d {f[Q::D][k]}, e {f[Q::E][k]}, ff {f[Q::F][k]};
+                const float gx {f[Q::G][k]}, gy {f[Q::H][k]}, gz {f[Q::I][k]};
+
+                // Q(p + tD) = qa t^2 + 2 qb t + qc
+                const float apx {a * px + d * py + e * pz}, apy {d * px + b * py + ff * pz}, apz {e * px + ff * py + c * pz};
+                const float adx {a * dx + d * dy + e * dz}, ady {d * dx + b * dy + ff * dz}, adz {e * dx + ff * dy + c * dz};
+                const float qa {dx * adx + dy * ady + dz * adz};
+                const float qb {dx * (apx + gx) + dy * (apy + gy) + dz * (apz + gz)};
+                const float qc {px * (apx + 2.0f * gx) + py * (apy + 2.0f * gy) + pz * (apz + 2.0f * gz) + f[Q::J][k]};
+
+                // Stable roots; qa = 0 (e.g. along a cylinder's axis) leaves the linear root in r1
+                const float disc {qb * qb - qa * qc};
+                const float sq {std::sqrt(disc > 0.0f ? disc : 0.0f)};
+                const float q {-(qb + (qb < 0.0f ? -sq : sq))};
+                const float r0 {q / qa};
+                const float r1 {qc / q};
+
+                // Clip planes along the ray: s(t) = s0 + t sd, kept where s <= 0
+                const float s0 {f[Q::CLIP0_X][k] * px + f[Q::CLIP0_Y][k] * py + f[Q::CLIP0_Z][k] * pz + f[Q::CLIP0_OFFSET][k]};
+                const float sd0 {f[Q::CLIP0_X][k] * dx + f[Q::CLIP0_Y][k] * dy + f[Q::CLIP0_Z][k] * dz};
+                const float s1 {f[Q::CLIP1_X][k] * px + f[Q::CLIP1_Y][k] * py + f[Q::CLIP1_Z][k] * pz + f[Q::CLIP1_OFFSET][k]};
+                const float sd1 {f[Q::CLIP1_X][k] * dx + f[Q::CLIP1_Y][k] * dy + f[Q::CLIP1_Z][k] * dz};
+
+                const bool side0 {disc >= 0.0f && r0 > lo && s0 + r0 * sd0 <= 0.0f && s1 + r0 * sd1 <= 0.0f};
+                const bool side1 {disc >= 0.0f && r1 > lo && s0 + r1 * sd0 <= 0.0f && s1 + r1 * sd1 <= 0.0f};
+
+                // Caps: where the ray crosses a capping plane inside the quadric and the other plane
+                const float c0 {-s0 / sd0};
+                const float c1 {-s1 / sd1};
+                const bool cap0 {f[Q::CLIP0_CAP][k] != 0.0f && c0 > lo && (qa * c0 + 2.0f * qb) * c0 + qc <= 0.0f && s1 + c0 * sd1 <= 0.0f};
+                const bool cap1 {f[Q::CLIP1_CAP][k] != 0.0f && c1 > lo && (qa * c1 + 2.0f * qb) * c1 + qc <= 0.0f && s0 + c1 * sd0 <= 0.0f};
+
+                float nearest {side0 ? r0 : INF};
+                nearest = side1 && r1 < nearest ? r1 : nearest;
+                nearest = cap0 && c0 < nearest ? c0 : nearest;
+                nearest = cap1 && c1 < nearest ? c1 : nearest;
+                t[i] = nearest;
+            }
+
+            for (std::size_t i {0}; i < n; ++i) {
+                if (t[i] < best_t) {
+                    best_t = t[i];
+                    best = static_cast<int>(base + i);
+                }
+            }
+        }
+
+        if (best >= 0) t_out = best_t;
+        return best;
+    }
+
+    // ---------------------------------------------------------------------
+    // Quantised child boxes of a wide hierarchy node
+    // ---------------------------------------------------------------------
+
+    unsigned enter_boxes8(const QuantisedBoxes8& boxes, const float origin[3], const float inverse_direction[3], const float t_min, const float t_max,
+                          float t_enter[8]) {
+        // All eight lanes branch-free so each axis is one vector pass; unused lanes are masked at the end
+        float enter[8], leave[8];
+        for (std::size_t i {0}; i < 8; ++i) {
+            enter[i] = t_min;
+            leave[i] = t_max;
+        }
+        for (std::size_t a {0}; a < 3; ++a) {
+            const float scale {std::bit_cast<float>(static_cast<std::uint32_t>(boxes.exponent[a] + 127) << 23)};    // 2^exponent, a normal float
+            const float base {boxes.origin[a]};
+            const float o {origin[a]};
+            const float inverse {inverse_direction[a]};
+            const std::uint8_t* lo {boxes.lo[a]};
+            const std::uint8_t* hi {boxes.hi[a]};
+            for (std::size_t i {0}; i < 8; ++i) {
+                const float t0 {(base + static_cast<float>(lo[i]) * scale - o) * inverse};
+                const float t1 {(base + static_cast<float>(hi[i]) * scale - o) * inverse};
+                const float near {t0 < t1 ? t0 : t1};
+                const float far {t0 < t1 ? t1 : t0};
+                enter[i] = near > enter[i] ? near : enter[i];
+                leave[i] = far < leave[i] ? far : leave[i];
+            }
+        }
+
+        unsigned mask {0};
+        for (std::size_t i {0}; i < 8; ++i) {
+            t_enter[i] = enter[i];
+            mask |= (enter[i] <= leave[i] ? 1u : 0u) << i;
+        }
+        return mask & ((1u << boxes.count) - 1u);
+    }
+
+    // ---------------------------------------------------------------------
+    // Monic quartic (same algorithm as Math::solve_quartic_monic, fixed storage)
+    // ---------------------------------------------------------------------
+
+    constexpr double EPS_GENERAL   {1e-12};
+    constexpr double EPS_SQRT_ARG  {1e-14};
+    constexpr double EPS_RESIDUAL  {1e-10};
+    constexpr double EPS_MERGE     {1e-6};
+    constexpr double EPS_DERIV_MIN {1e-14};
+    constexpr double EPS_BIQUAD    {1e-8};
+
+    double horner4(const double b, const double c, const double d, const double e, const double x) {
+        return ((((x + b) * x + c) * x + d) * x + e);
+    }
+
+    double d_horner4(const double b, const double c, const double d, const double x) {
+        return ((4.0 * x + 3.0 * b) * x + 2.0 * c) * x + d;
+    }
+
+    double max_d(const double a, const double b) { return a > b ? a : b; }
+
+    double term_scale4(const double b, const double c, const double d, const double e, const double x) {
+        const double ax {std::fabs(x)};
+        return max_d(1.0, (((ax + std::fabs(b)) * ax + std::fabs(c)) * ax + std::fabs(d)) * ax + std::fabs(e));
+    }
+
+    bool nearly_equal(const double a, const double b) {
+        const double m {max_d(1.0, max_d(std::fabs(a), std::fabs(b)))};
+        return std::fabs(a - b) <= EPS_MERGE * m;
+    }
+
+    void add_root_pair(double rad, const double shift, double raw[4], int& n) {
+        if (rad < 0.0 && rad > -EPS_SQRT_ARG) rad = 0.0;
+        if (rad >= 0.0) {
+            const double r {0.5 * std::sqrt(max_d(0.0, rad))};
+            raw[n++] = shift + r;
+            raw[n++] = shift - r;
+        }
+    }
+
+    int solve_quartic_monic(const double b, const double c, const double d, const double e, double roots[4]) {
+        const double b2 {b*b}, b3 {b2*b};
+        const double c2 {c*c}, c3 {c2*c};
+        const double bd {b*d}, bcd {bd*c}, b2e {b2*e}, d2 {d*d}, ce {c*e}, bc {b*c};
+        const double mbd4 {-0.25 * b};
+
+        const double p {(8.0 * c - 3.0 * b2) / 8.0};
+        const double q {(b3 - 4.0 * bc + 8.0 * d) / 8.0};
+
+        const double t0 {c2 - 3.0 * bd + 12.0 * e};
+        const double t1 {2.0 * c3 - 9.0 * bcd + 27.0 * b2e + 27.0 * d2 - 72.0 * ce};
+        const double disc {t1 * t1 - 4.0 * t0 * t0 * t0};
+
+        double sint {0.0};
+        if (disc < 0.0 && t0 > 0.0) {
+            const double st0 {std::sqrt(max_d(0.0, t0))};
+            double arg {t1 / (2.0 * t0 * st0)};
+            arg = arg < -1.0 ? -1.0 : (arg > 1.0 ? 1.0 : arg);
+            const double phi {std::acos(arg) / 3.0};
+            sint = (-2.0/3.0) * p + (2.0/3.0) * st0 * std::cos(phi);
+        } else {
+            const double sq {std::sqrt(max_d(0.0, disc))};
+            double bigq {std::cbrt(0.5 * (t1 < 0.0 ? t1 - sq : t1 + sq))};
+            if (std::fabs(bigq) < EPS_GENERAL) bigq = std::cbrt(0.5 * (t1 < 0.0 ? t1 + sq : t1 - sq));
+            const double inv {(std::fabs(bigq) < EPS_GENERAL) ? 0.0 : (t0 / bigq)};
+            sint = (-2.0/3.0) * p + (1.0/3.0) * (bigq + inv);
+        }
+
+        double raw[4];
+        int n_raw {0};
+        if (sint <= EPS_BIQUAD * max_d(1.0, std::fabs(p))) {
+            // Biquadratic (q ~ 0) in y = x + b/4
+            const double r {e - 0.25 * bd + c * b2 / 16.0 - 3.0 * b2 * b2 / 256.0};
+            const double rad {p * p - 4.0 * r};
+            if (rad < -EPS_SQRT_ARG) return 0;
+            const double sq {std::sqrt(max_d(0.0, rad))};
+            add_root_pair(-2.0 * (p + sq), mbd4, raw, n_raw);
+            add_root_pair(-2.0 * (p - sq), mbd4, raw, n_raw);
+        } else {
+            const double s {0.5 * std::sqrt(sint)};
+            const double rootint {-(sint + 2.0 * p)};
+            const double qds {q / s};
+            add_root_pair(rootint + qds, mbd4 - s, raw, n_raw);
+            add_root_pair(rootint - qds, mbd4 + s, raw, n_raw);
+        }
+
+        // Polish + residual filter
+        double acc[4];
+        int n_acc {0};
+        for (int i {0}; i < n_raw; ++i) {
+            double t {raw[i]};
+            for (int it {0}; it < 2; ++it) {
+                const double f  {horner4(b, c, d, e, t)};
+                const double fp {d_horner4(b, c, d, t)};
+                if (std::fabs(fp) < EPS_DERIV_MIN) break;
+                t -= f / fp;
+            }
+            if (std::isfinite(t) && std::fabs(horner4(b, c, d, e, t)) <= EPS_RESIDUAL * term_scale4(b, c, d, e, t)) acc[n_acc++] = t;
+        }
+
+        // Insertion sort (at most four values), then collapse near-duplicates
+        for (int i {1}; i < n_acc; ++i) {
+            const double x {acc[i]};
+            int j {i - 1};
+            while (j >= 0 && acc[j] > x) { acc[j + 1] = acc[j]; --j; }
+            acc[j + 1] = x;
+        }
+
+        int n_out {0};
+        for (int i {0}; i < n_acc; ++i) {
+            if (n_out == 0 || !nearly_equal(acc[i], roots[n_out - 1])) roots[n_out++] = acc[i];
+        }
+        return n_out;
+    }
+
+    // ---------------------------------------------------------------------
+    // Phong shading
+    // ---------------------------------------------------------------------
+
+    // The specular term x^s uses repeated squaring in float rather than
+    // std::pow in double: exponents are integers, at most ~2 log2(s)
+    // multiplies replace a libm call, and the relative error stays far below
+    // one 8-bit step for any exponent a material would use. Negative
+    // exponents give the reciprocal. shade_batch performs the same
+    // multiplications lane by lane, which keeps both paths bit-identical.
+
+    unsigned exponent_magnitude(const int exponent) {
+        return exponent < 0 ? 0u - static_cast<unsigned>(exponent) : static_cast<unsigned>(exponent);
+    }
+
+    float specular_power(const float x, const int exponent) {
+        float result {1.0f};
+        float base {x};
+        for (unsigned e {exponent_magnitude(exponent)}; e != 0; e >>= 1) {
+            if (e & 1u) result *= base;
+            base *= base;
+        }
+        return exponent < 0 ? 1.0f / result : result;
+    }
+
+    float compute_lighting(const float P[3], const float N_in[3], const float V_in[3], const int shininess,
+                           const LightSoA& lights) {
+        const float n_inv {1.0f / std::sqrt(N_in[0] * N_in[0] + N_in[1] * N_in[1] + N_in[2] * N_in[2])};
+        const float v_inv {1.0f / std::sqrt(V_in[0] * V_in[0] + V_in[1] * V_in[1] + V_in[2] * V_in[2])};
+        const float nx {N_in[0] * n_inv}, ny {N_in[1] * n_inv}, nz {N_in[2] * n_inv};
+        const float vx {V_in[0] * v_inv}, vy {V_in[1] * v_inv}, vz {V_in[2] * v_inv};
+
+        float intensity {lights.ambient};
+
+        const auto accumulate = [&](const float lx, const float ly, const float lz, const float light_intensity) {
+            // Diffuse: max(0, N·L)
+            const float n_dot_l {nx * lx + ny * ly + nz * lz};
+            if (n_dot_l > 0) {
+                intensity += light_intensity * n_dot_l;
+            }
+
+            // Specular (Phong): max(0, R·V)^s
+            if (shininess != -1) {
+                const float rx {nx * 2.0f * n_dot_l - lx};
+                const float ry {ny * 2.0f * n_dot_l - ly};
+                const float rz {nz * 2.0f * n_dot_l - lz};
+                if (const float r_dot_v {rx * vx + ry * vy + rz * vz}; r_dot_v > 0.0f) {
+                    intensity += light_intensity * specular_power(r_dot_v, shininess);
+                }
+            }
+        };
+
+        for (std::size_t i {0}; i < lights.point_count; ++i) {
+            const float lx {lights.point_x[i] - P[0]};
+            const float ly {lights.point_y[i] - P[1]};
+            const float lz {lights.point_z[i] - P[2]};
+            const float l_inv {1.0f / std::sqrt(lx * lx + ly * ly + lz * lz)};
+            accumulate(lx * l_inv, ly * l_inv, lz * l_inv, lights.point_intensity[i]);
+        }
+
+        for (std::size_t i {0}; i < lights.dir_count; ++i) {
+            accumulate(lights.dir_x[i], lights.dir_y[i], lights.dir_z[i], lights.dir_intensity[i]);
+        }
+
+        return intensity < 0.0f ? 0.0f : (intensity > 1.0f ? 1.0f : intensity);
+    }
+
+    void shade_batch(const HitSoA& hits, const LightSoA& lights, float* intensity_out) {
+        // Hits are processed in chunks held in small local arrays; every inner
+        // loop below runs across the chunk without branches so it vectorises.
+        // Conditional terms are added as 0.0f, which leaves the sum unchanged.
+        constexpr std::size_t CHUNK {64};
+        float nx[CHUNK], ny[CHUNK], nz[CHUNK], vx[CHUNK], vy[CHUNK], vz[CHUNK];
+        float lx[CHUNK], ly[CHUNK], lz[CHUNK];
+        float r_dot_v[CHUNK], power[CHUNK], base[CHUNK], acc[CHUNK];
+        unsigned exponent[CHUNK];
+
+        for (std::size_t first {0}; first < hits.count; first += CHUNK) {
+            const std::size_t n {hits.count - first < CHUNK ? hits.count - first : CHUNK};
+            const float* px {hits.px + first};
+            const float* py {hits.py + first};
+            const float* pz {hits.pz + first};
+            const int* shininess {hits.shininess + first};
+
+            unsigned all_bits {0};
+            for (std::size_t i {0}; i < n; ++i) {
+                const float hx {hits.nx[first + i]}, hy {hits.ny[first + i]}, hz {hits.nz[first + i]};
+                const float n_inv {1.0f / std::sqrt(hx * hx + hy * hy + hz * hz)};
+                nx[i] = hx * n_inv; ny[i] = hy * n_inv; nz[i] = hz * n_inv;
+
+                const float wx {hits.vx[first + i]}, wy {hits.vy[first + i]}, wz {hits.vz[first + i]};
+                const float v_inv {1.0f / std::sqrt(wx * wx + wy * wy + wz * wz)};
+                vx[i] = wx * v_inv; vy[i] = wy * v_inv; vz[i] = wz * v_inv;
+
+                acc[i] = lights.ambient;
+                exponent[i] = exponent_magnitude(shininess[i]);
+                all_bits |= exponent[i];
+            }
+            int rounds {0};
+            while (all_bits >> rounds) ++rounds;
+
+            const auto accumulate = [&](const float light_intensity) {
+                for (std::size_t i {0}; i < n; ++i) {
+                    const float n_dot_l {nx[i] * lx[i] + ny[i] * ly[i] + nz[i] * lz[i]};
+                    const float diffuse {light_intensity * n_dot_l};
+                    acc[i] += n_dot_l > 0 ? diffuse : 0.0f;
+
+                    const float rx {nx[i] * 2.0f * n_dot_l - lx[i]};
+                    const float ry {ny[i] * 2.0f * n_dot_l - ly[i]};
+                    const float rz {nz[i] * 2.0f * n_dot_l - lz[i]};
+                    r_dot_v[i] = rx * vx[i] + ry * vy[i] + rz * vz[i];
+                    power[i] = 1.0f;
+                    base[i] = r_dot_v[i];
+                }
+                for (int bit {0}; bit < rounds; ++bit) {
+                    for (std::size_t i {0}; i < n; ++i) {
+                        const float product {power[i] * base[i]};
+                        power[i] = (exponent[i] >> bit) & 1u ? product : power[i];
+                        base[i] *= base[i];
+                    }
+                }
+                for (std::size_t i {0}; i < n; ++i) {
+                    const float reciprocal {1.0f / power[i]};
+                    const float specular {light_intensity * (shininess[i] < 0 ? reciprocal : power[i])};
+                    acc[i] += shininess[i] != -1 && r_dot_v[i] > 0.0f ? specular : 0.0f;
+                }
+            };
+
+            for (std::size_t l {0}; l < lights.point_count; ++l) {
+                for (std::size_t i {0}; i < n; ++i) {
+                    const float dx {lights.point_x[l] - px[i]};
+                    const float dy {lights.point_y[l] - py[i]};
+                    const float dz {lights.point_z[l] - pz[i]};
+                    const float l_inv {1.0f / std::sqrt(dx * dx + dy * dy + dz * dz)};
+                    lx[i] = dx * l_inv; ly[i] = dy * l_inv; lz[i] = dz * l_inv;
+                }
+                accumulate(lights.point_intensity[l]);
+            }
+
+            for (std::size_t l {0}; l < lights.dir_count; ++l) {
+                for (std::size_t i {0}; i < n; ++i) {
+                    lx[i] = lights.dir_x[l]; ly[i] = lights.dir_y[l]; lz[i] = lights.dir_z[l];
+                }
+                accumulate(lights.dir_intensity[l]);
+            }
+
+            for (std::size_t i {0}; i < n; ++i) {
+                intensity_out[first + i] = acc[i] < 0.0f ? 0.0f : (acc[i] > 1.0f ? 1.0f : acc[i]);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // Tonemap / quantise
+    // ---------------------------------------------------------------------
+
+    void tonemap_rgb8(const int* rgb, const std::size_t pixel_count, unsigned char* out) {
+        const std::size_t n {pixel_count * 3};
+        for (std::size_t i {0}; i < n; ++i) {
+            const int v {rgb[i]};
+            out[i] = static_cast<unsigned char>(v < 0 ? 0 : (v > 255 ? 255 : v));
+        }
+    }
+
+} // namespace
+} // namespace Kernels::RT_KERNEL_NAMESPACE
+
+namespace Kernels {
+
+    const KernelTable& RT_KERNEL_TABLE() {
+        static constexpr KernelTable table {
+            RT_KERNEL_LEVEL,
+            &RT_KERNEL_NAMESPACE::nearest_sphere,
+            &RT_KERNEL_NAMESPACE::nearest_quadric,
+            &RT_KERNEL_NAMESPACE::enter_boxes8,
+            &RT_KERNEL_NAMESPACE::solve_quartic_monic,
+            &RT_KERNEL_NAMESPACE::compute_lighting,
+            &RT_KERNEL_NAMESPACE::specular_power,
+            &RT_KERNEL_NAMESPACE::shade_batch,
+            &RT_KERNEL_NAMESPACE::tonemap_rgb8,
+        };
+        return table;
+    }
+
+} // namespace Kernels
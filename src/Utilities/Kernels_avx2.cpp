@@ -0,0 +1,5 @@
+// AVX2 build of the dispatched kernels (compile flags set in CMakeLists.txt).
+#define RT_KERNEL_NAMESPACE avx2
+#define RT_KERNEL_LEVEL     Cpu::IsaLevel::AVX2
+#define RT_KERNEL_TABLE     avx2_table
+#include "Utilities/KernelsImpl.inl"
@@ -0,0 +1,5 @@
+// AVX-512 build of the dispatched kernels (compile flags set in CMakeLists.txt).
+#define RT_KERNEL_NAMESPACE avx512
+#define RT_KERNEL_LEVEL     Cpu::IsaLevel::AVX512
+#define RT_KERNEL_TABLE     avx512_table
+#include "Utilities/KernelsImpl.inl"
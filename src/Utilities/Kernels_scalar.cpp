@@ -0,0 +1,5 @@
+// scalar build of the dispatched kernels (compile flags set in CMakeLists.txt).
+#define RT_KERNEL_NAMESPACE scalar
+#define RT_KERNEL_LEVEL     Cpu::IsaLevel::Scalar
+#define RT_KERNEL_TABLE     scalar_table
+#include "Utilities/KernelsImpl.inl"
@@ -0,0 +1,5 @@
+// SSE4.2 build of the dispatched kernels (compile flags set in CMakeLists.txt).
+#define RT_KERNEL_NAMESPACE sse42
+#define RT_KERNEL_LEVEL     Cpu::IsaLevel::SSE42
+#define RT_KERNEL_TABLE     sse42_table
+#include "Utilities/KernelsImpl.inl"
@@ -20,9 +20,10 @@ namespace Math {
     struct Eps {
         static constexpr double general   {1e-12}; // small epsilon
         static constexpr double sqrt_arg  {1e-14}; // tolerance for negative -> 0 under sqrt
-        static constexpr double residual  {1e-10}; // accept root if |f(x)| <= residual
+        static constexpr double residual  {1e-10}; // accept root if |f(x)| <= residual * (magnitude of its terms)
         static constexpr double merge     {1e-6};  // collapse near-duplicates
         static constexpr double deriv_min {1e-14}; // guard for Newton derivative
+        static constexpr double biquad    {1e-8};  // resolvent root below this * max(1, |p|): treat as biquadratic
     };
 
     // ---------------------------------------------------------------------
@@ -86,6 +87,15 @@ namespace Math {
     #endif
     }
 
+    /// Sum of the term magnitudes |x^4| + |b x^3| + |c x^2| + |d x| + |e|, floored at 1.
+    /// Rounding in f(x) scales with this, so residuals are judged against it.
+    inline double term_scale4_monic(const double& b, const double& c,
+                                    const double& d, const double& e,
+                                    const double& x) {
+        const double ax {std::abs(x)};
+        return std::max(1.0, (((ax + std::abs(b)) * ax + std::abs(c)) * ax + std::abs(d)) * ax + std::abs(e));
+    }
+
     /// Derivative of monic quartic: 4x^3 + 3b x^2 + 2c x + d
     inline double d_horner4_monic(const double& b, const double& c,
                                   const double& d, const double& /*e*/,
@@ -149,22 +159,13 @@ namespace Math {
             sint = (-2.0/3.0) * p + (2.0/3.0) * st0 * std::cos(phi);
         } else {
             const double sq   {std::sqrt(std::max(0.0, disc))};
-            double bigq       {std::cbrt(0.5 * (t1 + sq))};
-            if (std::abs(bigq) < Eps::general) bigq = std::cbrt(0.5 * (t1 - sq));
+            // Take the sign of t1 so the two terms never cancel
+            double bigq       {std::cbrt(0.5 * (t1 < 0.0 ? t1 - sq : t1 + sq))};
+            if (std::abs(bigq) < Eps::general) bigq = std::cbrt(0.5 * (t1 < 0.0 ? t1 + sq : t1 - sq));
             const double inv  {(std::abs(bigq) < Eps::general) ? 0.0 : (t0 / bigq)};
             sint = (-2.0/3.0) * p + (1.0/3.0) * (bigq + inv);
         }
 
-        double sint_c {sint};
-        if (sint_c < 0.0 && sint_c > -Eps::sqrt_arg) sint_c = 0.0;
-        if (sint_c < 0.0) return;
-
-        const double s {0.5 * std::sqrt(sint_c)};
-        if (std::abs(s) < Eps::general) return;
-
-        const double rootint {-(sint + 2.0 * p)};
-        const double qds     {q / s};
-
         auto add_roots = [&](double rad, const double shift) {
             if (rad < 0.0 && rad > -Eps::sqrt_arg) rad = 0.0;
             if (rad >= 0.0) {
@@ -173,8 +174,25 @@ namespace Math {
                 out_roots.push_back(shift - r);
             }
         };
-        add_roots(rootint + qds, mbd4 - s);
-        add_roots(rootint - qds, mbd4 + s);
+
+        if (sint <= Eps::biquad * std::max(1.0, std::abs(p))) {
+            // q ~ 0 (e.g. a ray in a torus' ring plane) sinks S into the resolvent's
+            // rounding noise and makes the Ferrari split meaningless; solve the
+            // biquadratic y^4 + p y^2 + r = 0 in y = x + b/4 instead. Newton polishes
+            // away the neglected q and the residual test drops anything spurious.
+            const double r {e - 0.25 * bd + c * b2 / 16.0 - 3.0 * b2 * b2 / 256.0};
+            const double rad {p * p - 4.0 * r};
+            if (rad < -Eps::sqrt_arg) return;
+            const double sq {std::sqrt(std::max(0.0, rad))};
+            add_roots(-2.0 * (p + sq), mbd4);
+            add_roots(-2.0 * (p - sq), mbd4);
+        } else {
+            const double s       {0.5 * std::sqrt(sint)};
+            const double rootint {-(sint + 2.0 * p)};
+            const double qds     {q / s};
+            add_roots(rootint + qds, mbd4 - s);
+            add_roots(rootint - qds, mbd4 + s);
+        }
 
         if (out_roots.empty()) return;
 
@@ -183,7 +201,7 @@ namespace Math {
         acc.reserve(out_roots.size());
         for (double t : out_roots) {
             t = newton_polish_quartic_monic(b, c, d, e, t);
-            if (const double res {std::abs(horner4_monic(b, c, d, e, t))}; std::isfinite(t) && res <= Eps::residual) acc.push_back(t);
+            if (const double res {std::abs(horner4_monic(b, c, d, e, t))}; std::isfinite(t) && res <= Eps::residual * term_scale4_monic(b, c, d, e, t)) acc.push_back(t);
         }
         if (acc.empty()) { out_roots.clear(); return; }
 
@@ -0,0 +1,174 @@
+#include "Utilities/MemoryAccounting.hpp"
+#include <cctype>
+#include <cstdio>
+#include <limits>
+#include <utility>
+
+namespace Memory {
+
+    const char* to_string(const Subsystem subsystem) {
+        switch (subsystem) {
+            case Subsystem::Geometry:     return "geometry";
+            case Subsystem::Materials:    return "materials";
+            case Subsystem::Lights:       return "lights";
+            case Subsystem::Acceleration: return "acceleration";
+            case Subsystem::Pixels:       return "pixels";
+        }
+        return "?";
+    }
+
+    // --- Accounting ---
+    Accounting& Accounting::instance() {
+        static Accounting accounting;
+        return accounting;
+    }
+
+    std::size_t Accounting::current(const Subsystem subsystem) const {
+        return counters[static_cast<std::size_t>(subsystem)].current.load(std::memory_order_relaxed);
+    }
+
+    std::size_t Accounting::peak(const Subsystem subsystem) const {
+        return counters[static_cast<std::size_t>(subsystem)].peak.load(std::memory_order_relaxed);
+    }
+
+    std::size_t Accounting::headroom() const {
+        const std::size_t limit {get_budget()};
+        if (limit == 0) return std::numeric_limits<std::size_t>::max();
+        const std::size_t used {total()};
+        return used >= limit ? 0 : limit - used;
+    }
+
+    namespace {
+        void raise_peak(std::atomic<std::size_t>& peak, const std::size_t value) {
+            std::size_t seen {peak.load(std::memory_order_relaxed)};
+            while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+        }
+    }
+
+    void Accounting::record(const Subsystem subsystem, const std::size_t bytes) {
+        Counter& counter {counters[static_cast<std::size_t>(subsystem)]};
+        raise_peak(counter.peak, counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        raise_peak(total_peak_bytes, total_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+
+    void Accounting::charge(const Subsystem subsystem, const std::size_t bytes, const std::string_view what) {
+        const std::size_t limit {get_budget()};
+        if (limit == 0) {
+            record(subsystem, bytes);
+            return;
+        }
+
+        // Reserve against the total first so concurrent charges cannot both squeeze in
+        std::size_t used {total_bytes.load(std::memory_order_relaxed)};
+        do {
+            if (bytes > limit || used > limit - bytes) {
+                throw BudgetExceeded(std::string(what) + " needs " + format_bytes(bytes) + " of " + to_string(subsystem) + " memory but only "
+                                     + format_bytes(used >= limit ? 0 : limit - used) + " of the " + format_bytes(limit) + " budget is left ("
+                                     + report() + ")");
+            }
+        } while (!total_bytes.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+        raise_peak(total_peak_bytes, used + bytes);
+
+        Counter& counter {counters[static_cast<std::size_t>(subsystem)]};
+        raise_peak(counter.peak, counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+
+    void Accounting::add(const Subsystem subsystem, const std::size_t bytes) {
+        record(subsystem, bytes);
+    }
+
+    void Accounting::release(const Subsystem subsystem, const std::size_t bytes) {
+        counters[static_cast<std::size_t>(subsystem)].current.fetch_sub(bytes, std::memory_order_relaxed);
+        total_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    std::string Accounting::report() const {
+        std::string text;
+        for (std::size_t i {0}; i < SUBSYSTEM_COUNT; ++i) {
+            const auto subsystem {static_cast<Subsystem>(i)};
+            text += std::string(to_string(subsystem)) + " " + format_bytes(current(subsystem)) + ", ";
+        }
+        text += "total " + format_bytes(total()) + " (peak " + format_bytes(total_peak()) + ")";
+        if (const std::size_t limit {get_budget()}; limit != 0) text += " of " + format_bytes(limit);
+        return text;
+    }
+
+    // --- Charge ---
+    Charge::Charge(const Subsystem subsystem_, const std::size_t bytes_, const std::string_view what)
+        : subsystem(subsystem_), bytes(bytes_) {
+        Accounting::instance().charge(subsystem, bytes, what);
+    }
+
+    Charge::Charge(const Charge& other)
+        : subsystem(other.subsystem), bytes(other.bytes) {
+        Accounting::instance().charge(subsystem, bytes, "copy");
+    }
+
+    Charge& Charge::operator=(const Charge& other) {
+        if (this != &other) *this = Charge(other);
+        return *this;
+    }
+
+    Charge::Charge(Charge&& other) noexcept
+        : subsystem(other.subsystem), bytes(std::exchange(other.bytes, 0)) {}
+
+    Charge& Charge::operator=(Charge&& other) noexcept {
+        if (this != &other) {
+            Accounting::instance().release(subsystem, bytes);
+            subsystem = other.subsystem;
+            bytes = std::exchange(other.bytes, 0);
+        }
+        return *this;
+    }
+
+    Charge::~Charge() {
+        Accounting::instance().release(subsystem, bytes);
+    }
+
+    // --- Formatting ---
+    std::string format_bytes(const std::size_t bytes) {
+        constexpr const char* UNITS[] {"KiB", "MiB", "GiB", "TiB"};
+        if (bytes < 1024) return std::to_string(bytes) + " B";
+
+        double value {static_cast<double>(bytes) / 1024.0};
+        std::size_t unit {0};
+        while (value >= 1024.0 && unit + 1 < std::size(UNITS)) {
+            value /= 1024.0;
+            ++unit;
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.1f %s", value, UNITS[unit]);
+        return text;
+    }
+
+    std::optional<std::size_t> parse_bytes(std::string_view text) {
+        std::size_t digits {0};
+        std::size_t value {0};
+        while (digits < text.size() && std::isdigit(static_cast<unsigned char>(text[digits]))) {
+            const std::size_t next {value * 10 + static_cast<std::size_t>(text[digits] - '0')};
+            if (next / 10 != value) return std::nullopt;
+            value = next;
+            ++digits;
+        }
+        if (digits == 0) return std::nullopt;
+
+        std::string_view suffix {text.substr(digits)};
+        if (suffix.ends_with("iB")) suffix.remove_suffix(2);
+        else if (suffix.ends_with("B")) suffix.remove_suffix(1);
+
+        int shift {0};
+        if (suffix.size() == 1) {
+            switch (std::toupper(static_cast<unsigned char>(suffix[0]))) {
+                case 'K': shift = 10; break;
+                case 'M': shift = 20; break;
+                case 'G': shift = 30; break;
+                case 'T': shift = 40; break;
+                default: return std::nullopt;
+            }
+        } else if (!suffix.empty()) {
+            return std::nullopt;
+        }
+        if (shift != 0 && value > (std::numeric_limits<std::size_t>::max() >> shift)) return std::nullopt;
+        return value << shift;
+    }
+}
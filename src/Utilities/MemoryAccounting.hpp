@@ -0,0 +1,103 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_MEMORYACCOUNTING_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_MEMORYACCOUNTING_HPP
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/// Byte counters for the renderer's large allocations and an optional hard budget on their sum.
+namespace Memory {
+
+    enum class Subsystem : std::uint8_t { Geometry, Materials, Lights, Acceleration, Pixels };
+    inline constexpr std::size_t SUBSYSTEM_COUNT {5};
+
+    const char* to_string(Subsystem subsystem);
+
+    /// Thrown instead of allocating when a charge would take the total over the budget.
+    class BudgetExceeded : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * @brief Process-wide current and peak bytes per subsystem.
+     *
+     * Owners of large buffers (scenes, the material table, framebuffers,
+     * stream windows) charge their size before allocating and release it when
+     * freeing; the counters are estimates of those buffers, not a malloc hook.
+     * Charges are lock-free. With a budget set, charge() refuses anything that
+     * would take the total over it, so callers can fall back to a smaller
+     * strategy or stop with a clear message long before the OOM killer would.
+     */
+    class Accounting {
+    public:
+        static Accounting& instance();
+
+        /// Hard limit on the total of all subsystems; 0 (the default) means unlimited.
+        void set_budget(std::size_t bytes) { budget.store(bytes, std::memory_order_relaxed); }
+        std::size_t get_budget() const { return budget.load(std::memory_order_relaxed); }
+
+        std::size_t current(Subsystem subsystem) const;
+        std::size_t peak(Subsystem subsystem) const;
+        std::size_t total() const { return total_bytes.load(std::memory_order_relaxed); }
+        std::size_t total_peak() const { return total_peak_bytes.load(std::memory_order_relaxed); }
+
+        /// Bytes that can still be charged (SIZE_MAX without a budget).
+        std::size_t headroom() const;
+
+        /// Record bytes about to be allocated for what. @throws BudgetExceeded (nothing is recorded)
+        void charge(Subsystem subsystem, std::size_t bytes, std::string_view what);
+
+        /// Record bytes regardless of the budget (small or already allocated memory).
+        void add(Subsystem subsystem, std::size_t bytes);
+        void release(Subsystem subsystem, std::size_t bytes);
+
+        /// One line, e.g. "geometry 1.2 MiB, materials 4.0 KiB, ... total 9.1 MiB (peak 12 MiB) of 64 MiB".
+        std::string report() const;
+
+    private:
+        Accounting() = default;
+        void record(Subsystem subsystem, std::size_t bytes);
+
+        struct Counter {
+            std::atomic<std::size_t> current {0};
+            std::atomic<std::size_t> peak {0};
+        };
+        std::array<Counter, SUBSYSTEM_COUNT> counters;
+        std::atomic<std::size_t> total_bytes {0};
+        std::atomic<std::size_t> total_peak_bytes {0};
+        std::atomic<std::size_t> budget {0};
+    };
+
+    /**
+     * @brief A charge released on destruction; copies charge again.
+     */
+    class Charge {
+    public:
+        Charge() = default;
+        Charge(Subsystem subsystem_, std::size_t bytes_, std::string_view what);
+        Charge(const Charge& other);
+        Charge& operator=(const Charge& other);
+        Charge(Charge&& other) noexcept;
+        Charge& operator=(Charge&& other) noexcept;
+        ~Charge();
+
+        std::size_t get_bytes() const { return bytes; }
+
+    private:
+        Subsystem subsystem {Subsystem::Geometry};
+        std::size_t bytes {0};
+    };
+
+    /// "12 B", "3.4 KiB", "1.2 MiB", "2.0 GiB".
+    std::string format_bytes(std::size_t bytes);
+
+    /// Parse "1048576", "512K", "64M", "2G" (optionally followed by "iB" or "B"); nullopt if malformed.
+    std::optional<std::size_t> parse_bytes(std::string_view text);
+}
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_MEMORYACCOUNTING_HPP
@@ -0,0 +1,99 @@
+#include "Utilities/Numa.hpp"
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <latch>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sched.h>
+
+namespace Numa {
+
+    namespace {
+        constexpr std::size_t UNKNOWN_NODE {std::numeric_limits<std::size_t>::max()};
+        thread_local std::size_t this_thread_node {UNKNOWN_NODE};
+
+        // "0-3,8-11" -> {0, 1, 2, 3, 8, 9, 10, 11}
+        std::vector<int> parse_cpu_list(const std::string& text) {
+            std::vector<int> cpus;
+            std::istringstream in(text);
+            for (std::string range; std::getline(in, range, ',');) {
+                const std::size_t dash {range.find('-')};
+                try {
+                    const int first {std::stoi(range.substr(0, dash))};
+                    const int last {dash == std::string::npos ? first : std::stoi(range.substr(dash + 1))};
+                    for (int cpu {first}; cpu <= last; ++cpu) cpus.push_back(cpu);
+                } catch (const std::exception&) {
+                    // Ignore malformed entries (the list ends with a newline)
+                }
+            }
+            return cpus;
+        }
+
+        std::vector<std::vector<int>> read_topology() {
+            std::vector<std::vector<int>> nodes;
+            for (int node {0};; ++node) {
+                std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                std::string list;
+                if (!in || !std::getline(in, list)) break;
+                nodes.push_back(parse_cpu_list(list));
+            }
+            if (nodes.empty()) {
+                nodes.emplace_back();
+                const unsigned cpus {std::max(1u, std::thread::hardware_concurrency())};
+                for (unsigned cpu {0}; cpu < cpus; ++cpu) nodes.back().push_back(static_cast<int>(cpu));
+            }
+            return nodes;
+        }
+    }
+
+    const std::vector<std::vector<int>>& topology() {
+        static const std::vector<std::vector<int>> nodes {read_topology()};
+        return nodes;
+    }
+
+    std::size_t node_count() {
+        return topology().size();
+    }
+
+    std::size_t current_node() {
+        if (this_thread_node == UNKNOWN_NODE) {
+            this_thread_node = 0;
+            const int cpu {sched_getcpu()};
+            const auto& nodes {topology()};
+            for (std::size_t node {0}; node < nodes.size(); ++node) {
+                for (const int c : nodes[node]) {
+                    if (c == cpu) this_thread_node = node;
+                }
+            }
+        }
+        return this_thread_node;
+    }
+
+    bool pin_to_node(const std::size_t node) {
+        if (node >= node_count()) return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const int cpu : topology()[node]) CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) return false;
+        this_thread_node = node;
+        return true;
+    }
+
+    void spread_workers(ThreadPool& pool) {
+        // Each task waits until all have started, so every worker takes exactly one
+        const std::size_t workers {pool.size()};
+        std::latch started {static_cast<std::ptrdiff_t>(workers)};
+        std::latch done {static_cast<std::ptrdiff_t>(workers)};
+        for (std::size_t i {0}; i < workers; ++i) {
+            pool.submit([&, i] {
+                pin_to_node(i % node_count());
+                started.arrive_and_wait();
+                done.count_down();
+            });
+        }
+        done.wait();
+    }
+}
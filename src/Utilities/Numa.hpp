@@ -0,0 +1,25 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_NUMA_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_NUMA_HPP
+#include <cstddef>
+#include <vector>
+#include "Utilities/ThreadPool.hpp"
+
+/// NUMA topology from sysfs and thread placement, without libnuma.
+namespace Numa {
+
+    /// CPUs of each node, from /sys/devices/system/node (a single node with every CPU if that is unavailable).
+    const std::vector<std::vector<int>>& topology();
+
+    std::size_t node_count();
+
+    /// Node the calling thread runs on: the one it was pinned to, else where it first asked.
+    std::size_t current_node();
+
+    /// Restrict the calling thread to node's CPUs; false (and nothing changes) if the kernel refuses.
+    bool pin_to_node(std::size_t node);
+
+    /// Pin the pool's workers round-robin over the nodes. Call outside pool tasks, with the pool idle.
+    void spread_workers(ThreadPool& pool);
+}
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_NUMA_HPP
@@ -0,0 +1,44 @@
+#include "Utilities/Sampler.hpp"
+#include <bit>
+
+namespace Sampling {
+
+    std::uint32_t hash(std::uint32_t x) {
+        // lowbias32 (Wellons)
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    void sobol_2d(std::uint32_t i, std::uint32_t& x, std::uint32_t& y) {
+        // Dimension 0 is the base-2 radical inverse; dimension 1 uses v_k = v_(k-1) ^ (v_(k-1) >> 1)
+        x = 0;
+        y = 0;
+        for (std::uint32_t v0 {1u << 31}, v1 {1u << 31}; i != 0; i >>= 1, v0 >>= 1, v1 ^= v1 >> 1) {
+            if (i & 1u) {
+                x ^= v0;
+                y ^= v1;
+            }
+        }
+    }
+
+    PixelSampler::PixelSampler(const std::uint32_t seed, const int x, const int y)
+        : pixel_hash(hash(hash(hash(seed) ^ static_cast<std::uint32_t>(x)) ^ std::rotl(static_cast<std::uint32_t>(y), 16))) {}
+
+    glm::vec2 PixelSampler::get_2d(const std::uint32_t dimension) const {
+        const std::uint32_t key {hash(pixel_hash ^ hash(dimension + 0x9e3779b9u))};
+
+        // XOR-ing the index maps every aligned power-of-two block onto another, which
+        // is still a stratified net; XOR-ing the digits scrambles without breaking it
+        std::uint32_t x, y;
+        sobol_2d(index ^ key, x, y);
+        x ^= hash(key ^ 0x68bc21ebu);
+        y ^= hash(key ^ 0x02e5be93u);
+
+        constexpr float ONE_OVER_2_24 {1.0f / 16777216.0f};
+        return {static_cast<float>(x >> 8) * ONE_OVER_2_24, static_cast<float>(y >> 8) * ONE_OVER_2_24};
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_SAMPLER_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_SAMPLER_HPP
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/// Reproducible low-discrepancy sample points for Monte Carlo estimates.
+namespace Sampling {
+
+    /// Avalanching 32-bit integer hash.
+    std::uint32_t hash(std::uint32_t x);
+
+    /// Point i of the first two Sobol dimensions, as 32-bit fixed point fractions.
+    void sobol_2d(std::uint32_t i, std::uint32_t& x, std::uint32_t& y);
+
+    /**
+     * @brief Sample points in [0, 1)^2 for one pixel.
+     *
+     * Points come from the first two Sobol dimensions, a (0,2)-sequence, so
+     * every power-of-two prefix of a pixel's samples is stratified over the
+     * unit square. Each dimension pair (pixel position, light position,
+     * reflection lobe, ...) reads the sequence at its own hashed offset and
+     * with its own random-digit scramble, which decorrelates the pairs while
+     * keeping that stratification.
+     *
+     * Points depend only on (seed, x, y, sample index, dimension), never on
+     * the thread or tile that renders the pixel.
+     */
+    class PixelSampler {
+        std::uint32_t pixel_hash;
+        std::uint32_t index {0};
+
+    public:
+        PixelSampler(std::uint32_t seed, int x, int y);
+
+        // Getters / setters
+        std::uint32_t get_index() const { return index; }
+        void set_index(const std::uint32_t index_) { index = index_; }
+
+        /// Point for dimension pair `dimension` of the current sample.
+        glm::vec2 get_2d(std::uint32_t dimension) const;
+    };
+}
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_SAMPLER_HPP
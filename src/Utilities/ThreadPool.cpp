@@ -0,0 +1,95 @@
+#include "Utilities/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <latch>
+
+// --- Constructors ---
+ThreadPool::ThreadPool(unsigned thread_count) {
+    if (thread_count == 0) thread_count = 1;
+    workers.reserve(thread_count);
+    for (unsigned i {0}; i < thread_count; ++i) {
+        workers.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+// --- Workers ---
+void ThreadPool::worker_loop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex);
+        tasks.push(std::move(task));
+    }
+    cv.notify_one();
+}
+
+// --- Blocking loop ---
+void ThreadPool::parallel_for(const std::size_t count, const std::function<void(std::size_t)>& body) {
+    if (count == 0) return;
+
+    // Workers and the caller pull indices from a shared counter; helpers beyond
+    // the amount of work are never queued.
+    const std::size_t helpers {std::min<std::size_t>(workers.size(), count - 1)};
+    std::atomic<std::size_t> next {0};
+    std::latch done {static_cast<std::ptrdiff_t>(helpers)};
+    std::atomic<bool> failed {false};
+    std::exception_ptr error;
+
+    // Never lets an exception out: the first one is kept and the remaining indices are abandoned
+    auto drain = [&]() noexcept {
+        try {
+            for (std::size_t i {next.fetch_add(1, std::memory_order_relaxed)}; i < count; i = next.fetch_add(1, std::memory_order_relaxed)) {
+                body(i);
+            }
+        } catch (...) {
+            if (!failed.exchange(true, std::memory_order_acq_rel)) error = std::current_exception();
+            next.store(count, std::memory_order_relaxed);
+        }
+    };
+
+    for (std::size_t h {0}; h < helpers; ++h) {
+        submit([&] { drain(); done.count_down(); });
+    }
+    drain();
+    // Helpers use this frame's locals until they count down, so wait for them before rethrowing
+    done.wait();
+    if (error) std::rethrow_exception(error);
+}
+
+// --- Chunked loop ---
+std::size_t chunk_count(const ThreadPool* pool, const std::size_t count, const std::size_t min_chunk) {
+    if (pool == nullptr || count == 0) return 1;
+    const std::size_t threads {static_cast<std::size_t>(pool->size()) + 1};
+    return std::clamp<std::size_t>(count / std::max<std::size_t>(1, min_chunk), 1, 4 * threads);
+}
+
+void for_each_chunk(ThreadPool* pool, const std::size_t count, const std::size_t min_chunk, const std::function<void(std::size_t, std::size_t)>& body) {
+    const std::size_t chunks {chunk_count(pool, count, min_chunk)};
+    if (chunks == 1) {
+        body(0, count);
+        return;
+    }
+    pool->parallel_for(chunks, [&](const std::size_t c) { body(c * count / chunks, (c + 1) * count / chunks); });
+}
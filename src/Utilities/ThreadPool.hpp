@@ -0,0 +1,59 @@
+#ifndef RAYTRACINGCPP_SRC_UTILITIES_THREADPOOL_HPP
+#define RAYTRACINGCPP_SRC_UTILITIES_THREADPOOL_HPP
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size worker pool shared by everything that renders.
+ *
+ * Work is either fire-and-forget (submit) or a blocking index loop
+ * (parallel_for). The calling thread takes part in parallel_for, so it never
+ * waits idle; do not call parallel_for from inside a pool task.
+ */
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping {false};
+
+    void worker_loop();
+
+public:
+    // Constructors
+    explicit ThreadPool(unsigned thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Getters
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Queue a task; it runs on some worker thread.
+    void submit(std::function<void()> task);
+
+    // Run body(i) for every i in [0, count) across the pool and the caller; returns when all are done.
+    // If body throws, indices not yet started are skipped and the first exception is rethrown here once every thread is done.
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body);
+};
+
+/**
+ * @brief Run body(begin, end) over consecutive ranges that cover [0, count).
+ *
+ * Ranges are at least min_chunk long (except the last) and a few per thread,
+ * spread over pool, or one range on the calling thread if pool is null.
+ * The split depends only on count, min_chunk and the pool size, so two calls
+ * with the same arguments see the same ranges.
+ */
+void for_each_chunk(ThreadPool* pool, std::size_t count, std::size_t min_chunk, const std::function<void(std::size_t, std::size_t)>& body);
+
+/// Number of ranges for_each_chunk splits count into.
+std::size_t chunk_count(const ThreadPool* pool, std::size_t count, std::size_t min_chunk);
+
+#endif // RAYTRACINGCPP_SRC_UTILITIES_THREADPOOL_HPP
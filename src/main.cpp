@@ -1,95 +1,525 @@
 #include <iostream>
 #include <vector>
 #include <fstream>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+
+#include <csignal>
+#include <spawn.h>
+#include <sys/wait.h>
 
-#include "Objects/Cylinder.hpp"
 #include "Utilities/RGB.hpp"
-#include "Objects/Sphere.hpp"
-#include "Objects/Light.hpp"
-#include "Objects/Plane.hpp"
 #include "RayTracing/RayTracing.hpp"
-#include "Objects/Torus.hpp"
+#include "RayTracing/Checkpoint.hpp"
+#include "RayTracing/DefaultScene.hpp"
+#include "RayTracing/DeadlineRenderer.hpp"
+#include "RayTracing/DistributedRenderer.hpp"
+#include "RayTracing/FramePipeline.hpp"
+#include "RayTracing/GBuffer.hpp"
+#include "RayTracing/ImageWriter.hpp"
+#include "RayTracing/ProgressiveRenderer.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "RayTracing/RenderServer.hpp"
+#include "RayTracing/SceneCache.hpp"
+#include "RayTracing/SceneLoader.hpp"
+#include "RayTracing/SharedFramebuffer.hpp"
+#include "RayTracing/StreamRenderer.hpp"
+#include "Utilities/Arena.hpp"
+#include "Utilities/Kernels.hpp"
+#include "Utilities/MemoryAccounting.hpp"
+#include "Utilities/Numa.hpp"
+#include "Utilities/ThreadPool.hpp"
 
-void render_scene(const int width, const int height, const RayTracing::Scene& scene) {
-    constexpr glm::vec3 origin(0, 0, 0);
-    std::vector<RGB> framebuffer;
-    framebuffer.reserve(width * height);
-
-    for (int y {0}; y < height; ++y) {
-        const int y_canvas {height / 2 - y};
-        for (int x {0}; x < width; ++x) {
-            constexpr float d {1.0f};
-            constexpr float Vh {1.0f};
-            constexpr float Vw {1.0f};
-            const int x_canvas {x - width / 2};
-            glm::vec3 direction {glm::normalize(RayTracing::canvas_to_viewport(x_canvas, y_canvas, Vw, Vh, d, width, height))};
-            framebuffer.emplace_back(RayTracing::trace_ray(Ray(origin, direction), 1.0f, INFINITY, scene, 0));
+// Pixel memory of one whole frame held at once: the float framebuffer plus its encoding (QOI worst case)
+std::size_t full_frame_bytes(const int width, const int height) {
+    return static_cast<std::size_t>(width) * height * (sizeof(RGB) + 4);
+}
+
+void render_scene(const int width, const int height, const RayTracing::Scene& scene, const std::string& output, ThreadPool& pool) {
+    const Memory::Charge charge(Memory::Subsystem::Pixels, full_frame_bytes(width, height), "framebuffer");
+    // Untouched until the workers trace into it, so each page lands next to the thread that renders it
+    Memory::PageBuffer<RGB> framebuffer(static_cast<std::size_t>(width) * height);
+    RayTracing::render_into(scene, RayTracing::Camera{}, width, height, pool, framebuffer.span());
+
+    RayTracing::save_image(output, framebuffer.span(), width, height, &pool);
+    std::cout << "Render complete! Saved to " << output << "\n";
+}
+
+// Everything that decides the pixels of a checkpointed render, so a checkpoint is never resumed into a different image
+std::uint64_t checkpoint_fingerprint(const int width, const int height, const std::string& scene_id, const RayTracing::Scene& scene,
+                                     const RayTracing::Camera& camera, const Cpu::IsaLevel isa) {
+    RayTracing::Fingerprint fingerprint;
+    if (scene_id == "default") {
+        fingerprint.add(scene_id);
+    } else {
+        fingerprint.add_file(scene_id);
+    }
+    const RayTracing::SamplingSettings& sampling {scene.get_sampling()};
+    fingerprint.add_value(width).add_value(height)
+        .add_value(camera.position).add_value(camera.right).add_value(camera.up).add_value(camera.forward)
+        .add_value(camera.viewport_width).add_value(camera.viewport_height).add_value(camera.projection_distance)
+        .add_value(sampling.seed).add_value(sampling.min_samples).add_value(sampling.max_samples).add_value(sampling.tolerance)
+        .add(RayTracing::to_string(RayTracing::get_bvh_format())).add(Cpu::to_string(isa));
+    return fingerprint.value();
+}
+
+// Tile render that survives crashes: progress lives in checkpoint_path until the image is saved
+void render_scene_checkpointed(const int width, const int height, const RayTracing::Scene& scene, const std::string& scene_id, const std::string& output,
+                               const std::string& checkpoint_path, const bool resume, const Cpu::IsaLevel isa, ThreadPool& pool) {
+    constexpr int tile_size {32};
+    const RayTracing::Camera camera {};
+    RayTracing::Checkpoint checkpoint(checkpoint_path, width, height, tile_size, checkpoint_fingerprint(width, height, scene_id, scene, camera, isa), resume);
+    if (resume) {
+        std::cout << "Resuming from " << checkpoint_path << ": " << checkpoint.done_count() << " of "
+                  << checkpoint.tile_count() << " tiles already done\n";
+    }
+
+    const Memory::Charge charge(Memory::Subsystem::Pixels, full_frame_bytes(width, height), "framebuffer copy");
+    const std::vector<RGB> framebuffer {RayTracing::render_with_checkpoint(scene, camera, pool, checkpoint)};
+    RayTracing::save_image(output, framebuffer, width, height, &pool);
+    std::remove(checkpoint_path.c_str());
+    std::cout << "Render complete! Saved to " << output << "\n";
+}
+
+// Tile render published in shared memory as it progresses (follow it with ShmDump --shm=<name>)
+void render_scene_shared(const int width, const int height, const RayTracing::Scene& scene, const std::string& output,
+                         const std::string& shm_name, ThreadPool& pool) {
+    RayTracing::SharedFramebuffer shared(shm_name, width, height, 32);
+    std::cerr << "Publishing framebuffer as " << shared.get_name() << "\n";
+
+    const Memory::Charge charge(Memory::Subsystem::Pixels, full_frame_bytes(width, height), "framebuffer copy");
+    const std::vector<RGB> framebuffer {RayTracing::render_to_shared(scene, RayTracing::Camera{}, pool, shared)};
+    RayTracing::save_image(output, framebuffer, width, height, &pool);
+    std::cout << "Render complete! Saved to " << output << "\n";
+}
+
+// Coarse-to-fine render; every level replaces the output file as soon as it is complete
+void render_scene_progressive(const int width, const int height, const RayTracing::Scene& scene, const std::string& output, ThreadPool& pool) {
+    const Memory::Charge charge(Memory::Subsystem::Pixels, full_frame_bytes(width, height), "framebuffer");
+    const std::string partial {RayTracing::with_suffix(output, ".partial")};
+    RayTracing::render_progressive(scene, RayTracing::Camera{}, width, height, pool,
+        [&](const RayTracing::ProgressiveLevel& level, const std::vector<RGB>& framebuffer) {
+            // Write aside and rename, so a viewer polling the file never reads half an image
+            RayTracing::save_image(partial, framebuffer, width, height, &pool);
+            if (std::rename(partial.c_str(), output.c_str()) != 0) throw std::runtime_error("cannot replace " + output);
+            std::cerr << "Level " << level.index << " (1/" << level.stride * level.stride << " of the pixels traced) after "
+                      << level.elapsed_ms << " ms, " << level.traced << " new rays\n";
+        });
+    std::cout << "Render complete! Saved to " << output << "\n";
+}
+
+// Band-by-band render straight to disk; memory stays bounded for any resolution
+void render_scene_streaming(const int width, const int height, const RayTracing::Scene& scene, const std::string& output, const int band_height, ThreadPool& pool) {
+    const RayTracing::StreamStats stats {RayTracing::render_ppm_file(scene, RayTracing::Camera{}, width, height, pool, output, band_height)};
+    std::cout << "Render complete! Streamed " << stats.bands << " bands (" << stats.buffer_bytes / 1024
+              << " KiB in flight) to " << output << "\n";
+}
+
+// Best image that fits in budget_ms
+void render_scene_with_deadline(const int width, const int height, const RayTracing::Scene& scene, const std::string& output, const double budget_ms, ThreadPool& pool) {
+    const Memory::Charge charge(Memory::Subsystem::Pixels, full_frame_bytes(width, height), "framebuffer");
+    const RayTracing::DeadlineResult result {RayTracing::render_with_deadline(scene, RayTracing::Camera{}, width, height, pool, budget_ms)};
+    RayTracing::save_image(output, result.framebuffer, width, height, &pool);
+
+    std::cout << "Render complete in " << result.elapsed_ms << " ms of " << budget_ms << " ms (probe " << result.probe_ms
+              << " ms): " << result.quality.describe();
+    if (result.refined_fraction > 0) std::cout << ", " << static_cast<int>(result.refined_fraction * 100) << "% refined further";
+    std::cout << ". Saved to " << output << "\n";
+}
+
+// Tiles go to worker processes over TCP: spawn_count local ones started here, plus any that connect from elsewhere
+void render_distributed(const int width, const int height, const std::string& scene_id, const std::string& output, const std::string& endpoint,
+                        const std::size_t spawn_count, const unsigned threads, const Cpu::IsaLevel isa, ThreadPool& pool) {
+    const auto [host, port] {RayTracing::parse_endpoint(endpoint)};
+    RayTracing::TileCoordinator coordinator(host, port);
+    std::cout << "Coordinator listening on " << host << ":" << coordinator.get_port() << "\n";
+
+    // Local workers split this machine's threads and use the same kernels and hierarchy format
+    const bool wildcard {host == "0.0.0.0" || host == "::"};
+    std::vector<std::string> args {"RayTracer", "--worker=" + (wildcard ? std::string("127.0.0.1") : host) + ":" + std::to_string(coordinator.get_port()),
+                                   "--threads=" + std::to_string(std::max<std::size_t>(1, threads / std::max<std::size_t>(1, spawn_count))),
+                                   std::string("--isa=") + Cpu::to_string(isa), std::string("--bvh=") + RayTracing::to_string(RayTracing::get_bvh_format())};
+    std::vector<char*> argv;
+    for (std::string& arg : args) argv.push_back(arg.data());
+    argv.push_back(nullptr);
+
+    std::vector<pid_t> children;
+    const auto stop_children = [&](const int signal) {
+        for (const pid_t pid : children) {
+            if (signal != 0) ::kill(pid, signal);
+            ::waitpid(pid, nullptr, 0);
         }
+    };
+    for (std::size_t i {0}; i < spawn_count; ++i) {
+        pid_t pid;
+        if (::posix_spawn(&pid, "/proc/self/exe", nullptr, nullptr, argv.data(), environ) != 0) {
+            stop_children(SIGTERM);
+            throw std::runtime_error("cannot start worker process");
+        }
+        children.push_back(pid);
+    }
+
+    RayTracing::DistributedJob job;
+    job.scene_id = scene_id;
+    job.width = width;
+    job.height = height;
+
+    RayTracing::DistributedStats stats;
+    const Memory::Charge charge(Memory::Subsystem::Pixels, full_frame_bytes(width, height), "framebuffer");
+    std::vector<RGB> framebuffer;
+    try {
+        framebuffer = coordinator.render(job, &stats);
+    } catch (...) {
+        stop_children(SIGTERM);
+        throw;
     }
+    stop_children(0);
 
-    RayTracing::save_ppm_binary("output.ppm", framebuffer, width, height);
-    std::cout << "Render complete! Saved to output.ppm\n";
+    RayTracing::save_image(output, framebuffer, width, height, &pool);
+    std::cout << "Render complete in " << stats.elapsed_ms << " ms: " << stats.tiles << " tiles over " << stats.workers_seen
+              << " workers (" << stats.workers_lost << " lost, " << stats.tiles_reassigned << " tiles reassigned). Saved to " << output << "\n";
 }
 
-int main() {
-    constexpr int width = 600;
-    constexpr int height = 600;
-
-    // Create objects
-    std::vector<std::shared_ptr<Objects::IRenderable>> objects;
-    objects.emplace_back(std::make_shared<Objects::Sphere>(
-        RGB(255, 0, 0), 500, 0.1f, glm::vec3(0,-1,3), 1.0f
-    ));
-    objects.emplace_back(std::make_shared<Objects::Sphere>(
-        RGB(0, 0, 255), 500, 0.1f, glm::vec3(2,0,4), 1.0f
-    ));
-    objects.emplace_back(std::make_shared<Objects::Sphere>(
-        RGB(0, 255, 0), 10, 0.1f, glm::vec3(-2,0,4), 1.0f
-    ));
-    objects.emplace_back(std::make_shared<Objects::Sphere>(
-    RGB(180, 200, 100), 500, 0.0f, glm::vec3(0,0,11), 1.0f
-    ));
-
-    // Floor plane
-    objects.emplace_back(std::make_shared<Objects::Plane>(
-        RGB(200,200,200), 100, 0, glm::vec3(0,1,0), glm::vec3(0,-2,0)
-        ));
-
-    // Back Mirror plane
-    objects.emplace_back(std::make_shared<Objects::Plane>(
-    RGB(180,180,200), 500, 0.8f, glm::vec3(0,0,-1), glm::vec3(0,0,13)
-    ));
-
-    objects.emplace_back(std::make_shared<Objects::Cylinder>(
-        glm::vec3{-1,3,7}, 0.5f, 4, RGB{255, 0, 255}, 500, 0, glm::vec3{1, -1, 1}
-        ));
-
-    objects.emplace_back(std::make_shared<Objects::Torus>(
-        glm::vec3(0, 2.5, 7), 1.5f, 0.5f, RGB(0, 255, 255), 300, 0, glm::vec3(1, -1, 1)
-    ));
-    // const glm::vec3 &center_, const float &major_radius_, const float &minor_radius_, const RGB &color_, const int &specular_, const float &reflectivity_, const glm::vec3 &axis_
-
-// # Floating torus
-//     Torus(
-//         center=Vector(0, 2.5, 7),
-//         major_radius=1.5,
-//         minor_radius=0.5,
-//         color=(0, 255, 255),
-//         specular=300,
-//         axis=Vector(1, -1, 1)
-//     )
-
-    // Create lights
-    std::vector<std::shared_ptr<Objects::Light>> lights;
-    lights.emplace_back(std::make_shared<Objects::AmbientLight>(0.2f));
-    lights.emplace_back(std::make_shared<Objects::PointLight>(0.6f, glm::vec3(2,3,-2)));
-    lights.emplace_back(std::make_shared<Objects::DirectionalLight>(0.2f, glm::vec3(1, 4, 4)));
-
-    // Scene
-    const RayTracing::Scene scene(objects, lights);
-
-    // Render
-    render_scene(width, height, scene);
+// Camera orbit around the middle of the scene, frame 0 is the default view; writes output_NNNN.ext
+void render_orbit(const int width, const int height, const std::shared_ptr<const RayTracing::Scene>& scene, const std::string& output, const std::size_t frame_count,
+                  const std::optional<RayTracing::ReprojectionSettings>& reprojection, ThreadPool& pool) {
+    const glm::vec3 target {0.0f, 0.0f, 7.0f};
+    const auto source = [&](const std::size_t i) -> std::optional<RayTracing::Frame> {
+        if (i >= frame_count) return std::nullopt;
+        const float angle {0.5f * static_cast<float>(i) / static_cast<float>(frame_count)};
+        const glm::vec3 eye {target + 7.0f * glm::vec3(-std::sin(angle), 0.0f, -std::cos(angle))};
+
+        // "_" and up to 20 digits of a size_t, zero-padded to at least 4
+        char suffix[24];
+        std::snprintf(suffix, sizeof(suffix), "_%04zu", i);
+        return RayTracing::Frame{i, scene, RayTracing::Camera::look_at(eye, target), RayTracing::with_suffix(output, suffix)};
+    };
+
+    // Frames queued for writing on top of the one being traced
+    constexpr std::size_t queue_depth {2};
+    const Memory::Charge charge(Memory::Subsystem::Pixels, (queue_depth + 1) * full_frame_bytes(width, height), "frame pipeline");
+    const RayTracing::PipelineStats stats {RayTracing::render_sequence(source, width, height, pool, queue_depth, reprojection)};
+    std::cout << "Rendered " << stats.frames << " frames in " << stats.wall_ms << " ms (trace " << stats.trace_ms
+              << " ms, write " << stats.write_ms << " ms, update " << stats.update_ms << " ms). Saved to "
+              << RayTracing::with_suffix(output, "_NNNN") << "\n";
+    if (reprojection) {
+        const double total {static_cast<double>(stats.traced_pixels + stats.reused_pixels)};
+        std::cout << "Reprojection reused " << (total > 0 ? 100.0 * static_cast<double>(stats.reused_pixels) / total : 0.0)
+                  << "% of pixels, traced " << stats.traced_pixels << "\n";
+    }
+}
+
+// G-buffer pass with the scene's own lights, then a relight with the lights from lights_path
+void render_and_relight(const int width, const int height, const RayTracing::Scene& scene, const std::string& output, const std::string& lights_path, ThreadPool& pool) {
+    using Clock = std::chrono::steady_clock;
+    const auto ms = [](const Clock::time_point a, const Clock::time_point b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+
+    const auto t0 {Clock::now()};
+    const Memory::Charge charge(Memory::Subsystem::Pixels, full_frame_bytes(width, height), "framebuffer");
+    const RayTracing::GBuffer gbuffer {RayTracing::GBuffer::build(scene, RayTracing::Camera{}, width, height, pool)};
+    const auto t1 {Clock::now()};
+    RayTracing::save_image(output, gbuffer.relight(scene, pool), width, height, &pool);
+
+    RayTracing::Scene relit {scene};
+    relit.set_lights(RayTracing::load_scene(lights_path).get_lights());
+    const auto t2 {Clock::now()};
+    const std::vector<RGB> framebuffer {gbuffer.relight(relit, pool)};
+    const auto t3 {Clock::now()};
+    const std::string relit_output {RayTracing::with_suffix(output, "_relit")};
+    RayTracing::save_image(relit_output, framebuffer, width, height, &pool);
+
+    std::cout << "G-buffer pass " << ms(t0, t1) << " ms (" << gbuffer.memory_bytes() / 1024 << " KiB), relight "
+              << ms(t2, t3) << " ms. Saved to " << output << " and " << relit_output << "\n";
+}
+
+// Scene ids: "default" is the built-in scene above, anything else is a scene file path (compiled on pool if given)
+std::shared_ptr<const RayTracing::Scene> load_scene_by_id(const std::string& id, ThreadPool* pool, const bool per_node) {
+    auto scene {std::make_shared<RayTracing::Scene>(id == "default" ? RayTracing::make_default_scene() : RayTracing::load_scene(id, pool))};
+    if (per_node) scene->replicate_per_node();
+    return scene;
+}
+
+int main(int argc, char* argv[]) {
+    int width {600};
+    int height {600};
+
+    // Options
+    //   --isa=<scalar|sse4.2|avx2|avx512>  force a kernel level (beats RAYTRACER_ISA, which beats CPUID)
+    //   --scene=<id>                       "default" or a scene file
+    //   --threads=<n>                      worker threads (default: all cores)
+    //   --serve                            read render jobs from stdin, answer on stdout
+    //   --socket=<path>                    read render jobs from a Unix domain socket
+    //   --scene-cache=<n>                  compiled scenes kept warm in server mode (default 8)
+    //   --relight=<file>                   G-buffer render, then relight with the lights listed in file
+    //   --output=<path>                    image file, .ppm or .qoi (default output.ppm)
+    //   --checkpoint[=<path>]              keep progress in a checkpoint file (default <output>.ckpt)
+    //   --resume                           continue from the checkpoint of an interrupted run
+    //   --shm=<name>                       publish the framebuffer in POSIX shared memory while rendering
+    //   --size=<W>x<H>                     image size (default 600x600)
+    //   --stream[=<rows>]                  render in bands of rows (default 32) straight to disk
+    //   --deadline=<ms>                    best quality that fits in the time budget
+    //   --progressive                      publish 1/16- and 1/4-resolution previews to the output file before the full image
+    //   --frames=<n>                       render an n-frame camera orbit through the frame pipeline
+    //   --reproject[=<fraction>]           with --frames, reuse the previous frame's shading; re-trace fraction of pixels each frame regardless (default 0.05)
+    //   --coordinator[=<host>:<port>]      hand tiles to worker processes over TCP (default 127.0.0.1:0, any free port)
+    //   --workers=<n>                      start n local worker processes (implies --coordinator)
+    //   --worker=<host>:<port>             render tiles for the coordinator at host:port, then exit
+    //   --memory-budget=<bytes>[K|M|G]     fail early, or stream in bands, rather than exceed this much memory
+    //   --memory-report                    print memory use per subsystem after loading the scene and after the frame
+    //   --build-report                     print the time spent in each phase of the scene build
+    //   --huge-pages=<default|transparent|explicit>  back scene arenas and the framebuffer with huge pages
+    //   --bvh=<binary|wide>                hierarchy of large scenes: binary nodes, or 8-wide nodes with quantised boxes
+    //   --numa                             pin workers across NUMA nodes and give each node its own copy of the scene arrays
+    //   --seed=<n>                         sampling seed for area lights and glossy reflections (overrides the scene file)
+    Cpu::IsaLevel isa {Kernels::default_level()};
+    std::string scene_id {"default"};
+    std::string socket_path;
+    std::string relight_path;
+    std::string output {"output.ppm"};
+    std::string checkpoint_path;
+    bool checkpoint {false};
+    bool resume {false};
+    std::string shm_name;
+    unsigned threads {std::thread::hardware_concurrency()};
+    std::size_t cache_capacity {8};
+    int band_height {0};
+    double deadline_ms {0.0};
+    std::size_t frame_count {0};
+    bool progressive {false};
+    std::optional<RayTracing::ReprojectionSettings> reprojection;
+    bool serve {false};
+    std::string coordinator_endpoint;
+    std::string worker_endpoint;
+    std::size_t spawn_workers {0};
+    std::size_t memory_budget {0};
+    bool memory_report {false};
+    bool build_report {false};
+    bool numa {false};
+    std::optional<std::uint32_t> seed;
+
+    try {
+        for (int i {1}; i < argc; ++i) {
+            const std::string_view arg {argv[i]};
+            const auto value = [&](const std::string_view prefix) { return std::string(arg.substr(prefix.size())); };
+
+            if (arg.starts_with("--isa=")) {
+                const auto forced {Cpu::parse_isa_level(arg.substr(6))};
+                if (!forced) throw std::invalid_argument("unknown ISA level '" + value("--isa=") + "'");
+                isa = *forced;
+            } else if (arg.starts_with("--scene=")) {
+                scene_id = value("--scene=");
+            } else if (arg.starts_with("--threads=")) {
+                threads = static_cast<unsigned>(std::stoul(value("--threads=")));
+            } else if (arg == "--serve") {
+                serve = true;
+            } else if (arg.starts_with("--socket=")) {
+                socket_path = value("--socket=");
+                serve = true;
+            } else if (arg.starts_with("--scene-cache=")) {
+                cache_capacity = std::stoul(value("--scene-cache="));
+            } else if (arg.starts_with("--relight=")) {
+                relight_path = value("--relight=");
+            } else if (arg.starts_with("--output=")) {
+                output = value("--output=");
+            } else if (arg == "--checkpoint") {
+                checkpoint = true;
+            } else if (arg.starts_with("--checkpoint=")) {
+                checkpoint = true;
+                checkpoint_path = value("--checkpoint=");
+            } else if (arg == "--resume") {
+                checkpoint = true;
+                resume = true;
+            } else if (arg.starts_with("--shm=")) {
+                shm_name = value("--shm=");
+                if (shm_name.empty()) throw std::invalid_argument("expected --shm=<name>");
+            } else if (arg.starts_with("--size=")) {
+                const std::string size {value("--size=")};
+                const std::size_t x {size.find('x')};
+                if (x == std::string::npos) throw std::invalid_argument("expected --size=WxH but got '" + size + "'");
+                width = std::stoi(size.substr(0, x));
+                height = std::stoi(size.substr(x + 1));
+                if (width <= 0 || height <= 0) throw std::invalid_argument("image size must be positive");
+            } else if (arg == "--stream") {
+                band_height = 32;
+            } else if (arg.starts_with("--stream=")) {
+                band_height = std::stoi(value("--stream="));
+                if (band_height <= 0) throw std::invalid_argument("band height must be positive");
+            } else if (arg.starts_with("--deadline=")) {
+                deadline_ms = std::stod(value("--deadline="));
+                if (deadline_ms <= 0) throw std::invalid_argument("deadline must be positive");
+            } else if (arg == "--progressive") {
+                progressive = true;
+            } else if (arg.starts_with("--frames=")) {
+                frame_count = std::stoul(value("--frames="));
+            } else if (arg == "--reproject") {
+                reprojection.emplace();
+            } else if (arg.starts_with("--reproject=")) {
+                reprojection.emplace();
+                reprojection->refresh_fraction = std::stof(value("--reproject="));
+                if (!(reprojection->refresh_fraction >= 0.0f && reprojection->refresh_fraction <= 1.0f)) {
+                    throw std::invalid_argument("refresh fraction must be between 0 and 1");
+                }
+            } else if (arg == "--coordinator") {
+                coordinator_endpoint = "127.0.0.1:0";
+            } else if (arg.starts_with("--coordinator=")) {
+                coordinator_endpoint = value("--coordinator=");
+            } else if (arg.starts_with("--workers=")) {
+                spawn_workers = std::stoul(value("--workers="));
+                if (coordinator_endpoint.empty()) coordinator_endpoint = "127.0.0.1:0";
+            } else if (arg.starts_with("--worker=")) {
+                worker_endpoint = value("--worker=");
+            } else if (arg.starts_with("--memory-budget=")) {
+                const auto bytes {Memory::parse_bytes(arg.substr(16))};
+                if (!bytes || *bytes == 0) throw std::invalid_argument("expected --memory-budget=<bytes>[K|M|G] but got '" + value("--memory-budget=") + "'");
+                memory_budget = *bytes;
+            } else if (arg == "--memory-report") {
+                memory_report = true;
+            } else if (arg == "--build-report") {
+                build_report = true;
+            } else if (arg.starts_with("--huge-pages=")) {
+                const auto policy {Memory::parse_page_policy(arg.substr(13))};
+                if (!policy) throw std::invalid_argument("expected --huge-pages=default|transparent|explicit but got '" + value("--huge-pages=") + "'");
+                Memory::set_page_policy(*policy);
+            } else if (arg.starts_with("--bvh=")) {
+                const auto format {RayTracing::parse_bvh_format(arg.substr(6))};
+                if (!format) throw std::invalid_argument("expected --bvh=binary|wide but got '" + value("--bvh=") + "'");
+                RayTracing::set_bvh_format(*format);
+            } else if (arg == "--numa") {
+                numa = true;
+            } else if (arg.starts_with("--seed=")) {
+                seed = static_cast<std::uint32_t>(std::stoul(value("--seed=")));
+            } else {
+                throw std::invalid_argument("unknown option '" + std::string(arg) + "'");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (band_height > 0 && !output.ends_with(".ppm")) {
+        std::cerr << "Error: --stream writes PPM only\n";
+        return 1;
+    }
+
+    if (!shm_name.empty() && (serve || checkpoint || !relight_path.empty() || frame_count > 0 || deadline_ms > 0 || band_height > 0
+                              || !coordinator_endpoint.empty() || !worker_endpoint.empty())) {
+        std::cerr << "Error: --shm applies to plain tile renders only\n";
+        return 1;
+    }
+
+    if (progressive && (serve || checkpoint || !relight_path.empty() || frame_count > 0 || deadline_ms > 0 || band_height > 0
+                        || !shm_name.empty() || !coordinator_endpoint.empty() || !worker_endpoint.empty())) {
+        std::cerr << "Error: --progressive applies to plain tile renders only\n";
+        return 1;
+    }
+
+    if (reprojection && (frame_count == 0 || checkpoint || !relight_path.empty())) {
+        std::cerr << "Error: --reproject applies to --frames orbits only\n";
+        return 1;
+    }
+
+    if (seed && (serve || !coordinator_endpoint.empty() || !worker_endpoint.empty())) {
+        std::cerr << "Error: --seed applies to local renders only (put a sampling line in the scene file instead)\n";
+        return 1;
+    }
+
+    isa = Kernels::select(isa);
+    std::cerr << "Using " << Cpu::to_string(isa) << " kernels (CPU supports "
+              << Cpu::to_string(Cpu::detect_isa_level()) << ")\n";
+
+    ThreadPool pool(threads);
+    if (numa) {
+        Numa::spread_workers(pool);
+        std::cerr << "NUMA: " << Numa::node_count() << " node(s), workers spread across them\n";
+    }
+    Memory::Accounting& memory {Memory::Accounting::instance()};
+    memory.set_budget(memory_budget);
+
+    // Scenes are only loaded outside pool tasks, so they can build on the pool
+    const auto load_scene_on_pool = [&pool, numa](const std::string& id) { return load_scene_by_id(id, &pool, numa); };
+
+    try {
+        if (serve) {
+            RayTracing::SceneCache cache(cache_capacity, load_scene_on_pool);
+            RayTracing::RenderServer server(cache, pool);
+            if (socket_path.empty()) {
+                server.serve(std::cin, std::cout);
+            } else {
+                std::cerr << "Listening on " << socket_path << "\n";
+                server.serve_unix_socket(socket_path);
+            }
+            return 0;
+        }
+
+        if (!worker_endpoint.empty()) {
+            const auto [host, port] {RayTracing::parse_endpoint(worker_endpoint)};
+            const std::size_t tiles {RayTracing::run_tile_worker(host, port, load_scene_on_pool, pool)};
+            std::cerr << "Worker done after " << tiles << " tiles\n";
+            return 0;
+        }
+        if (!coordinator_endpoint.empty()) {
+            // Workers load the scene themselves
+            render_distributed(width, height, scene_id, output, coordinator_endpoint, spawn_workers, threads, isa, pool);
+            return 0;
+        }
+
+        // Scene
+        std::shared_ptr<const RayTracing::Scene> scene {load_scene_on_pool(scene_id)};
+        if (build_report) std::cerr << "Scene build: " << scene->get_build_stats().describe() << "\n";
+        if (seed) {
+            auto seeded {std::make_shared<RayTracing::Scene>(*scene)};
+            RayTracing::SamplingSettings sampling {seeded->get_sampling()};
+            sampling.seed = *seed;
+            seeded->set_sampling(sampling);
+            scene = std::move(seeded);
+        }
+        if (memory_report) std::cerr << "Memory after scene compile: " << memory.report() << "\n";
+
+        // Render
+        if (!relight_path.empty()) {
+            render_and_relight(width, height, *scene, output, relight_path, pool);
+        } else if (checkpoint) {
+            render_scene_checkpointed(width, height, *scene, scene_id, output, checkpoint_path.empty() ? output + ".ckpt" : checkpoint_path,
+                                      resume, isa, pool);
+        } else if (frame_count > 0) {
+            render_orbit(width, height, scene, output, frame_count, reprojection, pool);
+        } else if (deadline_ms > 0) {
+            render_scene_with_deadline(width, height, *scene, output, deadline_ms, pool);
+        } else if (band_height > 0) {
+            render_scene_streaming(width, height, *scene, output, band_height, pool);
+        } else if (!shm_name.empty()) {
+            render_scene_shared(width, height, *scene, output, shm_name, pool);
+        } else if (progressive) {
+            render_scene_progressive(width, height, *scene, output, pool);
+        } else if (full_frame_bytes(width, height) <= memory.headroom()) {
+            render_scene(width, height, *scene, output, pool);
+        } else {
+            // The whole frame does not fit: stream bands of as many rows as fit instead
+            if (!output.ends_with(".ppm")) {
+                throw Memory::BudgetExceeded("the " + Memory::format_bytes(full_frame_bytes(width, height)) + " framebuffer does not fit the memory budget ("
+                                             + memory.report() + "); write a .ppm to stream it in bands");
+            }
+            int rows {32};
+            while (rows > 1 && RayTracing::stream_buffer_bytes(width, height, rows, 0, pool) > memory.headroom()) rows /= 2;
+            if (RayTracing::stream_buffer_bytes(width, height, rows, 0, pool) > memory.headroom()) {
+                throw Memory::BudgetExceeded("not even a one-row stream window fits the memory budget (" + memory.report() + ")");
+            }
+            std::cerr << "The " << Memory::format_bytes(full_frame_bytes(width, height)) << " framebuffer does not fit the memory budget, streaming bands of "
+                      << rows << " rows instead\n";
+            render_scene_streaming(width, height, *scene, output, rows, pool);
+        }
+        if (memory_report) std::cerr << "Memory at frame end: " << memory.report() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,1206 @@
+//
+// tests/DifferentialTests.cpp
+//
+// Differential validation: the production intersection, solver, kernel and
+// rendering paths against slow double-precision references and against each
+// other. Rays per case default to 100000 and scale with RT_DIFF_RAYS.
+//
+// Each reference also says whether a ray is robust, i.e. far enough from
+// tangency, edges and t_min that float code must agree with it. Only robust
+// rays are compared; the rest (deliberately many in the adversarial cases)
+// must merely not crash.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+
+#include "Objects/Cone.hpp"
+#include "Objects/Cylinder.hpp"
+#include "Objects/Ellipsoid.hpp"
+#include "Objects/Light.hpp"
+#include "Objects/Plane.hpp"
+#include "Objects/Sphere.hpp"
+#include "Objects/Torus.hpp"
+#include "RayTracing/GBuffer.hpp"
+#include "RayTracing/ProgressiveRenderer.hpp"
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "RayTracing/SceneGenerator.hpp"
+#include "RayTracing/SceneLoader.hpp"
+#include "RayTracing/StreamRenderer.hpp"
+#include "RayTracing/TemporalReprojector.hpp"
+#include "Utilities/Arena.hpp"
+#include "Utilities/Cpu.hpp"
+#include "Utilities/Kernels.hpp"
+#include "Utilities/Math.hpp"
+#include "Utilities/Ray.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace {
+
+constexpr double T_MIN {1e-3};
+
+std::size_t ray_budget() {
+  if (const char* env {std::getenv("RT_DIFF_RAYS")}) return std::max<std::size_t>(1000, std::stoul(env));
+  return 100000;
+}
+
+// ---------------------------
+// Double-precision vectors
+// ---------------------------
+
+struct V {
+  double x, y, z;
+};
+
+V to_v(const glm::vec3& v) { return {v.x, v.y, v.z}; }
+V operator+(const V& a, const V& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+V operator-(const V& a, const V& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+V operator*(const V& a, const double s) { return {a.x * s, a.y * s, a.z * s}; }
+double dot(const V& a, const V& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+double length(const V& a) { return std::sqrt(dot(a, a)); }
+V normalize(const V& a) { return a * (1.0 / length(a)); }
+V cross(const V& a, const V& b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+
+struct RefHit {
+  std::optional<double> t;  // nearest t > T_MIN
+  V normal {0, 0, 0};
+  bool robust {true};
+};
+
+// Nearest hit among reference candidates, plus robustness against t_min
+void keep_nearest(RefHit& hit, const double t, const V& normal) {
+  if (std::abs(t - T_MIN) < 1e-4) hit.robust = false;
+  if (t > T_MIN && (!hit.t || t < *hit.t)) {
+    hit.t = t;
+    hit.normal = normal;
+  }
+}
+
+// ---------------------------
+// Reference intersections
+// ---------------------------
+
+RefHit ref_sphere(const V& c, const double r, const V& O, const V& D) {
+  RefHit hit;
+  const V oc {O - c};
+  const double b {dot(oc, D)};
+  const double disc {b * b - (dot(oc, oc) - r * r)};
+  if (std::abs(disc) < 1e-4 * r * r) hit.robust = false;
+  if (disc < 0) return hit;
+  const double s {std::sqrt(disc)};
+  for (const double t : {-b - s, -b + s}) keep_nearest(hit, t, normalize(O + D * t - c));
+  return hit;
+}
+
+RefHit ref_plane(const V& n, const V& p, const V& O, const V& D) {
+  RefHit hit;
+  const double denom {dot(D, n)};
+  if (std::abs(denom) < 1e-3) {
+    hit.robust = false;
+    return hit;
+  }
+  keep_nearest(hit, dot(p - O, n) / denom, n);
+  return hit;
+}
+
+RefHit ref_cylinder(const V& base, const V& a, const double r, const double height, const V& O, const V& D) {
+  RefHit hit;
+  const V co {O - base};
+  const V d_perp {D - a * dot(D, a)};
+  const V o_perp {co - a * dot(co, a)};
+
+  // Side
+  const double A {dot(d_perp, d_perp)};
+  if (A > 1e-9) {
+    const double B {dot(d_perp, o_perp)};
+    const double closest2 {dot(o_perp, o_perp) - B * B / A};  // squared distance of the line from the axis
+    if (std::abs(closest2 - r * r) < 1e-4 * r * r) hit.robust = false;
+    if (closest2 < r * r) {
+      const double half_chord {std::sqrt((r * r - closest2) / A)};
+      for (const double t : {-B / A - half_chord, -B / A + half_chord}) {
+        const double h {dot(co + D * t, a)};
+        if (std::abs(h) < 1e-4 || std::abs(h - height) < 1e-4) hit.robust = false;
+        if (h >= 0 && h <= height) keep_nearest(hit, t, normalize(co + D * t - a * h));
+      }
+    }
+  }
+
+  // Caps
+  for (const auto& [cap_h, n] : {std::pair{0.0, a * -1.0}, std::pair{height, a}}) {
+    const double denom {dot(D, n)};
+    if (std::abs(denom) < 1e-12) continue;
+    const V cap_center {base + a * cap_h};
+    const double t {dot(cap_center - O, n) / denom};
+    const double rho {length(O + D * t - cap_center)};
+    if (std::abs(rho - r) < 1e-4) hit.robust = false;
+    if (t > 0 && rho <= r) {
+      if (std::abs(denom) < 1e-3) hit.robust = false;
+      keep_nearest(hit, t, n);
+    }
+  }
+  return hit;
+}
+
+RefHit ref_cone(const V& apex, const V& a, const double k, const double height, const V& O, const V& D) {
+  RefHit hit;
+  const V co {O - apex};
+  const double dh {dot(D, a)};
+  const double oh {dot(co, a)};
+  const V d_perp {D - a * dh};
+  const V o_perp {co - a * oh};
+
+  // Side: |q_perp|^2 = k^2 h^2 with 0 <= h <= height
+  const double A {dot(d_perp, d_perp) - k * k * dh * dh};
+  const double B {dot(d_perp, o_perp) - k * k * dh * oh};
+  const double C {dot(o_perp, o_perp) - k * k * oh * oh};
+  if (std::abs(A) < 1e-3) hit.robust = false;  // nearly parallel to a generator line
+  if (std::abs(A) > 1e-12) {
+    const double disc {B * B - A * C};
+    if (std::abs(disc) < 1e-4 * (B * B + std::abs(A * C))) hit.robust = false;
+    if (disc >= 0) {
+      const double s {std::sqrt(disc)};
+      for (const double t : {(-B - s) / A, (-B + s) / A}) {
+        const V q {co + D * t};
+        const double h {dot(q, a)};
+        if (std::abs(h) < 1e-3 || std::abs(h - height) < 1e-4) hit.robust = false;
+        if (h >= 0 && h <= height) keep_nearest(hit, t, normalize((q - a * h) - a * (k * k * h)));
+      }
+    }
+  }
+
+  // Base cap
+  const double denom {dot(D, a)};
+  if (std::abs(denom) > 1e-12) {
+    const V cap_center {apex + a * height};
+    const double t {dot(cap_center - O, a) / denom};
+    const double rho {length(O + D * t - cap_center)};
+    if (std::abs(rho - k * height) < 1e-4) hit.robust = false;
+    if (t > 0 && rho <= k * height) {
+      if (std::abs(denom) < 1e-3) hit.robust = false;
+      keep_nearest(hit, t, a);
+    }
+  }
+  return hit;
+}
+
+RefHit ref_ellipsoid(const V& c, const V& radii, const V& O, const V& D) {
+  // A unit sphere after scaling each axis by 1 / radius
+  const auto scale = [&](const V& v) { return V{v.x / radii.x, v.y / radii.y, v.z / radii.z}; };
+  RefHit hit;
+  const V o {scale(O - c)};
+  const V d {scale(D)};
+  const double A {dot(d, d)};
+  const double B {dot(o, d)};
+  const double disc {B * B - A * (dot(o, o) - 1)};
+  if (std::abs(disc) < 1e-4 * A) hit.robust = false;
+  if (disc < 0) return hit;
+  const double s {std::sqrt(disc)};
+  for (const double t : {(-B - s) / A, (-B + s) / A}) keep_nearest(hit, t, normalize(scale(scale(O + D * t - c))));
+  return hit;
+}
+
+struct TorusFrame {
+  V center, u, v, w;
+  double R, r;
+
+  V local(const V& p) const {
+    const V q {p - center};
+    return {dot(q, u), dot(q, v), dot(q, w)};
+  }
+
+  // Squared distance to the tube's centre circle minus r^2: negative inside
+  double g(const V& p) const {
+    const V l {local(p)};
+    const double rho {std::sqrt(l.x * l.x + l.y * l.y)};
+    return (rho - R) * (rho - R) + l.z * l.z - r * r;
+  }
+
+  V normal(const V& p) const {
+    const V l {local(p)};
+    const double rho {std::sqrt(l.x * l.x + l.y * l.y)};
+    const V n_local {l.x - (rho > 0 ? R * l.x / rho : R), l.y - (rho > 0 ? R * l.y / rho : 0.0), l.z};
+    const V n {normalize(n_local)};
+    return normalize(u * n.x + v * n.y + w * n.z);
+  }
+};
+
+TorusFrame torus_frame(const Objects::Torus& torus, const V& center, const double R, const double r) {
+  const V w {to_v(torus.get_axis())};
+  const V pick {std::abs(w.x) < 0.9 ? V{1, 0, 0} : V{0, 1, 0}};
+  const V u {normalize(cross(pick, w))};
+  return {center, u, cross(w, u), w, R, r};
+}
+
+RefHit ref_torus(const TorusFrame& f, const V& O, const V& D) {
+  RefHit hit;
+
+  // Only the span inside a slightly padded bounding sphere can contain roots
+  const double bound {(f.R + f.r) * 1.01};
+  const V oc {O - f.center};
+  const double b {dot(oc, D)};
+  const double disc {b * b - (dot(oc, oc) - bound * bound)};
+  if (disc <= 0) return hit;
+  const double t_end {-b + std::sqrt(disc)};
+  double t0 {std::max(T_MIN, -b - std::sqrt(disc))};
+  if (t0 >= t_end) return hit;
+
+  const double r2 {f.r * f.r};
+  const double step {f.r / 64};
+  double g0 {f.g(O + D * t0)};
+  if (std::abs(g0) < 1e-3 * r2) hit.robust = false;
+
+  while (t0 < t_end) {
+    const double t1 {std::min(t0 + step, t_end)};
+    const double g1 {f.g(O + D * t1)};
+    if ((g0 < 0) != (g1 < 0)) {
+      double lo {t0}, hi {t1};
+      for (int i {0}; i < 60; ++i) {
+        const double mid {0.5 * (lo + hi)};
+        ((f.g(O + D * mid) < 0) == (g0 < 0) ? lo : hi) = mid;
+      }
+      const double t {0.5 * (lo + hi)};
+      // Near-tangent hits are ill-conditioned: |dg/dt| = 2 r cos(angle to the normal)
+      const double slope {(f.g(O + D * (t + 1e-6)) - f.g(O + D * (t - 1e-6))) / 2e-6};
+      if (std::abs(slope) < 0.1 * f.r) hit.robust = false;
+      keep_nearest(hit, t, f.normal(O + D * t));
+      return hit;
+    }
+    // A shallow positive dip may hide a tangent crossing between samples
+    if (g1 > 0 && g1 < 4e-3 * r2) hit.robust = false;
+    t0 = t1;
+    g0 = g1;
+  }
+  return hit;
+}
+
+// ---------------------------
+// Comparison harness
+// ---------------------------
+
+struct Tally {
+  std::size_t rays {0}, robust {0}, status_mismatch {0}, t_mismatch {0}, normal_mismatch {0};
+  double worst_t_error {0};
+
+  std::string describe() const {
+    std::ostringstream out;
+    out << rays << " rays, " << robust << " robust: " << status_mismatch << " hit/miss, " << t_mismatch << " t, "
+        << normal_mismatch << " normal mismatches (worst relative t error " << worst_t_error << ")";
+    return out.str();
+  }
+};
+
+template <typename Reference>
+Tally compare(const Objects::IRenderable& object, const Reference& reference, const std::vector<Ray>& rays, const double t_tolerance) {
+  Tally tally;
+  for (const Ray& ray : rays) {
+    ++tally.rays;
+
+    std::optional<float> fast;
+    for (const float t : object.intersect(ray)) {
+      if (t > static_cast<float>(T_MIN) && (!fast || t < *fast)) fast = t;
+    }
+    // Same line, but with a direction that is unit in double: float normalisation
+    // leaves |D|^2 - 1 ~ 1e-7, which far origins would amplify into the reference
+    const RefHit ref {reference(to_v(ray.get_origin()), normalize(to_v(ray.get_direction())))};
+    if (!ref.robust) continue;
+    ++tally.robust;
+
+    if (fast.has_value() != ref.t.has_value()) {
+      ++tally.status_mismatch;
+      continue;
+    }
+    if (!fast) continue;
+
+    const double error {std::abs(*fast - *ref.t) / (1.0 + std::abs(*ref.t))};
+    tally.worst_t_error = std::max(tally.worst_t_error, error);
+    if (error > t_tolerance) {
+      ++tally.t_mismatch;
+      continue;
+    }
+    if (dot(to_v(object.normal_at(ray.at(*fast))), ref.normal) < 0.999) ++tally.normal_mismatch;
+  }
+  return tally;
+}
+
+// Robust rays may disagree at most this often (float vs double near the robustness margins)
+// Counts go to the test's properties (--gtest_output=xml), so passing runs stay quiet
+void record_counts(const std::string& what, const std::string& counts) {
+  std::string key {what};
+  std::ranges::replace_if(key, [](const char c) { return !std::isalnum(static_cast<unsigned char>(c)); }, '_');
+  ::testing::Test::RecordProperty(key, counts);
+}
+
+void expect_agreement(const Tally& tally, const double rate, const std::string& what) {
+  record_counts(what, tally.describe());
+  const auto allowed = static_cast<std::size_t>(rate * static_cast<double>(tally.robust));
+  EXPECT_GT(tally.robust, tally.rays / 20) << what << ": too few robust rays to mean anything";
+  EXPECT_LE(tally.status_mismatch, allowed) << what << ": " << tally.describe();
+  EXPECT_LE(tally.t_mismatch, allowed) << what << ": " << tally.describe();
+  EXPECT_LE(tally.normal_mismatch, allowed) << what << ": " << tally.describe();
+}
+
+// ---------------------------
+// Ray generators
+// ---------------------------
+
+class RayFactory {
+  std::mt19937 rng;
+
+public:
+  explicit RayFactory(const unsigned seed) : rng(seed) {}
+
+  float uniform(const float lo, const float hi) { return std::uniform_real_distribution<float>(lo, hi)(rng); }
+
+  glm::vec3 in_box(const glm::vec3& center, const float half) {
+    return center + glm::vec3(uniform(-half, half), uniform(-half, half), uniform(-half, half));
+  }
+
+  glm::vec3 unit() {
+    for (;;) {
+      const glm::vec3 v {uniform(-1, 1), uniform(-1, 1), uniform(-1, 1)};
+      if (const float l2 {glm::dot(v, v)}; l2 > 1e-4f && l2 <= 1.0f) return v / std::sqrt(l2);
+    }
+  }
+
+  // Unit vector perpendicular to d
+  glm::vec3 perpendicular(const glm::vec3& d) {
+    for (;;) {
+      const glm::vec3 p {glm::cross(d, unit())};
+      if (glm::dot(p, p) > 1e-4f) return glm::normalize(p);
+    }
+  }
+
+  // Half the rays aim near the object (so about half hit), half point anywhere
+  std::vector<Ray> random(const std::size_t n, const glm::vec3& center, const float extent) {
+    std::vector<Ray> rays;
+    rays.reserve(n);
+    for (std::size_t i {0}; i < n; ++i) {
+      const glm::vec3 origin {in_box(center, 4 * extent)};
+      const glm::vec3 direction {i % 2 ? unit() : in_box(center, extent) - origin};
+      rays.emplace_back(origin, direction);
+    }
+    return rays;
+  }
+
+  // Origins strictly inside a ball
+  std::vector<Ray> from_inside(const std::size_t n, const glm::vec3& center, const float radius) {
+    std::vector<Ray> rays;
+    rays.reserve(n);
+    for (std::size_t i {0}; i < n; ++i) rays.emplace_back(center + unit() * uniform(0, radius), unit());
+    return rays;
+  }
+};
+
+}  // namespace
+
+// ---------------------------------
+// Primitive intersections
+// ---------------------------------
+
+TEST(Differential_Sphere, AgreesWithReference) {
+  const glm::vec3 c {0.3f, -0.2f, 0.5f};
+  constexpr float r {1.2f};
+  const Objects::Sphere sphere(RGB(255, 0, 0), 10, 0.0f, c, r);
+  const auto reference = [&](const V& O, const V& D) { return ref_sphere(to_v(c), r, O, D); };
+  const std::size_t n {ray_budget()};
+  RayFactory factory(1);
+
+  expect_agreement(compare(sphere, reference, factory.random(n, c, r), 1e-4), 1e-4, "sphere random");
+  expect_agreement(compare(sphere, reference, factory.from_inside(n, c, 0.99f * r), 1e-4), 1e-4, "sphere inside");
+
+  // Grazing: lines passing at r (1 +- 1e-3) from the centre
+  std::vector<Ray> grazing;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 d {factory.unit()};
+    const glm::vec3 offset {factory.perpendicular(d) * (r * (1.0f + factory.uniform(-1e-3f, 1e-3f)))};
+    grazing.emplace_back(c + offset - d * factory.uniform(2, 10), d);
+  }
+  expect_agreement(compare(sphere, reference, grazing, 1e-4), 1e-4, "sphere grazing");
+
+  // Far origins stress float cancellation in the quadratic
+  std::vector<Ray> far;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 origin {c + factory.unit() * 500.0f};
+    far.emplace_back(origin, factory.in_box(c, r) - origin);
+  }
+  expect_agreement(compare(sphere, reference, far, 1e-4), 1e-4, "sphere far");
+}
+
+TEST(Differential_Plane, AgreesWithReference) {
+  const glm::vec3 n {glm::normalize(glm::vec3(0.2f, 1.0f, 0.3f))};
+  const glm::vec3 p {0.1f, -0.5f, 0.2f};
+  const Objects::Plane plane(RGB(200, 200, 200), 100, 0.0f, n, p);
+  const auto reference = [&](const V& O, const V& D) { return ref_plane(to_v(plane.get_normal()), to_v(p), O, D); };
+  const std::size_t count {ray_budget()};
+  RayFactory factory(2);
+
+  // Regression: offset origins used to be ignored (point - direction instead of point - origin)
+  const Ray down {{3.0f, 4.0f, -2.0f}, -n};
+  const auto hits {plane.intersect(down)};
+  ASSERT_EQ(hits.size(), 1u);
+  EXPECT_NEAR(hits[0], glm::dot(glm::vec3(3.0f, 4.0f, -2.0f) - p, n), 1e-4f);
+
+  expect_agreement(compare(plane, reference, factory.random(count, p, 2.0f), 1e-4), 1e-4, "plane random");
+
+  // Nearly parallel rays, both sides of the plane
+  std::vector<Ray> parallel;
+  for (std::size_t i {0}; i < count; ++i) {
+    const glm::vec3 along {factory.perpendicular(n)};
+    const glm::vec3 d {along + n * factory.uniform(-2e-3f, 2e-3f)};
+    parallel.emplace_back(p + n * factory.uniform(-1, 1) + factory.in_box({0, 0, 0}, 3), d);
+  }
+  expect_agreement(compare(plane, reference, parallel, 1e-4), 1e-4, "plane near-parallel");
+}
+
+TEST(Differential_Cylinder, AgreesWithReference) {
+  const glm::vec3 base {0.2f, -0.6f, 0.1f};
+  constexpr float r {0.7f};
+  constexpr float h {1.8f};
+  const Objects::Cylinder cylinder(base, r, h, RGB(255, 0, 255), 500, 0.0f, {1.0f, 2.0f, 0.5f});
+  const glm::vec3 a {cylinder.get_axis()};
+  const auto reference = [&](const V& O, const V& D) { return ref_cylinder(to_v(base), to_v(a), r, h, O, D); };
+  const glm::vec3 middle {base + a * (0.5f * h)};
+  const std::size_t n {ray_budget()};
+  RayFactory factory(3);
+
+  expect_agreement(compare(cylinder, reference, factory.random(n, middle, h), 1e-4), 1e-4, "cylinder random");
+  expect_agreement(compare(cylinder, reference, factory.from_inside(n, middle, 0.6f * r), 1e-4), 1e-4, "cylinder inside");
+
+  // Parallel to the axis: inside the radius they hit a cap, outside they miss
+  std::vector<Ray> parallel;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 offset {factory.perpendicular(a) * factory.uniform(0, 2 * r)};
+    parallel.emplace_back(base + offset - a * factory.uniform(1, 5), i % 2 ? a : -a);
+  }
+  expect_agreement(compare(cylinder, reference, parallel, 1e-4), 1e-4, "cylinder axis-parallel");
+
+  // Aimed at the cap rims
+  std::vector<Ray> rims;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 rim {base + a * (i % 2 ? h : 0.0f) + factory.perpendicular(a) * (r * (1.0f + factory.uniform(-1e-2f, 1e-2f)))};
+    const glm::vec3 origin {factory.in_box(middle, 3 * h)};
+    rims.emplace_back(origin, rim - origin);
+  }
+  expect_agreement(compare(cylinder, reference, rims, 1e-4), 1e-3, "cylinder rims");
+}
+
+TEST(Differential_Cone, AgreesWithReference) {
+  const glm::vec3 apex {-0.3f, 0.8f, 0.2f};
+  constexpr float half_angle {0.45f};
+  constexpr float h {1.5f};
+  const Objects::Cone cone(apex, {0.4f, -1.0f, 0.3f}, half_angle, h, RGB(255, 128, 0), 200, 0.0f);
+  const glm::vec3 a {cone.get_axis()};
+  const double k {std::tan(static_cast<double>(half_angle))};
+  const auto reference = [&](const V& O, const V& D) { return ref_cone(to_v(apex), to_v(a), k, h, O, D); };
+  const glm::vec3 middle {apex + a * (0.6f * h)};
+  const std::size_t n {ray_budget()};
+  RayFactory factory(7);
+
+  expect_agreement(compare(cone, reference, factory.random(n, middle, h), 1e-4), 1e-4, "cone random");
+  expect_agreement(compare(cone, reference, factory.from_inside(n, middle, 0.3f * cone.get_base_radius()), 1e-4), 1e-4, "cone inside");
+
+  // Through the apex region from every side: the second nappe must never be hit
+  std::vector<Ray> apex_rays;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 origin {factory.in_box(apex, 3 * h)};
+    apex_rays.emplace_back(origin, apex + factory.in_box({0, 0, 0}, 0.2f) - origin);
+  }
+  expect_agreement(compare(cone, reference, apex_rays, 1e-4), 1e-3, "cone apex");
+
+  // Aimed at the base rim
+  std::vector<Ray> rims;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 rim {apex + a * h + factory.perpendicular(a) * (cone.get_base_radius() * (1.0f + factory.uniform(-1e-2f, 1e-2f)))};
+    const glm::vec3 origin {factory.in_box(middle, 3 * h)};
+    rims.emplace_back(origin, rim - origin);
+  }
+  expect_agreement(compare(cone, reference, rims, 1e-4), 1e-3, "cone rim");
+}
+
+TEST(Differential_Ellipsoid, AgreesWithReference) {
+  const glm::vec3 c {0.5f, -0.2f, 0.4f};
+  const glm::vec3 radii {1.6f, 0.4f, 0.9f};
+  const Objects::Ellipsoid ellipsoid(c, radii, RGB(0, 128, 255), 50, 0.0f);
+  const auto reference = [&](const V& O, const V& D) { return ref_ellipsoid(to_v(c), to_v(radii), O, D); };
+  const std::size_t n {ray_budget()};
+  RayFactory factory(8);
+
+  expect_agreement(compare(ellipsoid, reference, factory.random(n, c, 1.6f), 1e-4), 1e-4, "ellipsoid random");
+  expect_agreement(compare(ellipsoid, reference, factory.from_inside(n, c, 0.3f), 1e-4), 1e-4, "ellipsoid inside");
+}
+
+TEST(Differential_Torus, AgreesWithReference) {
+  const glm::vec3 c {0.1f, 0.2f, -0.3f};
+  constexpr float R {1.2f};
+  constexpr float r {0.35f};
+  const Objects::Torus torus(c, R, r, RGB(0, 255, 255), 300, 0.0f, {0.3f, 1.0f, -0.2f});
+  const TorusFrame frame {torus_frame(torus, to_v(c), R, r)};
+  const glm::vec3 w {torus.get_axis()};
+  const auto reference = [&](const V& O, const V& D) { return ref_torus(frame, O, D); };
+  const std::size_t n {ray_budget()};
+  RayFactory factory(4);
+
+  expect_agreement(compare(torus, reference, factory.random(n, c, R + r), 1e-4), 1e-4, "torus random");
+
+  // Inside the tube
+  std::vector<Ray> inside;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 ring {c + factory.perpendicular(w) * R};
+    inside.emplace_back(ring + factory.unit() * factory.uniform(0, 0.9f * r), factory.unit());
+  }
+  expect_agreement(compare(torus, reference, inside, 1e-4), 1e-4, "torus inside tube");
+
+  // Through the hole along the axis (all miss) and in the ring plane (hit the tube twice per side)
+  std::vector<Ray> axial;
+  for (std::size_t i {0}; i < n; ++i) {
+    if (i % 2) {
+      const glm::vec3 offset {factory.perpendicular(w) * factory.uniform(0, 0.8f * (R - r))};
+      axial.emplace_back(c + offset - w * factory.uniform(2, 6), w);
+    } else {
+      const glm::vec3 d {factory.perpendicular(w)};
+      axial.emplace_back(c - d * factory.uniform(2, 6) + w * factory.uniform(-0.5f * r, 0.5f * r), d);
+    }
+  }
+  expect_agreement(compare(torus, reference, axial, 1e-4), 1e-4, "torus axis and ring plane");
+
+  // Grazing the outer equator, in the ring plane (a biquadratic quartic)
+  std::vector<Ray> grazing;
+  for (std::size_t i {0}; i < n; ++i) {
+    const glm::vec3 radial {factory.perpendicular(w)};
+    const glm::vec3 tangent {glm::cross(w, radial)};
+    const glm::vec3 point {c + radial * ((R + r) * (1.0f + factory.uniform(-2e-2f, 2e-2f)))};
+    grazing.emplace_back(point - tangent * factory.uniform(2, 6), tangent);
+  }
+  expect_agreement(compare(torus, reference, grazing, 1e-4), 1e-4, "torus grazing");
+}
+
+// ---------------------------------
+// Quartic solver
+// ---------------------------------
+
+TEST(Differential_Quartic, RecoversConstructedRoots) {
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> value(-10.0, 10.0);
+  std::uniform_real_distribution<double> imaginary(0.2, 5.0);
+  const std::size_t n {ray_budget()};
+  std::size_t wrong_count {0}, wrong_value {0};
+
+  for (std::size_t i {0}; i < n; ++i) {
+    // 4, 2 or 0 real roots (well separated); the rest as complex pairs
+    const int real_count {static_cast<int>(i % 3) * 2};
+    std::vector<double> roots;
+    while (static_cast<int>(roots.size()) < real_count) {
+      const double x {value(rng)};
+      if (std::ranges::all_of(roots, [&](const double y) { return std::abs(x - y) > 0.1; })) roots.push_back(x);
+    }
+
+    // Expand prod (x - root) * prod (x^2 - 2 a x + a^2 + b^2) into monic coefficients
+    std::vector<double> poly {1.0};
+    const auto multiply = [&](const std::vector<double>& factor) {
+      std::vector<double> out(poly.size() + factor.size() - 1, 0.0);
+      for (std::size_t p {0}; p < poly.size(); ++p)
+        for (std::size_t q {0}; q < factor.size(); ++q) out[p + q] += poly[p] * factor[q];
+      poly = out;
+    };
+    for (const double x : roots) multiply({1.0, -x});
+    for (int k {real_count}; k < 4; k += 2) {
+      const double re {value(rng)}, im {imaginary(rng)};
+      multiply({1.0, -2.0 * re, re * re + im * im});
+    }
+
+    std::vector<double> found;
+    Math::solve_quartic_monic(poly[1], poly[2], poly[3], poly[4], found);
+    std::ranges::sort(roots);
+    if (found.size() != roots.size()) {
+      ++wrong_count;
+      continue;
+    }
+    for (std::size_t k {0}; k < roots.size(); ++k) {
+      if (std::abs(found[k] - roots[k]) > 1e-6 * (1.0 + std::abs(roots[k]))) {
+        ++wrong_value;
+        break;
+      }
+    }
+  }
+  const std::string counts {std::to_string(n) + " polynomials, " + std::to_string(wrong_count) + " wrong root counts, " + std::to_string(wrong_value) + " inaccurate"};
+  record_counts("quartic", counts);
+  EXPECT_LE(wrong_count, n / 1000) << counts;
+  EXPECT_LE(wrong_value, n / 1000) << counts;
+}
+
+// ---------------------------------
+// Per-ISA kernels against scalar
+// ---------------------------------
+
+namespace {
+std::vector<const Kernels::KernelTable*> supported_tables() {
+  std::vector<const Kernels::KernelTable*> tables {&Kernels::sse42_table(), &Kernels::avx2_table(), &Kernels::avx512_table()};
+  std::erase_if(tables, [](const Kernels::KernelTable* t) { return t->level > Cpu::detect_isa_level(); });
+  return tables;
+}
+}  // namespace
+
+TEST(Differential_Kernels, MatchScalarTable) {
+  const Kernels::KernelTable& scalar {Kernels::scalar_table()};
+  std::mt19937 rng(6);
+  std::uniform_real_distribution<float> u(-10.0f, 10.0f);
+
+  // Sphere batch
+  std::vector<float> cx(97), cy(97), cz(97), r2(97);
+  for (std::size_t i {0}; i < cx.size(); ++i) {
+    cx[i] = u(rng); cy[i] = u(rng); cz[i] = u(rng) + 15.0f;
+    r2[i] = std::abs(u(rng)) * 0.3f + 0.01f;
+  }
+  const Kernels::SphereSoA spheres {cx.data(), cy.data(), cz.data(), r2.data(), cx.size()};
+
+  // Quadric batch: capped cylinders and cones, ellipsoids and unclipped hyperboloids
+  constexpr std::size_t QUADRICS {71};
+  std::array<std::vector<float>, Kernels::QuadricSoA::FIELD_COUNT> quadric_fields;
+  for (std::size_t i {0}; i < QUADRICS; ++i) {
+    const glm::vec3 p {u(rng), u(rng), u(rng) + 15.0f};
+    const glm::vec3 axis {glm::normalize(glm::vec3(u(rng), u(rng), u(rng)))};
+    const float extent {std::abs(u(rng)) * 0.2f + 0.2f};
+    std::shared_ptr<Objects::Quadric> quadric;
+    switch (i % 4) {
+      case 0: quadric = std::make_shared<Objects::Cylinder>(p, extent, 2 * extent, RGB(), 0, 0.0f, axis); break;
+      case 1: quadric = std::make_shared<Objects::Cone>(p, axis, 0.5f, 3 * extent, RGB(), 0, 0.0f); break;
+      case 2: quadric = std::make_shared<Objects::Ellipsoid>(p, glm::vec3(extent, 2 * extent, 0.5f * extent), RGB(), 0, 0.0f); break;
+      default: quadric = std::make_shared<Objects::Quadric>(p, glm::mat3(1, 0, 0, 0, -1, 0, 0, 0, 1), glm::vec3(0), -extent * extent);
+    }
+    const Objects::Quadric::Fields& fields {quadric->get_fields()};
+    for (std::size_t k {0}; k < fields.size(); ++k) quadric_fields[k].push_back(fields[k]);
+  }
+  Kernels::QuadricSoA quadrics {};
+  for (std::size_t k {0}; k < quadric_fields.size(); ++k) quadrics.field[k] = quadric_fields[k].data();
+  quadrics.count = QUADRICS;
+
+  // Lights
+  std::vector<float> px {1.0f, -3.0f, 2.0f}, py {4.0f, 2.0f, -1.0f}, pz {-2.0f, 5.0f, 3.0f}, pi {0.3f, 0.2f, 0.1f};
+  std::vector<float> dx {1.0f}, dy {4.0f}, dz {4.0f}, di {0.2f};
+  const Kernels::LightSoA lights {0.2f, px.data(), py.data(), pz.data(), pi.data(), px.size(), dx.data(), dy.data(), dz.data(), di.data(), dx.size()};
+
+  // Seven quantised boxes in a 16 x 16 x 32 parent (one slot unused)
+  Kernels::QuantisedBoxes8 boxes {{-8.0f, -8.0f, 4.0f}, {-4, -4, -3}, 7, {}, {}};
+  std::uniform_int_distribution<int> cell(0, 255);
+  for (int a {0}; a < 3; ++a) {
+    for (int b {0}; b < 8; ++b) {
+      const int lo {cell(rng)}, hi {cell(rng)};
+      boxes.lo[a][b] = static_cast<std::uint8_t>(std::min(lo, hi));
+      boxes.hi[a][b] = static_cast<std::uint8_t>(std::max(lo, hi));
+    }
+  }
+
+  for (const Kernels::KernelTable* table : supported_tables()) {
+    SCOPED_TRACE(Cpu::to_string(table->level));
+    for (int i {0}; i < 20000; ++i) {
+      const float origin[3] {u(rng), u(rng), u(rng)};
+      const glm::vec3 d {glm::normalize(glm::vec3(u(rng), u(rng), u(rng) + 20.0f))};
+      const float direction[3] {d.x, d.y, d.z};
+      float t_scalar {INFINITY}, t_fast {INFINITY};
+      ASSERT_EQ(scalar.nearest_sphere(origin, direction, 1e-4f, INFINITY, spheres, t_scalar),
+                table->nearest_sphere(origin, direction, 1e-4f, INFINITY, spheres, t_fast));
+      ASSERT_EQ(t_scalar, t_fast);
+
+      t_scalar = t_fast = INFINITY;
+      ASSERT_EQ(scalar.nearest_quadric(origin, direction, 1e-4f, INFINITY, quadrics, t_scalar),
+                table->nearest_quadric(origin, direction, 1e-4f, INFINITY, quadrics, t_fast));
+      ASSERT_EQ(t_scalar, t_fast);
+
+      const float inverse_direction[3] {1.0f / d.x, 1.0f / d.y, 1.0f / d.z};
+      float enter_scalar[8], enter_fast[8];
+      const unsigned entered {scalar.enter_boxes8(boxes, origin, inverse_direction, 1e-4f, 40.0f, enter_scalar)};
+      ASSERT_EQ(entered, table->enter_boxes8(boxes, origin, inverse_direction, 1e-4f, 40.0f, enter_fast));
+      for (int b {0}; b < 8; ++b) {
+        if ((entered >> b) & 1u) {
+          ASSERT_EQ(enter_scalar[b], enter_fast[b]);
+        }
+      }
+
+      double roots_scalar[4], roots_fast[4];
+      const double b {u(rng)}, c {u(rng)}, dd {u(rng)}, e {u(rng)};
+      const int count {scalar.solve_quartic_monic(b, c, dd, e, roots_scalar)};
+      ASSERT_EQ(count, table->solve_quartic_monic(b, c, dd, e, roots_fast));
+      for (int k {0}; k < count; ++k) ASSERT_EQ(roots_scalar[k], roots_fast[k]);
+
+      const float N[3] {direction[1], -direction[0], 0.5f};
+      ASSERT_EQ(scalar.compute_lighting(origin, N, direction, i % 500, lights), table->compute_lighting(origin, N, direction, i % 500, lights));
+      ASSERT_EQ(scalar.specular_power(std::abs(direction[0]), i % 500), table->specular_power(std::abs(direction[0]), i % 500));
+    }
+
+    // Batch shading: bit-identical to the per-hit kernel
+    constexpr std::size_t HITS {1000};
+    std::vector<float> hp[3], hn[3], hv[3];
+    for (int k {0}; k < 3; ++k) { hp[k].resize(HITS); hn[k].resize(HITS); hv[k].resize(HITS); }
+    std::vector<int> shininess(HITS);
+    for (std::size_t h {0}; h < HITS; ++h) {
+      for (int k {0}; k < 3; ++k) { hp[k][h] = u(rng); hn[k][h] = u(rng); hv[k][h] = u(rng); }
+      shininess[h] = static_cast<int>(h % 7 == 0 ? -1 : h % 1200);
+    }
+    const Kernels::HitSoA batch {hp[0].data(), hp[1].data(), hp[2].data(), hn[0].data(), hn[1].data(), hn[2].data(),
+                                 hv[0].data(), hv[1].data(), hv[2].data(), shininess.data(), HITS};
+    std::vector<float> shaded(HITS);
+    table->shade_batch(batch, lights, shaded.data());
+    for (std::size_t h {0}; h < HITS; ++h) {
+      const float P[3] {hp[0][h], hp[1][h], hp[2][h]}, N[3] {hn[0][h], hn[1][h], hn[2][h]}, V[3] {hv[0][h], hv[1][h], hv[2][h]};
+      ASSERT_EQ(scalar.compute_lighting(P, N, V, shininess[h], lights), shaded[h]) << "hit " << h;
+    }
+
+    std::vector<int> channels(3 * 4096);
+    for (std::size_t k {0}; k < channels.size(); ++k) channels[k] = static_cast<int>(k % 700) - 200;
+    std::vector<unsigned char> bytes_scalar(4096 * 3), bytes_fast(4096 * 3);
+    scalar.tonemap_rgb8(channels.data(), 4096, bytes_scalar.data());
+    table->tonemap_rgb8(channels.data(), 4096, bytes_fast.data());
+    EXPECT_EQ(bytes_scalar, bytes_fast);
+  }
+}
+
+// Float repeated squaring for the specular term against std::pow in double
+TEST(Differential_Kernels, LightingWithinOneQuantisationStep) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> u(-10.0f, 10.0f);
+  std::vector<float> px {1.0f, -3.0f, 2.0f}, py {4.0f, 2.0f, -1.0f}, pz {-2.0f, 5.0f, 3.0f}, pi {0.3f, 0.2f, 0.1f};
+  const glm::vec3 dir {glm::normalize(glm::vec3(1.0f, 4.0f, 4.0f))};
+  std::vector<float> dx {dir.x}, dy {dir.y}, dz {dir.z}, di {0.2f};
+  const Kernels::LightSoA lights {0.2f, px.data(), py.data(), pz.data(), pi.data(), px.size(), dx.data(), dy.data(), dz.data(), di.data(), dx.size()};
+
+  double worst {0.0};
+  for (int i {0}; i < 200000; ++i) {
+    const float Pf[3] {u(rng), u(rng), u(rng)}, Nf[3] {u(rng), u(rng), u(rng)}, Vf[3] {u(rng), u(rng), u(rng)};
+    const V point {Pf[0], Pf[1], Pf[2]};
+    const V normal {normalize(V{Nf[0], Nf[1], Nf[2]})};
+    const V view {normalize(V{Vf[0], Vf[1], Vf[2]})};
+    const int s {i % 2000};
+
+    double expected {lights.ambient};
+    const auto add = [&](const V& L, const double intensity) {
+      const double n_dot_l {dot(normal, L)};
+      if (n_dot_l > 0) expected += intensity * n_dot_l;
+      if (const double r_dot_v {dot(normal * (2.0 * n_dot_l) - L, view)}; r_dot_v > 0) expected += intensity * std::pow(r_dot_v, s);
+    };
+    for (std::size_t k {0}; k < px.size(); ++k) add(normalize(V{px[k], py[k], pz[k]} - point), pi[k]);
+    add(V{dx[0], dy[0], dz[0]}, di[0]);
+    expected = std::clamp(expected, 0.0, 1.0);
+
+    worst = std::max(worst, std::abs(Kernels::active().compute_lighting(Pf, Nf, Vf, s, lights) - expected));
+  }
+  // Colors are at most 255, so this bounds the error in any 8-bit channel
+  EXPECT_LT(worst * 255.0, 1.0) << "worst intensity error " << worst;
+}
+
+// ---------------------------------
+// Full images across render modes
+// ---------------------------------
+
+namespace {
+RayTracing::Scene mixed_scene() {
+  RayTracing::GeneratorOptions options;
+  options.spheres = 30;
+  options.cylinders = 15;
+  options.tori = 15;
+  options.layout = RayTracing::Layout::Clustered;
+  options.point_lights = 3;
+  options.reflective_fraction = 0.5f;
+  return RayTracing::generate_scene(options);
+}
+
+std::vector<RayTracing::Camera> cameras() {
+  return {RayTracing::Camera{}, RayTracing::Camera::look_at({6, 4, 2}, {0, 0, 12}), RayTracing::Camera::look_at({-3, 8, 30}, {0, 0, 10})};
+}
+
+constexpr int W {160};
+constexpr int H {120};
+
+void expect_same_image(const std::vector<RGB>& expected, const std::vector<RGB>& actual, const std::string& what) {
+  ASSERT_EQ(expected.size(), actual.size()) << what;
+  std::size_t differing {0};
+  for (std::size_t i {0}; i < expected.size(); ++i) {
+    differing += expected[i].r != actual[i].r || expected[i].g != actual[i].g || expected[i].b != actual[i].b;
+  }
+  EXPECT_EQ(differing, 0u) << what << ": " << differing << " pixels differ";
+}
+}  // namespace
+
+TEST(Differential_Render, IsaLevelsProduceIdenticalImages) {
+  const RayTracing::Scene scene {mixed_scene()};
+  ThreadPool pool(2);
+  const Cpu::IsaLevel original {Kernels::active().level};
+
+  for (const RayTracing::Camera& camera : cameras()) {
+    Kernels::select(Cpu::IsaLevel::Scalar);
+    const std::vector<RGB> reference {RayTracing::render(scene, camera, W, H, pool)};
+    for (const Kernels::KernelTable* table : supported_tables()) {
+      Kernels::select(table->level);
+      expect_same_image(reference, RayTracing::render(scene, camera, W, H, pool), Cpu::to_string(table->level));
+    }
+  }
+  Kernels::select(original);
+}
+
+TEST(Differential_Render, CullingDoesNotChangePixels) {
+  const RayTracing::Scene scene {mixed_scene()};
+  for (const RayTracing::Camera& camera : cameras()) {
+    std::vector<RGB> culled(W * H), unculled(W * H);
+    for (const RayTracing::Tile& tile : RayTracing::make_tiles(W, H, 32)) {
+      RayTracing::render_tile(scene, camera, W, H, tile, culled.data());
+      RayTracing::render_tile(scene, scene.get_object_set(), camera, W, H, tile, unculled.data());
+    }
+    expect_same_image(unculled, culled, "culled tiles");
+  }
+}
+
+TEST(Differential_Render, RelightAndStreamingMatchFullRender) {
+  const RayTracing::Scene scene {mixed_scene()};
+  ThreadPool pool(2);
+  for (const RayTracing::Camera& camera : cameras()) {
+    const std::vector<RGB> reference {RayTracing::render(scene, camera, W, H, pool)};
+    expect_same_image(reference, RayTracing::GBuffer::build(scene, camera, W, H, pool).relight(scene, pool), "G-buffer relight");
+
+    std::ostringstream streamed;
+    RayTracing::render_ppm_stream(scene, camera, W, H, pool, streamed, 7, 3);
+    std::vector<unsigned char> bytes(W * H * 3);
+    Kernels::active().tonemap_rgb8(reinterpret_cast<const int*>(reference.data()), reference.size(), bytes.data());
+    const std::string header {"P6\n" + std::to_string(W) + " " + std::to_string(H) + "\n255\n"};
+    EXPECT_EQ(streamed.str(), header + std::string(bytes.begin(), bytes.end())) << "streamed PPM";
+  }
+}
+
+TEST(Differential_Render, ProgressiveLevelsEndAtFullRender) {
+  const RayTracing::Scene scene {mixed_scene()};
+  ThreadPool pool(3);
+  // Odd sizes leave partial cells at the right and bottom edges
+  for (const auto& [width, height] : {std::pair{W, H}, std::pair{W + 3, H - 5}}) {
+    const RayTracing::Camera camera {RayTracing::Camera::look_at({6, 4, 2}, {0, 0, 12})};
+    std::vector<RayTracing::ProgressiveLevel> levels;
+    std::size_t coarse_differing {0};
+    const std::vector<RGB> reference {RayTracing::render(scene, camera, width, height, pool)};
+    const std::vector<RGB> progressive {RayTracing::render_progressive(scene, camera, width, height, pool,
+        [&](const RayTracing::ProgressiveLevel& level, const std::vector<RGB>& framebuffer) {
+          levels.push_back(level);
+          // Traced samples are final from the level that traces them on
+          for (int y {0}; y < height; y += level.stride) {
+            for (int x {0}; x < width; x += level.stride) {
+              const std::size_t i {static_cast<std::size_t>(y) * width + x};
+              coarse_differing += framebuffer[i].r != reference[i].r || framebuffer[i].g != reference[i].g || framebuffer[i].b != reference[i].b;
+            }
+          }
+        })};
+    expect_same_image(reference, progressive, "progressive");
+    EXPECT_EQ(coarse_differing, 0u) << "traced samples differ from render()";
+
+    ASSERT_EQ(levels.size(), std::size(RayTracing::PROGRESSIVE_STRIDES));
+    std::size_t traced {0};
+    for (std::size_t i {0}; i < levels.size(); ++i) {
+      EXPECT_EQ(levels[i].stride, RayTracing::PROGRESSIVE_STRIDES[i]);
+      traced += levels[i].traced;
+    }
+    EXPECT_EQ(traced, static_cast<std::size_t>(width) * height) << "every pixel is traced exactly once";
+  }
+}
+
+TEST(Differential_Render, ReprojectedSequenceStaysClose) {
+  const auto scene {std::make_shared<const RayTracing::Scene>(mixed_scene())};
+  ThreadPool pool(3);
+  const glm::vec3 target {0, 0, 12};
+  const auto camera_at = [&](const int frame) {
+    const float angle {0.004f * static_cast<float>(frame)};
+    return RayTracing::Camera::look_at(target + 14.0f * glm::vec3(-std::sin(angle), 0.2f, -std::cos(angle)), target);
+  };
+
+  RayTracing::TemporalReprojector reprojector(W, H);
+  std::size_t traced {0}, pixels {0};
+  for (int frame {0}; frame < 8; ++frame) {
+    const RayTracing::Camera camera {camera_at(frame)};
+    const std::vector<RGB> reference {RayTracing::render(*scene, camera, W, H, pool)};
+    const std::vector<RGB> reprojected {reprojector.render(scene, camera, pool)};
+    const RayTracing::ReprojectionStats& stats {reprojector.get_last_stats()};
+    ASSERT_EQ(stats.reused + stats.traced(), reference.size());
+    if (frame == 0) {
+      expect_same_image(reference, reprojected, "first frame");
+      EXPECT_EQ(stats.disoccluded, reference.size());
+      continue;
+    }
+    traced += stats.traced();
+    pixels += reference.size();
+
+    double error {0.0};
+    std::size_t off {0};
+    for (std::size_t i {0}; i < reference.size(); ++i) {
+      const int d {std::max({std::abs(reference[i].r - reprojected[i].r), std::abs(reference[i].g - reprojected[i].g), std::abs(reference[i].b - reprojected[i].b)})};
+      error += std::min(d, 255);
+      off += d > 32;
+    }
+    EXPECT_LT(error / static_cast<double>(reference.size()), 2.0) << "frame " << frame;
+    EXPECT_LT(static_cast<double>(off) / static_cast<double>(reference.size()), 0.02) << "frame " << frame;
+  }
+  EXPECT_LT(static_cast<double>(traced) / static_cast<double>(pixels), 0.5) << "most pixels should be reused";
+
+  // Refreshing everything, or a different scene, traces every pixel exactly as render() does
+  RayTracing::TemporalReprojector always(W, H, {1.0f});
+  always.render(scene, camera_at(0), pool);
+  expect_same_image(RayTracing::render(*scene, camera_at(1), W, H, pool), always.render(scene, camera_at(1), pool), "full refresh");
+  auto other {std::make_shared<const RayTracing::Scene>(mixed_scene())};
+  expect_same_image(RayTracing::render(*other, camera_at(2), W, H, pool), reprojector.render(other, camera_at(2), pool), "new scene");
+  EXPECT_EQ(reprojector.get_last_stats().reused, 0u);
+
+  // A scene built after the previous one is freed (often at its address) still starts afresh
+  other.reset();
+  other = std::make_shared<const RayTracing::Scene>(mixed_scene());
+  reprojector.render(other, camera_at(3), pool);
+  EXPECT_EQ(reprojector.get_last_stats().reused, 0u);
+  EXPECT_THROW(RayTracing::TemporalReprojector(W, H, {1.5f}), std::invalid_argument);
+}
+
+TEST(Differential_Render, ReprojectionTracesObjectsEnteringFromTheEdge) {
+  // A near sphere just left of the view slides in over a far wall as the camera moves left
+  const std::vector<std::shared_ptr<Objects::IRenderable>> objects {
+      std::make_shared<Objects::Plane>(RGB(90, 90, 110), -1, 0.0f, glm::vec3(0, 0, -1), glm::vec3(0, 0, 20)),
+      std::make_shared<Objects::Sphere>(RGB(255, 40, 40), -1, 0.0f, glm::vec3(-2.6f, 0, 4), 0.5f)};
+  const std::vector<std::shared_ptr<Objects::Light>> lights {
+      std::make_shared<Objects::AmbientLight>(0.3f), std::make_shared<Objects::PointLight>(0.7f, glm::vec3(-4, 3, 0))};
+  const auto scene {std::make_shared<const RayTracing::Scene>(objects, lights)};
+  ThreadPool pool(2);
+
+  constexpr int STRIP {W / 4};
+  RayTracing::TemporalReprojector reprojector(W, H, {0.0f});
+  std::size_t reused {0};
+  for (int frame {0}; frame < 6; ++frame) {
+    RayTracing::Camera camera;
+    camera.position = {-0.15f * static_cast<float>(frame), 0, 0};
+    const std::vector<RGB> reference {RayTracing::render(*scene, camera, W, H, pool)};
+    const std::vector<RGB> reprojected {reprojector.render(scene, camera, pool)};
+    reused += reprojector.get_last_stats().reused;
+
+    std::size_t off {0};
+    for (int y {0}; y < H; ++y) {
+      for (int x {0}; x < STRIP; ++x) {
+        const std::size_t i {static_cast<std::size_t>(y * W + x)};
+        off += std::max({std::abs(reference[i].r - reprojected[i].r), std::abs(reference[i].g - reprojected[i].g), std::abs(reference[i].b - reprojected[i].b)}) > 32;
+      }
+    }
+    EXPECT_EQ(off, 0u) << "frame " << frame << ": stale pixels where the sphere entered";
+  }
+  EXPECT_GT(reused, 0u) << "the wall should still be reused";
+}
+
+TEST(Differential_Render, SampledImagesIndependentOfThreadsAndTiles) {
+  const RayTracing::Scene generated {mixed_scene()};
+  std::vector<std::shared_ptr<Objects::Light>> lights {generated.get_lights()};
+  lights.push_back(std::make_shared<Objects::AreaLight>(0.5f, glm::vec3(-2, 8, 6), glm::vec3(4, 0, 0), glm::vec3(0, 0, 4)));
+  for (const auto& object : generated.get_objects()) {
+    if (object->get_reflectivity() > 0.0f) object->set_glossiness(0.3f);
+  }
+  RayTracing::Scene scene {generated.get_objects(), lights};
+  scene.set_sampling({5, 4, 8, 2.0f});
+  ASSERT_TRUE(scene.needs_sampling());
+
+  ThreadPool one(1), three(3);
+  for (const RayTracing::Camera& camera : cameras()) {
+    const std::vector<RGB> reference {RayTracing::render(scene, camera, W, H, one, 32)};
+    expect_same_image(reference, RayTracing::render(scene, camera, W, H, three, 7), "3 threads, 7-pixel tiles");
+
+    scene.set_sampling({6, 4, 8, 2.0f});
+    std::size_t differing {0};
+    const std::vector<RGB> reseeded {RayTracing::render(scene, camera, W, H, three)};
+    for (std::size_t i {0}; i < reference.size(); ++i) differing += reference[i].r != reseeded[i].r;
+    EXPECT_GT(differing, 0u) << "another seed should move the noise";
+    scene.set_sampling({5, 4, 8, 2.0f});
+  }
+}
+
+// ---------------------------------
+// Bounding volume hierarchy
+// ---------------------------------
+
+namespace {
+RayTracing::Scene dense_scene(ThreadPool* pool) {
+  RayTracing::GeneratorOptions options;
+  options.spheres = 400;
+  options.cylinders = 120;
+  options.tori = 40;
+  options.layout = RayTracing::Layout::Clustered;
+  return RayTracing::generate_scene(options, pool);
+}
+
+bool same_nodes(const Memory::ArenaVector<RayTracing::BvhNode>& a, const Memory::ArenaVector<RayTracing::BvhNode>& b) {
+  if (a.size() != b.size()) return false;
+  for (std::size_t i {0}; i < a.size(); ++i) {
+    if (a[i].box.min != b[i].box.min || a[i].box.max != b[i].box.max || a[i].first != b[i].first || a[i].count != b[i].count) return false;
+  }
+  return true;
+}
+}  // namespace
+
+TEST(Differential_Hierarchy, SameHitsAsFlatSet) {
+  ThreadPool pool(3);
+  const RayTracing::Scene scene {dense_scene(&pool)};
+  const RayTracing::ObjectSet& hierarchical {scene.get_object_set()};
+  ASSERT_TRUE(hierarchical.has_hierarchy());
+
+  RayTracing::ObjectSet flat;
+  for (const auto& object : scene.get_objects()) flat.add(object);
+  RayTracing::ObjectSet unrefined;
+  unrefined.build(scene.get_objects(), &pool, {64, 0});
+  ASSERT_TRUE(unrefined.has_hierarchy());
+  RayTracing::ObjectSet wide;
+  wide.build(scene.get_objects(), &pool, {64, 10, RayTracing::BvhFormat::Wide});
+  ASSERT_FALSE(wide.get_wide_hierarchy().empty());
+
+  std::mt19937 rng(46);
+  std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+  const std::size_t rays {ray_budget() / 10};
+  std::size_t hits {0};
+  for (std::size_t i {0}; i < rays; ++i) {
+    // From the camera, and from inside the volume in any direction
+    const glm::vec3 origin {i % 2 == 0 ? glm::vec3(0.0f) : glm::vec3(4 * u(rng), 4 * u(rng), 12 + 4 * u(rng))};
+    const glm::vec3 direction {i % 2 == 0 ? glm::vec3(u(rng), u(rng), 1.0f) : glm::vec3(u(rng), u(rng), u(rng))};
+    const Ray ray(origin, glm::normalize(direction));
+
+    float expected_t, t;
+    std::shared_ptr<Objects::IRenderable> expected, object;
+    RayTracing::closest_interaction(ray, 1e-3f, INFINITY, flat, expected_t, expected);
+    for (const RayTracing::ObjectSet* set : std::array<const RayTracing::ObjectSet*, 3>{&hierarchical, &unrefined, &wide}) {
+      RayTracing::closest_interaction(ray, 1e-3f, INFINITY, *set, t, object);
+      ASSERT_EQ(object, expected) << "ray " << i;
+      if (expected) {
+        ASSERT_EQ(t, expected_t) << "ray " << i;
+      }
+    }
+    hits += expected != nullptr;
+  }
+  EXPECT_GT(hits, rays / 4);
+}
+
+TEST(Differential_Hierarchy, BuildIndependentOfThreads) {
+  const RayTracing::Scene serial {dense_scene(nullptr)};
+  ThreadPool pool(3);
+  const RayTracing::Scene parallel {dense_scene(&pool)};
+  EXPECT_TRUE(same_nodes(serial.get_object_set().get_hierarchy(), parallel.get_object_set().get_hierarchy()));
+  EXPECT_EQ(serial.get_build_stats().nodes, parallel.get_build_stats().nodes);
+  expect_same_image(RayTracing::render(serial, RayTracing::Camera{}, W, H, pool), RayTracing::render(parallel, RayTracing::Camera{}, W, H, pool),
+                    "serial and parallel builds");
+}
+
+TEST(Differential_Hierarchy, PooledParseMatchesSerialParse) {
+  RayTracing::GeneratorOptions options;
+  options.spheres = 3000;
+  options.cylinders = 500;
+  options.tori = 200;
+  options.layout = RayTracing::Layout::Clustered;
+  std::ostringstream text;
+  RayTracing::write_generated_scene(text, options);
+  text << "define ring torus 200 100 50 10 0.2  0 1 0  0 0 0  1 0.2\ninstance ring translate 0 0 8 rotate 1 0 0 30\n";
+
+  ThreadPool pool(3);
+  std::istringstream serial_in(text.str()), pooled_in(text.str());
+  const RayTracing::Scene serial {RayTracing::parse_scene(serial_in)};
+  const RayTracing::Scene pooled {RayTracing::parse_scene(pooled_in, "<stream>", &pool)};
+  ASSERT_EQ(serial.get_objects().size(), pooled.get_objects().size());
+  expect_same_image(RayTracing::render(serial, RayTracing::Camera{}, W, H, pool), RayTracing::render(pooled, RayTracing::Camera{}, W, H, pool),
+                    "serial and pooled parses");
+
+  // Primitive lines are parsed after the rest, yet the first malformed line in the file is the one reported
+  const auto first_error = [&](const std::string& scene) {
+    std::istringstream in(scene);
+    try {
+      RayTracing::parse_scene(in, "s", &pool);
+    } catch (const std::runtime_error& e) {
+      return std::string(e.what());
+    }
+    return std::string("no error");
+  };
+  std::string lines;
+  for (int i {0}; i < 5000; ++i) lines += "sphere 255 0 0 10 0  0 0 20  1\n";
+  EXPECT_EQ(first_error(lines + "sphere 1 2 3\nbogus\n"), "s:5001: missing or malformed values for 'sphere'");
+  EXPECT_EQ(first_error(lines + "bogus\nsphere 1 2 3\n"), "s:5001: unknown entry 'bogus'");
+  EXPECT_EQ(first_error("sphere 255 0 0 10 0  0 0 20  1 shiny\n" + lines + "bogus\n"), "s:1: unexpected 'shiny' after primitive values");
+}
+
+TEST(Differential_Render, PageBackedScenesAndReplicasMatch) {
+  ThreadPool pool(2);
+  const RayTracing::Camera camera {RayTracing::Camera::look_at({6, 4, 2}, {0, 0, 12})};
+  const std::vector<RGB> reference {RayTracing::render(dense_scene(&pool), camera, W, H, pool)};
+
+  for (const Memory::PagePolicy policy : {Memory::PagePolicy::Default, Memory::PagePolicy::Transparent, Memory::PagePolicy::Explicit}) {
+    Memory::set_page_policy(policy);
+    const RayTracing::Scene scene {dense_scene(&pool)};
+    Memory::PageBuffer<RGB> framebuffer(static_cast<std::size_t>(W) * H);
+    RayTracing::render_into(scene, camera, W, H, pool, framebuffer.span());
+    expect_same_image(reference, std::vector<RGB>(framebuffer.data(), framebuffer.data() + framebuffer.size()), Memory::to_string(policy));
+
+    // A per-node copy traces the same primary rays
+    const RayTracing::ObjectSet replica {scene.get_object_set().replicate(std::make_shared<Memory::Arena>(policy))};
+    std::vector<RGB> replicated(W * H);
+    for (const RayTracing::Tile& tile : RayTracing::make_tiles(W, H, 32)) {
+      RayTracing::render_tile(scene, replica, camera, W, H, tile, replicated.data());
+    }
+    expect_same_image(reference, replicated, std::string("replica, ") + Memory::to_string(policy));
+  }
+  Memory::set_page_policy(Memory::PagePolicy::Default);
+}
+
+// ---------------------------------
+// Material table
+// ---------------------------------
+
+TEST(Differential_Materials, MoreThan16BitsAndReclaimedWithTheirPrimitives) {
+  Objects::MaterialTable& table {Objects::MaterialTable::instance()};
+  const std::size_t before {table.size()};
+  {
+    std::vector<std::shared_ptr<Objects::IRenderable>> spheres;
+    for (int i {0}; i < 70000; ++i) {
+      spheres.push_back(std::make_shared<Objects::Sphere>(RGB(i % 256, i / 256 % 256, 7), 1000 + i, 0.0f, glm::vec3(0, 0, 5), 1.0f));
+    }
+    EXPECT_EQ(table.size(), before + 70000);
+    EXPECT_EQ(spheres.back()->get_specular(), 1000 + 69999);
+
+    // Copies share the entry; a changed material leaves the old one to its other holders
+    Objects::Sphere copy {*std::static_pointer_cast<Objects::Sphere>(spheres.front())};
+    copy.set_specular(3);
+    EXPECT_EQ(spheres.front()->get_specular(), 1000);
+    spheres.front().reset();
+    EXPECT_EQ(table.size(), before + 70000);
+  }
+  EXPECT_EQ(table.size(), before);
+}
+
+// ---------------------------------
+// Thread pool
+// ---------------------------------
+
+TEST(Differential_ThreadPool, ParallelForRethrowsWorkerExceptions) {
+  ThreadPool pool(3);
+  const std::thread::id caller {std::this_thread::get_id()};
+  std::atomic<bool> thrown {false};
+  std::atomic<std::size_t> ran {0};
+
+  // The caller holds its first index until a worker has thrown, so the failure always comes from a worker
+  const auto body = [&](std::size_t) {
+    if (std::this_thread::get_id() != caller) {
+      thrown = true;
+      throw std::runtime_error("worker failure");
+    }
+    while (!thrown) std::this_thread::yield();
+    ++ran;
+  };
+  EXPECT_THROW(pool.parallel_for(1000, body), std::runtime_error);
+  EXPECT_LT(ran.load(), 1000u);
+
+  // The pool is still usable afterwards
+  std::atomic<std::size_t> sum {0};
+  pool.parallel_for(100, [&](std::size_t i) { sum += i; });
+  EXPECT_EQ(sum.load(), 4950u);
+}
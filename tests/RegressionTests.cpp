@@ -0,0 +1,315 @@
+// End-to-end regression suite: renders a fixed set of reference scenes and
+// compares them with golden images (perceptually, in CIELAB) and their
+// throughput with a checked-in per-scene baseline.
+//
+// Throughput is normalised by a fixed scalar calibration loop timed on the
+// same host, so one baseline holds across machines of different speeds; a
+// scene fails when its normalised rate drops more than the margin below the
+// baseline. Timing runs single-threaded, in optimised builds only.
+//
+// Environment:
+//   RT_UPDATE_GOLDEN=1              rewrite golden images and baselines from this build instead of comparing
+//   RT_GOLDEN_MEAN_DELTA_E=<x>      largest mean CIE76 colour difference (default 0.5)
+//   RT_GOLDEN_OUTLIER_FRACTION=<x>  largest share of pixels differing visibly, delta E > 2.3 (default 0.005)
+//   RT_THROUGHPUT_MARGIN=<x>        allowed throughput drop below the baseline (default 0.25, i.e. 25%)
+//   RT_THROUGHPUT_REPEAT=<n>        renders per timing, best one counts (default 3)
+//   RT_SKIP_THROUGHPUT=1            compare images only (e.g. on heavily shared hosts)
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RayTracing/DefaultScene.hpp"
+#include "RayTracing/RayTracing.hpp"
+#include "RayTracing/Renderer.hpp"
+#include "RayTracing/SceneGenerator.hpp"
+#include "RayTracing/SceneLoader.hpp"
+#include "Utilities/Kernels.hpp"
+#include "Utilities/ThreadPool.hpp"
+
+namespace {
+
+const std::filesystem::path DATA_DIR {RT_REGRESSION_DIR};
+const std::filesystem::path OUTPUT_DIR {RT_REGRESSION_OUTPUT_DIR};
+
+constexpr double VISIBLE_DELTA_E {2.3};    // just-noticeable difference in CIELAB
+
+double env_number(const char* name, const double fallback) {
+  const char* value {std::getenv(name)};
+  return value != nullptr ? std::stod(value) : fallback;
+}
+
+bool env_flag(const char* name) {
+  const char* value {std::getenv(name)};
+  return value != nullptr && std::string(value) != "0";
+}
+
+// ---------------------------
+// Reference scenes
+// ---------------------------
+
+struct ReferenceScene {
+  std::string name;
+  int width, height;
+  std::function<RayTracing::Scene()> make;
+};
+
+const std::vector<ReferenceScene>& reference_scenes() {
+  static const std::vector<ReferenceScene> scenes {
+      // What RayTracer renders without --scene
+      {"default", 200, 200, [] { return RayTracing::make_default_scene(); }},
+      // Enough objects for the bounding volume hierarchy, with reflections and several lights
+      {"stress", 192, 144, [] {
+         RayTracing::GeneratorOptions options;
+         options.spheres = 300;
+         options.cylinders = 80;
+         options.tori = 20;
+         options.layout = RayTracing::Layout::Clustered;
+         options.point_lights = 3;
+         options.reflective_fraction = 0.4f;
+         options.materials = 0;    // one per object, as when the golden image was made
+         options.seed = 7;
+         return RayTracing::generate_scene(options);
+       }},
+      // Every primitive kind, instancing and adaptive sampling (area light, glossy mirror)
+      {"showcase", 160, 120, [] { return RayTracing::load_scene((DATA_DIR / "scenes" / "showcase.txt").string()); }},
+  };
+  return scenes;
+}
+
+// Every tile on the calling thread, for timing without scheduler noise
+std::vector<RGB> render_single_threaded(const RayTracing::Scene& scene, const int width, const int height) {
+  std::vector<RGB> framebuffer(static_cast<std::size_t>(width) * height);
+  for (const RayTracing::Tile& tile : RayTracing::make_tiles(width, height, 32)) {
+    RayTracing::render_tile(scene, RayTracing::Camera{}, width, height, tile, framebuffer.data());
+  }
+  return framebuffer;
+}
+
+// ---------------------------
+// Images
+// ---------------------------
+
+std::vector<unsigned char> to_rgb8(const std::vector<RGB>& pixels) {
+  std::vector<unsigned char> bytes(pixels.size() * 3);
+  Kernels::active().tonemap_rgb8(reinterpret_cast<const int*>(pixels.data()), pixels.size(), bytes.data());
+  return bytes;
+}
+
+// Binary PPM as written by save_ppm_binary; empty if missing or of another size
+std::vector<unsigned char> read_ppm(const std::filesystem::path& path, const int width, const int height) {
+  std::ifstream in(path, std::ios::binary);
+  std::string magic;
+  int w {0}, h {0}, max {0};
+  if (!(in >> magic >> w >> h >> max) || magic != "P6" || w != width || h != height || max != 255) return {};
+  in.get();
+  std::vector<unsigned char> bytes(static_cast<std::size_t>(width) * height * 3);
+  if (!in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) return {};
+  return bytes;
+}
+
+struct Lab {
+  double l, a, b;
+};
+
+// sRGB (D65) to CIELAB
+Lab to_lab(const unsigned char* rgb) {
+  const auto linear = [](const unsigned char c) {
+    const double v {c / 255.0};
+    return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+  };
+  const double r {linear(rgb[0])}, g {linear(rgb[1])}, b {linear(rgb[2])};
+  const double x {(0.4124 * r + 0.3576 * g + 0.1805 * b) / 0.95047};
+  const double y {0.2126 * r + 0.7152 * g + 0.0722 * b};
+  const double z {(0.0193 * r + 0.1192 * g + 0.9505 * b) / 1.08883};
+  const auto f = [](const double t) { return t > 216.0 / 24389.0 ? std::cbrt(t) : (24389.0 / 27.0 * t + 16.0) / 116.0; };
+  return {116.0 * f(y) - 16.0, 500.0 * (f(x) - f(y)), 200.0 * (f(y) - f(z))};
+}
+
+struct ImageDifference {
+  double mean_delta_e {0.0};
+  double worst_delta_e {0.0};
+  std::size_t visible {0};    // pixels with delta E above VISIBLE_DELTA_E
+};
+
+ImageDifference compare(const std::vector<unsigned char>& expected, const std::vector<unsigned char>& actual) {
+  ImageDifference difference;
+  const std::size_t pixels {expected.size() / 3};
+  for (std::size_t i {0}; i < pixels; ++i) {
+    const Lab e {to_lab(&expected[3 * i])};
+    const Lab a {to_lab(&actual[3 * i])};
+    const double delta_e {std::sqrt((e.l - a.l) * (e.l - a.l) + (e.a - a.a) * (e.a - a.a) + (e.b - a.b) * (e.b - a.b))};
+    difference.mean_delta_e += delta_e;
+    difference.worst_delta_e = std::max(difference.worst_delta_e, delta_e);
+    difference.visible += delta_e > VISIBLE_DELTA_E;
+  }
+  difference.mean_delta_e /= static_cast<double>(std::max<std::size_t>(1, pixels));
+  return difference;
+}
+
+// ---------------------------
+// Throughput
+// ---------------------------
+
+/**
+ * Iterations per second of a fixed scalar ray-sphere loop (best of five).
+ * It shares no code with the renderer, so it measures the host, not the
+ * change under test.
+ */
+double calibration_rate() {
+  constexpr int SPHERES {64};
+  constexpr int RAYS {50000};
+  std::array<float, 4 * SPHERES> spheres {};
+  std::uint32_t seed {12345};
+  const auto next = [&seed] {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+  };
+  for (int i {0}; i < SPHERES; ++i) {
+    spheres[4 * i + 0] = 8.0f * next() - 4.0f;
+    spheres[4 * i + 1] = 8.0f * next() - 4.0f;
+    spheres[4 * i + 2] = 4.0f + 12.0f * next();
+    spheres[4 * i + 3] = 0.1f + next();
+  }
+
+  double best {0.0};
+  for (int round {0}; round < 5; ++round) {
+    const auto start {std::chrono::steady_clock::now()};
+    float sink {0.0f};
+    for (int r {0}; r < RAYS; ++r) {
+      const float dx {next() - 0.5f}, dy {next() - 0.5f};
+      const float inverse_length {1.0f / std::sqrt(dx * dx + dy * dy + 1.0f)};
+      float nearest {std::numeric_limits<float>::infinity()};
+      for (int i {0}; i < SPHERES; ++i) {
+        const float cx {spheres[4 * i]}, cy {spheres[4 * i + 1]}, cz {spheres[4 * i + 2]};
+        const float b {(dx * cx + dy * cy + cz) * inverse_length};
+        const float discriminant {b * b - (cx * cx + cy * cy + cz * cz - spheres[4 * i + 3])};
+        if (discriminant > 0.0f) {
+          const float t {b - std::sqrt(discriminant)};
+          if (t > 0.0f && t < nearest) nearest = t;
+        }
+      }
+      if (nearest < std::numeric_limits<float>::infinity()) sink += nearest;
+    }
+    const double seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+    volatile float keep {sink};
+    (void)keep;
+    best = std::max(best, static_cast<double>(RAYS) * SPHERES / seconds);
+  }
+  return best;
+}
+
+// Primary rays per second of a single-threaded render, best of repeat
+double throughput(const RayTracing::Scene& scene, const int width, const int height, const int repeat) {
+  double best {0.0};
+  for (int r {0}; r < repeat; ++r) {
+    const auto start {std::chrono::steady_clock::now()};
+    render_single_threaded(scene, width, height);
+    const double seconds {std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+    best = std::max(best, static_cast<double>(width) * height / seconds);
+  }
+  return best;
+}
+
+// baseline.txt: "<scene> <primary rays per second / calibration iterations per second>" per line, '#' comments
+std::map<std::string, double> read_baselines() {
+  std::map<std::string, double> baselines;
+  std::ifstream in(DATA_DIR / "baseline.txt");
+  for (std::string line; std::getline(in, line);) {
+    if (const auto hash {line.find('#')}; hash != std::string::npos) line.erase(hash);
+    std::istringstream fields(line);
+    std::string name;
+    double value;
+    if (fields >> name >> value) baselines[name] = value;
+  }
+  return baselines;
+}
+
+bool write_baselines(const std::map<std::string, double>& baselines) {
+  std::ofstream out(DATA_DIR / "baseline.txt");
+  out << "# Normalised throughput per reference scene: single-threaded primary rays per second\n"
+      << "# divided by calibration-loop iterations per second. Regenerate with RT_UPDATE_GOLDEN=1.\n";
+  for (const auto& [name, value] : baselines) out << name << " " << std::setprecision(5) << value << "\n";
+  return static_cast<bool>(out);
+}
+
+class Regression : public testing::TestWithParam<ReferenceScene> {};
+
+}  // namespace
+
+TEST_P(Regression, MatchesGoldenImage) {
+  const ReferenceScene& reference {GetParam()};
+  ThreadPool pool(2);
+  const std::vector<unsigned char> actual {to_rgb8(RayTracing::render(reference.make(), RayTracing::Camera{}, reference.width, reference.height, pool))};
+  const std::filesystem::path golden {DATA_DIR / "golden" / (reference.name + ".ppm")};
+
+  const auto write = [&](const std::filesystem::path& path) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary);
+    out << "P6\n" << reference.width << " " << reference.height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(actual.data()), static_cast<std::streamsize>(actual.size()));
+    return static_cast<bool>(out);
+  };
+  if (env_flag("RT_UPDATE_GOLDEN")) {
+    ASSERT_TRUE(write(golden)) << "cannot write " << golden;
+    GTEST_SKIP() << "wrote " << golden;
+  }
+
+  const std::vector<unsigned char> expected {read_ppm(golden, reference.width, reference.height)};
+  ASSERT_FALSE(expected.empty()) << "no " << reference.width << "x" << reference.height << " golden image at " << golden;
+
+  const ImageDifference difference {compare(expected, actual)};
+  const double outlier_fraction {static_cast<double>(difference.visible) / (static_cast<double>(reference.width) * reference.height)};
+  const bool passed {difference.mean_delta_e <= env_number("RT_GOLDEN_MEAN_DELTA_E", 0.5)
+                     && outlier_fraction <= env_number("RT_GOLDEN_OUTLIER_FRACTION", 0.005)};
+  const std::filesystem::path actual_path {OUTPUT_DIR / (reference.name + ".actual.ppm")};
+  if (!passed) write(actual_path);
+  EXPECT_TRUE(passed) << reference.name << ": mean delta E " << difference.mean_delta_e << ", worst " << difference.worst_delta_e << ", "
+                      << difference.visible << " visibly different pixels (" << 100.0 * outlier_fraction << "%); rendered image saved to " << actual_path;
+}
+
+TEST_P(Regression, ThroughputWithinMargin) {
+#ifndef NDEBUG
+  GTEST_SKIP() << "throughput baselines are for optimised builds";
+#endif
+  if (env_flag("RT_SKIP_THROUGHPUT")) GTEST_SKIP() << "RT_SKIP_THROUGHPUT is set";
+
+  const ReferenceScene& reference {GetParam()};
+  const RayTracing::Scene scene {reference.make()};
+  render_single_threaded(scene, reference.width, reference.height);    // warm caches and page tables
+
+  const int repeat {std::max(1, static_cast<int>(env_number("RT_THROUGHPUT_REPEAT", 3)))};
+  const double rays_per_second {throughput(scene, reference.width, reference.height, repeat)};
+  const double calibration {calibration_rate()};
+  const double normalised {rays_per_second / calibration};
+
+  std::map<std::string, double> baselines {read_baselines()};
+  if (env_flag("RT_UPDATE_GOLDEN")) {
+    baselines[reference.name] = normalised;
+    ASSERT_TRUE(write_baselines(baselines)) << "cannot write " << DATA_DIR / "baseline.txt";
+    GTEST_SKIP() << "recorded " << reference.name << " baseline " << normalised;
+  }
+
+  const auto found {baselines.find(reference.name)};
+  ASSERT_NE(found, baselines.end()) << "no baseline for " << reference.name << " in " << DATA_DIR / "baseline.txt";
+  const double margin {env_number("RT_THROUGHPUT_MARGIN", 0.25)};
+  const double ratio {normalised / found->second};
+  RecordProperty("rays_per_second", std::to_string(rays_per_second));
+  RecordProperty("normalised_ratio", std::to_string(ratio));
+  EXPECT_GE(ratio, 1.0 - margin) << reference.name << ": " << rays_per_second << " rays/s (calibration " << calibration << " it/s) is "
+                                 << 100.0 * (1.0 - ratio) << "% below the baseline; the margin is " << 100.0 * margin << "%";
+}
+
+INSTANTIATE_TEST_SUITE_P(Scenes, Regression, testing::ValuesIn(reference_scenes()),
+                         [](const testing::TestParamInfo<ReferenceScene>& info) { return info.param.name; });